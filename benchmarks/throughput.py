@@ -0,0 +1,207 @@
+#!/usr/bin/env python
+
+'''
+Measures how fast models go through the binding layer: variable creation,
+constraint creation, objective updates, solving, and pulling solution
+values back out.  Each model is built twice at every size, once through
+the per-object API (solver.variable, solver +=, solution.values()) and
+once through the bulk API (variables_array, add_linear_constraints,
+solution.to_array()), so the two can be compared side by side.
+
+Results go to stdout, or to --output, as one JSON record per line::
+
+    {"model": "facility", "size": 40, "path": "bulk", "phase": "constraints",
+     "seconds": 0.0021, "nvars": 8040, "repeat": 0}
+
+The bulk path passes objective coefficients along with the variables, so
+its objective phase is only what minimize spends on them, usually nothing.
+
+Sizes are the number of facilities for facility location, with five
+customers per facility, and the side of the grid for assignment, which
+is the all-different core of sudoku.  Solves stop at --time seconds, so
+large models measure throughput rather than wait for optimality.
+'''
+
+from __future__ import print_function
+from zibopt import scip
+import argparse
+import json
+import random
+import sys
+import time
+
+clock = getattr(time, 'perf_counter', time.time)
+
+def facility_data(size, seed):
+    rng = random.Random(seed)
+    facilities, customers = size, 5 * size
+    demand = [rng.randint(5, 20) for c in range(customers)]
+    capacity = [rng.randint(40, 100) * 5 for f in range(facilities)]
+    fixed = [rng.randint(400, 900) for f in range(facilities)]
+    cost = [[rng.randint(1, 100) for c in range(customers)] for f in range(facilities)]
+    return facilities, customers, demand, capacity, fixed, cost
+
+def assignment_data(size, seed):
+    rng = random.Random(seed)
+    return size, [[rng.randint(1, 100) for j in range(size)] for i in range(size)]
+
+def facility_object(solver, data, timer):
+    facilities, customers, demand, capacity, fixed, cost = data
+
+    with timer('variables'):
+        y = [solver.variable(scip.BINARY) for f in range(facilities)]
+        x = [[solver.variable(upper=1) for c in range(customers)] for f in range(facilities)]
+
+    with timer('constraints'):
+        for c in range(customers):
+            solver += sum(x[f][c] for f in range(facilities)) == 1
+        for f in range(facilities):
+            solver += sum(demand[c] * x[f][c] for c in range(customers)) <= capacity[f] * y[f]
+
+    with timer('objective'):
+        objective = sum(fixed[f] * y[f] for f in range(facilities)) + sum(
+            cost[f][c] * demand[c] * x[f][c] for f in range(facilities) for c in range(customers)
+        )
+    return objective
+
+def facility_bulk(solver, data, timer):
+    facilities, customers, demand, capacity, fixed, cost = data
+
+    with timer('variables'):
+        obj = [cost[f][c] * demand[c] for f in range(facilities) for c in range(customers)]
+        y = solver.variables_array(facilities, scip.BINARY, upper=1, obj=fixed)
+        x = solver.variables_array(facilities * customers, upper=1, obj=obj)
+
+    with timer('constraints'):
+        # Every customer is served in full
+        indptr, indices, data = [0], [], []
+        for c in range(customers):
+            indices.extend(x.start + f * customers + c for f in range(facilities))
+            data.extend([1.0] * facilities)
+            indptr.append(len(indices))
+        solver.add_linear_constraints(indptr, indices, data, lower=1, upper=1)
+
+        # Facilities only serve what they can, and only if they're open
+        indptr, indices, data = [0], [], []
+        for f in range(facilities):
+            indices.extend(x.start + f * customers + c for c in range(customers))
+            data.extend(demand)
+            indices.append(y.start + f)
+            data.append(-capacity[f])
+            indptr.append(len(indices))
+        solver.add_linear_constraints(indptr, indices, data, upper=0)
+
+    # The objective went in with the variables
+    return None
+
+def assignment_object(solver, data, timer):
+    n, cost = data
+
+    with timer('variables'):
+        x = [[solver.variable(scip.BINARY) for j in range(n)] for i in range(n)]
+
+    with timer('constraints'):
+        for i in range(n):
+            solver += sum(x[i][j] for j in range(n)) == 1
+        for j in range(n):
+            solver += sum(x[i][j] for i in range(n)) == 1
+
+    with timer('objective'):
+        return sum(cost[i][j] * x[i][j] for i in range(n) for j in range(n))
+
+def assignment_bulk(solver, data, timer):
+    n, cost = data
+
+    with timer('variables'):
+        x = solver.variables_array(n * n, scip.BINARY, upper=1, obj=[c for row in cost for c in row])
+
+    with timer('constraints'):
+        indptr, indices = [0], []
+        for i in range(n):
+            indices.extend(x.start + i * n + j for j in range(n))
+            indptr.append(len(indices))
+        for j in range(n):
+            indices.extend(x.start + i * n + j for i in range(n))
+            indptr.append(len(indices))
+        solver.add_linear_constraints(indptr, indices, [1.0] * len(indices), lower=1, upper=1)
+
+    return None
+
+MODELS = {
+    'facility':   (facility_data, facility_object, facility_bulk),
+    'assignment': (assignment_data, assignment_object, assignment_bulk),
+}
+
+class timer(object):
+    '''Collects wall times by phase, as in: with timer('solve'): ...'''
+    def __init__(self):
+        self.seconds = {}
+
+    def __call__(self, phase):
+        self.phase = phase
+        return self
+
+    def __enter__(self):
+        self.start = clock()
+
+    def __exit__(self, *exc):
+        self.seconds[self.phase] = self.seconds.get(self.phase, 0.0) + clock() - self.start
+
+def run(model, size, path, seed, time_limit):
+    '''Builds, solves and extracts one model, and returns seconds by phase'''
+    make_data, build_object, build_bulk = MODELS[model]
+    data = make_data(size, seed)
+    t = timer()
+
+    solver = scip.solver()
+    objective = (build_object if path == 'object' else build_bulk)(solver, data, t)
+
+    # Objective coefficients are set inside minimize, which times them
+    with t('solve'):
+        if objective is None:
+            solution = solver.minimize(time=time_limit)
+        else:
+            solution = solver.minimize(objective=objective, time=time_limit)
+    updating = solver.build_times.get('objective', 0.0)
+    t.seconds['objective'] = t.seconds.get('objective', 0.0) + updating
+    t.seconds['solve'] -= updating
+
+    with t('extract'):
+        if path == 'object':
+            solution.values()
+        else:
+            solution.to_array()
+
+    return t.seconds, solver.nvars
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description='binding layer throughput benchmarks')
+    parser.add_argument('--models', default='facility,assignment', help='comma separated models to run')
+    parser.add_argument('--sizes', default='10,20,40', help='comma separated model sizes')
+    parser.add_argument('--paths', default='object,bulk', help='comma separated API paths: object, bulk')
+    parser.add_argument('--repeat', type=int, default=3, help='runs per model, size and path')
+    parser.add_argument('--time', type=float, default=10.0, help='solver time limit in seconds')
+    parser.add_argument('--seed', type=int, default=1, help='seed for generated data')
+    parser.add_argument('--output', default=None, help='file to write records to, or stdout')
+    args = parser.parse_args(argv)
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        for model in args.models.split(','):
+            for size in [int(s) for s in args.sizes.split(',')]:
+                for path in args.paths.split(','):
+                    for r in range(args.repeat):
+                        seconds, nvars = run(model, size, path, args.seed, args.time)
+                        for phase in 'variables', 'constraints', 'objective', 'solve', 'extract':
+                            print(json.dumps({
+                                'model': model, 'size': size, 'path': path, 'phase': phase,
+                                'seconds': seconds.get(phase, 0.0), 'nvars': nvars,
+                                'repeat': r
+                            }, sort_keys=True), file=out)
+                        out.flush()
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+if __name__ == '__main__':
+    main()
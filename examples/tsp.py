@@ -4,7 +4,7 @@ from itertools import product
 from zibopt import scip
 import json, sys
 
-def walk_subtours(arcs, solution):
+def walk_subtours(arcs, value):
     l = len(arcs)
     
     # Unpack arcs into a connections dictionary
@@ -12,13 +12,13 @@ def walk_subtours(arcs, solution):
     for i in range(l):
         # Horizonal row up to node i
         for j in range(i):
-            if solution[arcs[i][j]] > 0.5:
+            if value(arcs[i][j]) > 0.5:
                 connects[i].add(j)
                 connects[j].add(i)
             
         # Vertical column below node i
         for j in range(i+1,l):
-            if solution[arcs[j][i]] > 0.5:
+            if value(arcs[j][i]) > 0.5:
                 connects[i].add(j)
                 connects[j].add(i)
         
@@ -77,39 +77,34 @@ if __name__ == '__main__':
 
     # Our formulation thus far only represents a combinatorial relaxation of
     # STSP as an assignment problem.  It is possible the solver will return
-    # disconnected subtours.
-    n = 0
-    while True:
-        solution = solver.minimize()
+    # disconnected subtours.  Those are cut off as the search finds them.
+    def eliminate_subtours(values, integral):
+        subtours = walk_subtours(arcs, lambda v: values[v.index])
+        if len(subtours) < 2:
+            return None
 
-        if solution:
-            subtours = walk_subtours(arcs, solution)
-            print('-' * 80)
-            print('[%d] LENGTH:' % n, solution.objective, '/ SUBTOURS:', len(subtours))
-            for s in subtours:
-                print('   ', s)
- 
-            n += 1
-            if len(subtours) > 1:
-                solver.restart()
-                
-                # Generate subtour elimination constraints.  These function by
-                # adding a knapsack constraint setting the sum of the arcs
-                # in each subtour to their cardinality minus one.
-                for subtour in subtours:
-                    # n points in a tour have n arcs, not n-1.  That means we
-                    # have to include the arc going back to the start node.
-                    pairs = list(zip(subtour, subtour[1:]+[subtour[0]]))
-                    solver += sum(
-                        # Column # is the higher of the two
-                        arcs[max(*pair)][min(*pair)] for pair in pairs
-                    ) <= len(pairs) - 1
+        # Generate subtour elimination constraints.  These function by
+        # adding a knapsack constraint setting the sum of the arcs in each
+        # subtour to their cardinality minus one.
+        indptr, indices, upper = [0], [], []
+        for subtour in subtours:
+            # n points in a tour have n arcs, not n-1.  That means we
+            # have to include the arc going back to the start node.
+            pairs = list(zip(subtour, subtour[1:]+[subtour[0]]))
 
-            elif solution.optimal:
-                # Optimal tour found.  Stop.
-                break
+            # Column # is the higher of the two
+            indices.extend(arcs[max(*pair)][min(*pair)].index for pair in pairs)
+            indptr.append(len(indices))
+            upper.append(len(pairs) - 1)
 
-        else:
-            print('infeasible')
-            break
+        return indptr, indices, [1.0] * len(indices), None, upper
 
+    solver.set_lazy(eliminate_subtours)
+    solution = solver.minimize()
+
+    if solution:
+        tour = walk_subtours(arcs, lambda v: solution[v])[0]
+        print('LENGTH:', solution.objective)
+        print('   ', tour)
+    else:
+        print('infeasible')
@@ -27,7 +27,9 @@ setup (
 
     ext_modules  = [
         # Modules to setup and solve optimization problems
+        zibopt_ext('_batch', 'batchmodule.c'),
         zibopt_ext('_cons', 'consmodule.c'),
+        zibopt_ext('_expr', 'exprmodule.c'),
         zibopt_ext('_lp',   'lpmodule.c'),
         zibopt_ext('_scip', 'scipmodule.c'),
         zibopt_ext('_soln', 'solnmodule.c'),
@@ -0,0 +1,485 @@
+#include "python_zibopt.h"
+#include "python_zibopt_buffer.h"
+#include "python_zibopt_error.h"
+#include "python_zibopt_threads.h"
+
+static PyObject *error;
+
+// Many small, independent models are solved by a pool of native threads.
+// Each thread owns one SCIP instance and reuses it for every model it
+// picks up, so plugins are only included once per thread.  Models are
+// read and checked up front while we still hold the GIL.  After that,
+// building, solving and writing out solution values never touch Python.
+
+typedef struct {
+    py_scip_array obj, lower, upper, vartype; // one entry per variable
+    py_scip_array indptr, indices, data;      // constraint matrix, CSR format
+    py_scip_array lhs, rhs;                   // one entry per constraint
+    py_scip_array out;                        // solution values go here
+    Py_ssize_t nvars, nconss;
+    Py_ssize_t maxlen;                        // longest row
+    bool maximize;
+
+    bool done;                                // results from here on
+    SCIP_RETCODE retcode;
+    SCIP_STATUS status;
+    SCIP_Real objective;
+    bool found;                               // out holds a solution
+} py_scip_batch_model;
+
+typedef struct {
+    PyThread_type_lock lock;    // guards next
+    Py_ssize_t next;            // next model to hand out
+    py_scip_batch_model *models;
+    Py_ssize_t nmodels;
+    Py_ssize_t maxvars, maxlen; // sizes for worker scratch space
+    double time, gap, absgap;   // limits for every model
+} py_scip_batch;
+
+typedef struct {
+    py_scip_batch *batch;
+    SCIP *scip;                 // reused for every model
+    SCIP_VAR **vars;            // variables of the current model
+    SCIP_VAR **row_vars;        // scratch space for a single row
+    SCIP_Real *row_coef;
+    SCIP_RETCODE retcode;       // set if SCIP can't be created
+    py_scip_thread thread;
+} py_scip_batch_worker;
+
+/*****************************************************************************/
+/* MODEL INPUT                                                               */
+/*****************************************************************************/
+static void _batch_model_release(py_scip_batch_model *m) {
+    PyScipArrayRelease(&m->obj);
+    PyScipArrayRelease(&m->lower);
+    PyScipArrayRelease(&m->upper);
+    PyScipArrayRelease(&m->vartype);
+    PyScipArrayRelease(&m->indptr);
+    PyScipArrayRelease(&m->indices);
+    PyScipArrayRelease(&m->data);
+    PyScipArrayRelease(&m->lhs);
+    PyScipArrayRelease(&m->rhs);
+    PyScipArrayRelease(&m->out);
+}
+
+static int _batch_model_init(py_scip_batch_model *m, PyObject *spec) {
+    // Reads (obj, lower, upper, vartype, indptr, indices, data, lhs, rhs,
+    // maximize, out) and validates all of it.  The matrix may be None.
+    PyObject *obj, *lower, *upper, *vartype, *indptr, *indices, *data, *lhs, *rhs, *out;
+    Py_ssize_t i, k, beg, end, t;
+
+    if (!PyTuple_Check(spec) || !PyArg_ParseTuple(spec, "OOOOOOOOObO", &obj, &lower,
+        &upper, &vartype, &indptr, &indices, &data, &lhs, &rhs, &m->maximize, &out)) {
+        PyErr_Clear();
+        PyErr_SetString(error, "invalid model");
+        return -1;
+    }
+
+    // Variables
+    if (PyScipArrayGet(error, obj, &m->obj, "obj", false, false))
+        return -1;
+    m->nvars = m->obj.size;
+
+    if (PyScipArrayGetReals(error, lower, &m->lower, "lower", m->nvars, -HUGE_VAL) ||
+        PyScipArrayGetReals(error, upper, &m->upper, "upper", m->nvars, HUGE_VAL) ||
+        PyScipArrayGetReals(error, vartype, &m->vartype, "vartype", m->nvars, SCIP_VARTYPE_CONTINUOUS))
+        return -1;
+
+    for (i = 0; i < m->nvars; i++) {
+        if (PyScipArrayReal(&m->upper, i) < PyScipArrayReal(&m->lower, i)) {
+            PyErr_SetString(error, "invalid variable: upper < lower");
+            return -1;
+        }
+        t = (Py_ssize_t) PyScipArrayReal(&m->vartype, i);
+        if (t != SCIP_VARTYPE_BINARY && t != SCIP_VARTYPE_INTEGER &&
+            t != SCIP_VARTYPE_IMPLINT && t != SCIP_VARTYPE_CONTINUOUS) {
+            PyErr_SetString(error, "invalid variable type");
+            return -1;
+        }
+    }
+
+    // Constraints
+    if (indptr != Py_None) {
+        if (PyScipArrayGet(error, indptr, &m->indptr, "indptr", true, false) ||
+            PyScipArrayGet(error, indices, &m->indices, "indices", true, false) ||
+            PyScipArrayGet(error, data, &m->data, "data", false, false))
+            return -1;
+
+        m->nconss = m->indptr.size - 1;
+        if (m->nconss < 0) {
+            PyErr_SetString(error, "indptr must have at least one element");
+            return -1;
+        }
+        if (m->indices.size != m->data.size) {
+            PyErr_SetString(error, "indices and data must be the same length");
+            return -1;
+        }
+    }
+
+    if (PyScipArrayGetReals(error, lhs, &m->lhs, "lhs", m->nconss, -HUGE_VAL) ||
+        PyScipArrayGetReals(error, rhs, &m->rhs, "rhs", m->nconss, HUGE_VAL))
+        return -1;
+
+    for (i = 0; i < m->nconss; i++) {
+        beg = PyScipArrayIndex(&m->indptr, i);
+        end = PyScipArrayIndex(&m->indptr, i+1);
+        if (beg < 0 || end < beg || end > m->indices.size) {
+            PyErr_SetString(error, "indptr must be nondecreasing and within indices");
+            return -1;
+        }
+        if (end - beg > m->maxlen)
+            m->maxlen = end - beg;
+
+        if (PyScipArrayReal(&m->rhs, i) < PyScipArrayReal(&m->lhs, i)) {
+            PyErr_SetString(error, "invalid constraint: rhs < lhs");
+            return -1;
+        }
+    }
+
+    for (k = 0; k < m->indices.size; k++) {
+        i = PyScipArrayIndex(&m->indices, k);
+        if (i < 0 || i >= m->nvars) {
+            PyErr_SetString(error, "variable index out of range");
+            return -1;
+        }
+    }
+
+    // Output values are written straight into the caller's array
+    if (PyScipArrayGet(error, out, &m->out, "out", false, true))
+        return -1;
+    if (PyScipArrayReals(&m->out) == NULL || m->out.size != m->nvars) {
+        PyErr_Format(error, "out must be an array of %zd doubles", m->nvars);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+/* WORKERS                                                                   */
+/*****************************************************************************/
+static SCIP_RETCODE _batch_build(py_scip_batch_worker *w, py_scip_batch_model *m, int *nvars) {
+    // Adds variables and constraints to the worker's empty problem.  The
+    // worker keeps a capture of each variable until the model is done.
+    SCIP *scip = w->scip;
+    SCIP_Real inf = SCIPinfinity(scip);
+    SCIP_Real lb, ub;
+    SCIP_Real *coef = PyScipArrayReals(&m->data);
+    SCIP_VARTYPE t;
+    SCIP_CONS *cons;
+    Py_ssize_t i, k, beg, end;
+
+    for (i = 0; i < m->nvars; i++) {
+        lb = PyScipArrayReal(&m->lower, i);
+        ub = PyScipArrayReal(&m->upper, i);
+        if (lb < -inf) lb = -inf;
+        if (ub > inf)  ub = inf;
+
+        t = (SCIP_VARTYPE) PyScipArrayReal(&m->vartype, i);
+        if (t == SCIP_VARTYPE_BINARY) {
+            if (lb < 0)
+                lb = 0;
+            if (ub > 1)
+                ub = 1;
+        }
+
+        // See variable_init in varsmodule.c for SCIPcreateVar arguments
+        SCIP_CALL( SCIPcreateVar(scip, &w->vars[i], NULL, lb, ub, PyScipArrayReal(&m->obj, i),
+            t, TRUE, FALSE, NULL, NULL, NULL, NULL, NULL) );
+        (*nvars)++;
+        SCIP_CALL( SCIPaddVar(scip, w->vars[i]) );
+    }
+
+    for (i = 0; i < m->nconss; i++) {
+        beg = PyScipArrayIndex(&m->indptr, i);
+        end = PyScipArrayIndex(&m->indptr, i+1);
+        for (k = beg; k < end; k++) {
+            w->row_vars[k-beg] = w->vars[PyScipArrayIndex(&m->indices, k)];
+            if (coef == NULL)
+                w->row_coef[k-beg] = PyScipArrayReal(&m->data, k);
+        }
+
+        lb = PyScipArrayReal(&m->lhs, i);
+        ub = PyScipArrayReal(&m->rhs, i);
+        if (lb < -inf) lb = -inf;
+        if (ub > inf)  ub = inf;
+
+        SCIP_CALL( SCIPcreateConsLinear(scip, &cons, "", (int) (end - beg), w->row_vars,
+            coef == NULL ? w->row_coef : coef + beg,
+            lb, ub, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE) );
+        SCIP_CALL( SCIPaddCons(scip, cons) );
+        SCIP_CALL( SCIPreleaseCons(scip, &cons) );
+    }
+
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE _batch_solve(py_scip_batch_worker *w, py_scip_batch_model *m) {
+    // Builds, solves and reads out one model, then empties the problem
+    // again so the SCIP instance is ready for the next one
+    py_scip_batch *b = w->batch;
+    SCIP *scip = w->scip;
+    SCIP_SOL *sol;
+    SCIP_RETCODE retcode, freecode;
+    int i, nvars = 0;
+
+    // See solver_new in scipmodule.c for SCIPcreateProb arguments
+    SCIP_CALL( SCIPcreateProb(scip, "python-zibopt-batch", NULL, NULL, NULL, NULL, NULL, NULL, NULL) );
+
+    retcode = _batch_build(w, m, &nvars);
+    if (retcode == SCIP_OKAY)
+        retcode = SCIPsetObjsense(scip, m->maximize ? SCIP_OBJSENSE_MAXIMIZE : SCIP_OBJSENSE_MINIMIZE);
+
+    if (retcode == SCIP_OKAY) {
+        SCIPclockReset(scip->stat->solvingtime);
+        scip->set->limit_time   = b->time;
+        scip->set->limit_gap    = b->gap;
+        scip->set->limit_absgap = b->absgap;
+        retcode = SCIPsolve(scip);
+    }
+
+    if (retcode == SCIP_OKAY) {
+        // Same as solution_init in solnmodule.c
+        sol = SCIPgetBestSol(scip);
+        m->status = SCIPgetStatus(scip);
+        m->objective = SCIPgetSolOrigObj(scip, sol);
+        if (sol != NULL && nvars > 0)
+            retcode = SCIPgetSolVals(scip, sol, nvars, w->vars, PyScipArrayReals(&m->out));
+        m->found = sol != NULL && retcode == SCIP_OKAY;
+    }
+
+    for (i = 0; i < nvars; i++)
+        SCIPreleaseVar(scip, &w->vars[i]);
+
+    freecode = SCIPfreeProb(scip);
+    return retcode != SCIP_OKAY ? retcode : freecode;
+}
+
+static void _batch_run(void *arg) {
+    // Thread body.  Never touches Python.
+    py_scip_batch_worker *w = (py_scip_batch_worker *) arg;
+    py_scip_batch *b = w->batch;
+    Py_ssize_t i;
+
+    w->retcode = SCIPcreate(&w->scip);
+    if (w->retcode == SCIP_OKAY)
+        w->retcode = SCIPincludeDefaultPlugins(w->scip);
+    if (w->retcode != SCIP_OKAY)
+        return;
+
+    // Keep SCIP from catching keyboard interrupts.  These go to python.
+    w->scip->set->misc_catchctrlc = FALSE;
+
+    for (;;) {
+        PyThread_acquire_lock(b->lock, WAIT_LOCK);
+        i = b->next++;
+        PyThread_release_lock(b->lock);
+
+        if (i >= b->nmodels)
+            break;
+
+        b->models[i].retcode = _batch_solve(w, &b->models[i]);
+        b->models[i].done = true;
+
+        // A failed model can leave SCIP in any stage.  Don't reuse it.
+        if (b->models[i].retcode != SCIP_OKAY) {
+            w->retcode = b->models[i].retcode;
+            break;
+        }
+    }
+}
+
+static void _batch_worker_free(py_scip_batch_worker *w) {
+    if (w->scip != NULL) SCIPfree(&w->scip);
+    if (w->vars != NULL) free(w->vars);
+    if (w->row_vars != NULL) free(w->row_vars);
+    if (w->row_coef != NULL) free(w->row_coef);
+    PyScipThreadFree(&w->thread);
+}
+
+/*****************************************************************************/
+/* MODULE FUNCTIONS                                                          */
+/*****************************************************************************/
+static PyObject *batch_solve(PyObject *self, PyObject *args, PyObject *kwds) {
+    // Solves a sequence of model tuples and returns a list of (objective,
+    // optimal, infeasible, unbounded, inforunbd, found) tuples
+    static char *argnames[] = {"models", "workers", "time", "gap", "absgap", "quiet", NULL};
+    PyObject *models, *seq, *r;
+    int nworkers = 1;
+    bool quiet   = true;
+
+    py_scip_batch batch;
+    py_scip_batch_worker *workers = NULL;
+    py_scip_batch_model *m;
+    PyObject *result = NULL;
+    SCIP_RETCODE retcode;
+    Py_ssize_t i;
+
+    memset(&batch, 0, sizeof(py_scip_batch));
+    batch.time   = SCIP_DEFAULT_LIMIT_TIME;
+    batch.gap    = SCIP_DEFAULT_LIMIT_GAP;
+    batch.absgap = SCIP_DEFAULT_LIMIT_ABSGAP;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|idddb", argnames, &models, &nworkers,
+        &batch.time, &batch.gap, &batch.absgap, &quiet))
+        return NULL;
+
+    seq = PySequence_Fast(models, "models must be a sequence");
+    if (seq == NULL)
+        return NULL;
+
+    batch.nmodels = PySequence_Fast_GET_SIZE(seq);
+    batch.models = calloc(batch.nmodels > 0 ? batch.nmodels : 1, sizeof(py_scip_batch_model));
+    if (batch.models == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+
+    for (i = 0; i < batch.nmodels; i++) {
+        m = &batch.models[i];
+        if (_batch_model_init(m, PySequence_Fast_GET_ITEM(seq, i)))
+            goto cleanup;
+        if (m->nvars > batch.maxvars)
+            batch.maxvars = m->nvars;
+        if (m->maxlen > batch.maxlen)
+            batch.maxlen = m->maxlen;
+    }
+
+    // Turn on/off solver chatter
+    if (quiet) {
+        retcode = SCIPsetMessagehdlr(NULL);
+    } else {
+        retcode = SCIPsetDefaultMessagehdlr();
+    }
+    if (retcode != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+
+    // More threads than models would only sit idle
+    if (nworkers > batch.nmodels)
+        nworkers = (int) batch.nmodels;
+    if (nworkers < 1)
+        nworkers = 1;
+
+    batch.lock = PyThread_allocate_lock();
+    workers = calloc(nworkers, sizeof(py_scip_batch_worker));
+    if (batch.lock == NULL || workers == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+
+    for (i = 0; i < nworkers; i++) {
+        workers[i].batch = &batch;
+        workers[i].vars = malloc((batch.maxvars > 0 ? batch.maxvars : 1) * sizeof(SCIP_VAR *));
+        workers[i].row_vars = malloc((batch.maxlen > 0 ? batch.maxlen : 1) * sizeof(SCIP_VAR *));
+        workers[i].row_coef = malloc((batch.maxlen > 0 ? batch.maxlen : 1) * sizeof(SCIP_Real));
+        if (workers[i].vars == NULL || workers[i].row_vars == NULL || workers[i].row_coef == NULL) {
+            PyErr_SetString(error, "ran out of memory");
+            goto cleanup;
+        }
+        if (PyScipThreadInit(error, &workers[i].thread))
+            goto cleanup;
+    }
+
+    // Workers that can't get a thread just don't take models.  The others
+    // pick up the slack.
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < nworkers; i++) {
+        if (PyScipThreadStart(&workers[i].thread, _batch_run, &workers[i]))
+            workers[i].retcode = SCIP_ERROR;
+    }
+    for (i = 0; i < nworkers; i++)
+        PyScipThreadJoin(&workers[i].thread);
+    Py_END_ALLOW_THREADS
+
+    // Raise the first model failure.  Models are only left over if every
+    // worker failed, so report a worker failure for those.
+    for (i = 0; i < batch.nmodels; i++) {
+        m = &batch.models[i];
+        if (m->done && m->retcode != SCIP_OKAY) {
+            PyScipSetError(error, m->retcode);
+            goto cleanup;
+        }
+    }
+    for (i = 0; i < batch.nmodels; i++) {
+        if (!batch.models[i].done) {
+            PyScipSetError(error, workers[0].retcode != SCIP_OKAY ? workers[0].retcode : SCIP_ERROR);
+            goto cleanup;
+        }
+    }
+
+    result = PyList_New(batch.nmodels);
+    if (result == NULL)
+        goto cleanup;
+
+    for (i = 0; i < batch.nmodels; i++) {
+        m = &batch.models[i];
+        r = Py_BuildValue("(dNNNNN)", m->objective,
+            PyBool_FromLong(m->status == SCIP_STATUS_OPTIMAL),
+            PyBool_FromLong(m->status == SCIP_STATUS_INFEASIBLE),
+            PyBool_FromLong(m->status == SCIP_STATUS_UNBOUNDED),
+            PyBool_FromLong(m->status == SCIP_STATUS_INFORUNBD),
+            PyBool_FromLong(m->found));
+        if (r == NULL) {
+            Py_CLEAR(result);
+            goto cleanup;
+        }
+        PyList_SET_ITEM(result, i, r);
+    }
+
+cleanup:
+    for (i = 0; workers != NULL && i < nworkers; i++)
+        _batch_worker_free(&workers[i]);
+    if (workers != NULL) free(workers);
+    for (i = 0; batch.models != NULL && i < batch.nmodels; i++)
+        _batch_model_release(&batch.models[i]);
+    if (batch.models != NULL) free(batch.models);
+    if (batch.lock != NULL) PyThread_free_lock(batch.lock);
+    Py_DECREF(seq);
+    return result;
+}
+
+/*****************************************************************************/
+/* MODULE INITIALIZATION                                                     */
+/*****************************************************************************/
+static PyMethodDef batch_methods[] = {
+    {"solve", (PyCFunction) batch_solve, METH_VARARGS | METH_KEYWORDS, "solve many independent models on native threads"},
+    {NULL} /* Sentinel */
+};
+
+#if PY_MAJOR_VERSION >= 3
+static PyModuleDef batch_module = {
+    PyModuleDef_HEAD_INIT,
+    "_batch",
+    "SCIP Batch Solving",
+    -1,
+    batch_methods, NULL, NULL, NULL, NULL
+};
+#endif
+
+#ifndef PyMODINIT_FUNC    /* declarations for DLL import/export */
+#define PyMODINIT_FUNC void
+#endif
+PyMODINIT_FUNC PyInit__batch(void) {
+    PyObject* m;
+
+#if PY_VERSION_HEX < 0x03070000
+    PyEval_InitThreads();
+#endif
+
+#if PY_MAJOR_VERSION >= 3
+    m = PyModule_Create(&batch_module);
+#else
+    m = Py_InitModule3("_batch", batch_methods, "SCIP Batch Solving");
+#endif
+
+    // Initialize exception type
+    error = PyErr_NewException("_batch.error", NULL, NULL);
+    Py_INCREF(error);
+    PyModule_AddObject(m, "error", error);
+
+#if PY_MAJOR_VERSION >= 3
+    return m;
+#endif
+}
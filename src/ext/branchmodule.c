@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -14,14 +15,18 @@ static int branching_rule_init(branching_rule *self, PyObject *args, PyObject *k
     if (!PyArg_ParseTuple(args, "Os", &s, &name))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_XDECREF(self->solver_ref);
+    self->solver_ref = PyWeakref_NewRef(s, NULL);
+    if (self->solver_ref == NULL)
+        return -1;
     
     // Load the branching rule from SCIP
     r = SCIPfindBranchrule(self->scip, name);
@@ -35,18 +40,16 @@ static int branching_rule_init(branching_rule *self, PyObject *args, PyObject *k
 }
 
 static void branching_rule_dealloc(branching_rule *self) {
+    Py_XDECREF(self->solver_ref);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* branching_rule_getattr(branching_rule *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "maxbounddist") == 0)
-            return Py_BuildValue("d", SCIPbranchruleGetMaxbounddist(self->branch));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "maxdepth") == 0)
-            return Py_BuildValue("i", SCIPbranchruleGetMaxdepth(self->branch));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0)
-            return Py_BuildValue("i", SCIPbranchruleGetPriority(self->branch));
+        PY_SCIP_GET("maxbounddist", "d", SCIPbranchruleGetMaxbounddist(self->branch));
+        PY_SCIP_GET("maxdepth", "i", SCIPbranchruleGetMaxdepth(self->branch));
+        PY_SCIP_GET("priority", "i", SCIPbranchruleGetPriority(self->branch));
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -57,6 +60,7 @@ static int branching_rule_setattr(branching_rule *self, PyObject *attr_name, PyO
     
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
+        PY_SCIP_CHECK_SETTINGS_IDLE(error, -1);
         PY_SCIP_SET_DBL_MIN("maxbounddist", self->branch->maxbounddist, -1); 
         PY_SCIP_SET_INT_MIN("maxdepth", self->branch->maxdepth, -1); 
         PY_SCIP_SET_PRIORITY(SCIPbranchruleSetPriority, self->branch);
@@ -144,6 +148,14 @@ PyMODINIT_FUNC PyInit__branch(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&branch_module); 
 #else
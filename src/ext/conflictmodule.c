@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -14,14 +15,18 @@ static int conflict_init(conflict *self, PyObject *args, PyObject *kwds) {
     if (!PyArg_ParseTuple(args, "Os", &s, &name))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_XDECREF(self->solver_ref);
+    self->solver_ref = PyWeakref_NewRef(s, NULL);
+    if (self->solver_ref == NULL)
+        return -1;
     
     // Load the conflict handler from SCIP
     r = SCIPfindConflicthdlr(self->scip, name);
@@ -35,14 +40,14 @@ static int conflict_init(conflict *self, PyObject *args, PyObject *kwds) {
 }
 
 static void conflict_dealloc(conflict *self) {
+    Py_XDECREF(self->solver_ref);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* conflict_getattr(conflict *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "priority")  == 0)
-            return Py_BuildValue("i", SCIPconflicthdlrGetPriority(self->conflict));
+        PY_SCIP_GET("priority", "i", SCIPconflicthdlrGetPriority(self->conflict));
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -50,6 +55,7 @@ static PyObject* conflict_getattr(conflict *self, PyObject *attr_name) {
 static int conflict_setattr(conflict *self, PyObject *attr_name, PyObject *value) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
+        PY_SCIP_CHECK_SETTINGS_IDLE(error, -1);
         PY_SCIP_SET_PRIORITY(SCIPconflicthdlrSetPriority, self->conflict);
     }
     return PyObject_GenericSetAttr((PyObject *) self, attr_name, value);
@@ -135,6 +141,14 @@ PyMODINIT_FUNC PyInit__conflict(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&conflict_module); 
 #else
@@ -1,11 +1,430 @@
 #include "python_zibopt.h"
+#include "python_zibopt_buffer.h"
 #include "python_zibopt_error.h"
+#include "python_zibopt_registry.h"
+#include "python_zibopt_scratch.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
+/*****************************************************************************/
+/* CONSTRAINT CREATION                                                       */
+/*****************************************************************************/
+static SCIP_Real _constraint_coef(PyObject *o) {
+    if (PyLong_Check(o))
+        return PyLong_AsDouble(o);
+    return PyFloat_AsDouble(o);
+}
+
+static int _constraint_create(constraint *self, solver *solv,
+    int nlinear, SCIP_VAR **linvars, SCIP_Real *lincoefs,
+    int nbilin, SCIP_VAR **bilinvars1, SCIP_VAR **bilinvars2, SCIP_Real *bilincoefs,
+    SCIP_Real lhs, SCIP_Real rhs) {
+
+    // If we have bilinear variables, instantiate a quadratic constraint.
+    // Otherwise use the basic linear constraint.
+    if (nbilin > 0) {
+        PY_SCIP_CALL(error, -1,
+            SCIPcreateConsQuadratic(self->scip, &self->constraint, "", 
+                nlinear, linvars, lincoefs, 
+                nbilin, bilinvars1, bilinvars2, bilincoefs,
+                lhs, rhs, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE)
+        );
+
+    } else {
+        PY_SCIP_CALL(error, -1,
+            SCIPcreateConsLinear(self->scip, &self->constraint, "", 
+                nlinear, linvars, lincoefs, 
+                lhs, rhs, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE)
+        );
+    }
+
+    // The registry takes over our capture of the constraint.  It isn't
+    // part of the problem until it is registered, though.
+    self->active = false;
+    self->index = PyScipRegistryAdd(error, &solv->conss, self->constraint, (PyObject *) self);
+    if (self->index < 0) {
+        SCIPreleaseCons(self->scip, &self->constraint);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+/* EXPRESSION COMPILER                                                       */
+/*****************************************************************************/
+// These turn python-algebraic expressions straight into SCIP term arrays.
+// They follow the same steps constraint.__init__ used to take in Python:
+// subtract each bound from the expression and pop off the constant as the
+// bound value.  The terms dict is only copied if a bound has variables.
+
+static PyObject *_constant_key = NULL; // () key for expression constants
+
+static int _expression_subtract(PyObject *side, PyObject **terms, bool *owned,
+    bool *has_constant, PyObject **bound) {
+
+    // Does terms -= side and sets bound to minus the leftover constant
+    PyObject *side_terms, *key, *value, *constant, *old, *diff;
+    Py_ssize_t pos;
+
+    // Constants are only NULL when there isn't one, like terms.pop((), 0.0)
+    constant = *has_constant ? PyDict_GetItem(*terms, _constant_key) : NULL;
+    Py_XINCREF(constant);
+    *has_constant = false;
+
+    // Bounds can be plain numbers or expressions
+    if (PyFloat_Check(side) || PyLong_Check(side)) {
+        side_terms = PyDict_New();
+        if (side_terms == NULL || PyDict_SetItem(side_terms, _constant_key, side) < 0) {
+            Py_XDECREF(side_terms);
+            Py_XDECREF(constant);
+            return -1;
+        }
+    } else {
+        side_terms = PyObject_GetAttrString(side, "terms");
+        if (side_terms == NULL || !PyDict_Check(side_terms)) {
+            Py_XDECREF(side_terms);
+            Py_XDECREF(constant);
+            PyErr_SetString(error, "invalid constraint bound");
+            return -1;
+        }
+    }
+
+    pos = 0;
+    while (PyDict_Next(side_terms, &pos, &key, &value)) {
+        if (PyTuple_Check(key) && PyTuple_GET_SIZE(key) == 0) {
+            diff = constant ? PyNumber_Subtract(constant, value) : PyNumber_Negative(value);
+            Py_XDECREF(constant);
+            constant = diff;
+            if (constant == NULL)
+                break;
+
+        } else {
+            // Copy on write, since the terms belong to the expression
+            if (!*owned) {
+                PyObject *copy = PyDict_Copy(*terms);
+                if (copy == NULL)
+                    break;
+                Py_DECREF(*terms);
+                *terms = copy;
+                *owned = true;
+            }
+
+            old = PyDict_GetItem(*terms, key);
+            diff = old ? PyNumber_Subtract(old, value) : PyNumber_Negative(value);
+            if (diff == NULL || PyDict_SetItem(*terms, key, diff) < 0) {
+                Py_XDECREF(diff);
+                break;
+            }
+            Py_DECREF(diff);
+        }
+    }
+    Py_DECREF(side_terms);
+
+    if (PyErr_Occurred()) {
+        Py_XDECREF(constant);
+        return -1;
+    }
+
+    if (constant == NULL) {
+        *bound = PyFloat_FromDouble(-0.0);
+    } else {
+        *bound = PyNumber_Negative(constant);
+        Py_DECREF(constant);
+    }
+    return *bound == NULL ? -1 : 0;
+}
+
+static PyObject *_expression_bound(PyObject *expr, const char *name) {
+    // Returns a bound attribute (new reference), or NULL if it isn't truthy.
+    // Check PyErr_Occurred to tell the two apart.
+    PyObject *attr = PyObject_GetAttrString(expr, name);
+    if (attr == NULL)
+        return NULL;
+
+    if (PyObject_IsTrue(attr) == 1)
+        return attr;
+
+    Py_DECREF(attr);
+    return NULL;
+}
+
+static int _constraint_compile(constraint *self, solver *solv, PyObject *expr) {
+    PyObject *lower = NULL, *upper = NULL; // expression bounds, if truthy
+    PyObject *middle = NULL;               // expression between two bounds
+    PyObject *inner;                       // bound of a bound
+    PyObject *terms = NULL;                // terms with bounds subtracted out
+    PyObject *key, *value;
+    Py_ssize_t pos, nterms;
+    bool owned = false, has_constant = true;
+    void *scratch;
+    SCIP_VAR **linvars, **bilinvars1, **bilinvars2;
+    SCIP_Real *lincoefs, *bilincoefs;
+    SCIP_Real lhs, rhs;
+    int nlinear = 0, nbilin = 0;
+    int result = -1;
+
+    if (_constant_key == NULL && (_constant_key = PyTuple_New(0)) == NULL)
+        return -1;
+
+    lower = _expression_bound(expr, "expr_lower");
+    upper = _expression_bound(expr, "expr_upper");
+    if (PyErr_Occurred())
+        goto cleanup;
+
+    // Make sure we are in the middle if there are two bounds
+    if (lower == NULL && upper != NULL && (inner = _expression_bound(upper, "expr_upper")) != NULL) {
+        Py_DECREF(inner);
+        middle = upper;
+        upper = NULL;
+    } else if (upper == NULL && lower != NULL && (inner = _expression_bound(lower, "expr_lower")) != NULL) {
+        Py_DECREF(inner);
+        middle = lower;
+        lower = NULL;
+    }
+    if (PyErr_Occurred())
+        goto cleanup;
+
+    if (middle != NULL) {
+        expr = middle;
+        Py_XDECREF(lower);
+        Py_XDECREF(upper);
+        lower = _expression_bound(expr, "expr_lower");
+        upper = _expression_bound(expr, "expr_upper");
+        if (PyErr_Occurred())
+            goto cleanup;
+    }
+
+    terms = PyObject_GetAttrString(expr, "terms");
+    if (terms == NULL || !PyDict_Check(terms)) {
+        PyErr_SetString(error, "invalid constraint expression");
+        goto cleanup;
+    }
+
+    // Cancel out terms from lhs/rhs and keep constants
+    if (lower != NULL && upper == lower) {
+        // Special case where x == y.  This keeps from double-counting
+        // one side of the constraint.
+        if (_expression_subtract(lower, &terms, &owned, &has_constant, &self->lower))
+            goto cleanup;
+        Py_INCREF(self->lower);
+        self->upper = self->lower;
+
+    } else {
+        // Logic for constraints constructed via <= and >=
+        if (lower != NULL && _expression_subtract(lower, &terms, &owned, &has_constant, &self->lower))
+            goto cleanup;
+        if (upper != NULL && _expression_subtract(upper, &terms, &owned, &has_constant, &self->upper))
+            goto cleanup;
+    }
+
+    // Make sure we have at least one bound
+    if (self->lower == NULL && self->upper == NULL) {
+        PyErr_SetString(error, "at least one bound is required");
+        goto cleanup;
+    }
+
+    lhs = self->lower ? PyFloat_AsDouble(self->lower) : -SCIPinfinity(self->scip);
+    rhs = self->upper ? PyFloat_AsDouble(self->upper) : SCIPinfinity(self->scip);
+    if (PyErr_Occurred())
+        goto cleanup;
+
+    if (rhs < lhs) {
+        PyErr_SetString(error, "invalid constraint: expr_upper < expr_lower");
+        goto cleanup;
+    }
+
+    // Any term could be linear or bilinear, so make room for either
+    nterms = PyDict_Size(terms);
+    scratch = PyScipScratchGet(error, &solv->scratch,
+        2 * nterms * sizeof(SCIP_Real) + 3 * nterms * sizeof(SCIP_VAR *));
+    if (scratch == NULL)
+        goto cleanup;
+
+    lincoefs = (SCIP_Real *) scratch;
+    bilincoefs = lincoefs + nterms;
+    linvars = (SCIP_VAR **) (bilincoefs + nterms);
+    bilinvars1 = linvars + nterms;
+    bilinvars2 = bilinvars1 + nterms;
+
+    // Separate out variables by term type (linear/bilinear)
+    pos = 0;
+    while (PyDict_Next(terms, &pos, &key, &value)) {
+        Py_ssize_t i, len;
+
+        // The constant is always popped off as a bound
+        if (!PyTuple_Check(key)) {
+            PyErr_SetString(error, "invalid constraint term");
+            goto cleanup;
+        }
+        len = PyTuple_GET_SIZE(key);
+        if (len == 0)
+            continue;
+
+        // SCIP supports linear terms (3*x) and bilinear (3*x*y + 4*x**2).
+        // Everything else should raise a NotImplementedError.
+        if (len > 2) {
+            PyErr_SetString(PyExc_NotImplementedError, "unsupported term type in constraint");
+            goto cleanup;
+        }
+
+        for (i = 0; i < len; i++) {
+            PyObject *v = PyTuple_GET_ITEM(key, i);
+
+            // Check that each element is a variable
+            if (!PyScipVariable_Check(v)) {
+                PyErr_SetString(error, "invalid variable type");
+                goto cleanup;
+            }
+
+            // Verify that the variable is associated with this solver
+            if (((variable *) v)->scip != self->scip) {
+                PyErr_SetString(error, "variable not associated with solver");
+                goto cleanup;
+            }
+        }
+
+        // Check that each coefficient is numeric
+        if (!(PyLong_Check(value) || PyFloat_Check(value))) {
+            PyErr_SetString(error, "invalid coefficient");
+            goto cleanup;
+        }
+
+        if (len == 1) {
+            linvars[nlinear] = ((variable *) PyTuple_GET_ITEM(key, 0))->variable;
+            lincoefs[nlinear++] = _constraint_coef(value);
+        } else {
+            bilinvars1[nbilin] = ((variable *) PyTuple_GET_ITEM(key, 0))->variable;
+            bilinvars2[nbilin] = ((variable *) PyTuple_GET_ITEM(key, 1))->variable;
+            bilincoefs[nbilin++] = _constraint_coef(value);
+        }
+    }
+
+    if (_constraint_create(self, solv, nlinear, linvars, lincoefs,
+        nbilin, bilinvars1, bilinvars2, bilincoefs, lhs, rhs))
+        goto cleanup;
+
+    // Clear off expression bounds if necessary.  This is so we can
+    // keep reuse variables without mucking things up, since bounds 
+    // are stored on expression (and thus variable) instances.
+    value = PyObject_CallMethod(expr, "_clear_bounds", NULL);
+    if (value == NULL)
+        goto cleanup;
+    Py_DECREF(value);
+
+    result = 0;
+
+cleanup:
+    Py_XDECREF(terms);
+    Py_XDECREF(lower);
+    Py_XDECREF(upper);
+    Py_XDECREF(middle);
+    return result;
+}
+
+// Linear expressions already hold their terms as arrays, so the only work
+// left is looking up variables.  Repeated variables go to SCIP as they are,
+// since the linear constraint handler merges them anyway.
+static int _constraint_linear(constraint *self, solver *solv, linear_expr *expr) {
+    SCIP_VAR **linvars;
+    SCIP_Real lhs, rhs;
+    int i;
+
+    if (expr->solv != solv) {
+        PyErr_SetString(error, "variable not associated with solver");
+        return -1;
+    }
+    if (expr->lower == NULL && expr->upper == NULL) {
+        PyErr_SetString(error, "at least one bound is required");
+        return -1;
+    }
+
+    lhs = expr->lower ? PyFloat_AsDouble(expr->lower) - expr->constant : -SCIPinfinity(self->scip);
+    rhs = expr->upper ? PyFloat_AsDouble(expr->upper) - expr->constant : SCIPinfinity(self->scip);
+    if (PyErr_Occurred())
+        return -1;
+
+    if (rhs < lhs) {
+        PyErr_SetString(error, "invalid constraint: expr_upper < expr_lower");
+        return -1;
+    }
+
+    linvars = (SCIP_VAR **) PyScipScratchGet(error, &solv->scratch, expr->nterms * sizeof(SCIP_VAR *));
+    if (linvars == NULL)
+        return -1;
+    for (i = 0; i < expr->nterms; i++) {
+        if (expr->indices[i] < 0 || expr->indices[i] >= solv->vars.size) {
+            PyErr_SetString(error, "variable index out of range");
+            return -1;
+        }
+        linvars[i] = (SCIP_VAR *) solv->vars.handles[expr->indices[i]];
+    }
+
+    if (expr->lower != NULL && (self->lower = PyFloat_FromDouble(lhs)) == NULL)
+        return -1;
+    if (expr->upper != NULL && (self->upper = PyFloat_FromDouble(rhs)) == NULL)
+        return -1;
+
+    if (_constraint_create(self, solv, expr->nterms, linvars, expr->coefs, 0, NULL, NULL, NULL, lhs, rhs))
+        return -1;
+
+    // As with python-algebraic, the bounds shouldn't outlive the constraint
+    Py_CLEAR(expr->lower);
+    Py_CLEAR(expr->upper);
+    return 0;
+}
+
 /*****************************************************************************/
 /* PYTHON TYPE METHODS                                                       */
 /*****************************************************************************/
+static int _constraint_adopt(constraint *self, constraint_block *block, PyObject *kwds) {
+    // Wraps a row of a constraint block.  Like variables, each row gets at
+    // most one wrapper at a time, which the registry only borrows.
+    PyObject *index_obj;
+    solver *solv = block->solv;
+    SCIP_Real lhs, rhs;
+    long i;
+
+    index_obj = kwds ? PyDict_GetItemString(kwds, "index") : NULL;
+    if (index_obj == NULL || !PyLong_Check(index_obj)) {
+        PyErr_SetString(error, "existing constraints require an integer index");
+        return -1;
+    }
+
+    i = PyLong_AsLong(index_obj);
+    if (solv == NULL || i < 0 || i >= block->nconss) {
+        PyErr_SetString(error, "constraint index out of range");
+        return -1;
+    }
+
+    self->index = block->start + i;
+    if (solv->conss.wrappers[self->index] != NULL) {
+        PyErr_SetString(error, "constraint is already wrapped");
+        return -1;
+    }
+
+    self->scip = solv->scip;
+    self->solv = solv;
+    self->constraint = solv->conss.handles[self->index];
+
+    // Nothing else keeps track of rows without wrappers, so SCIP has to
+    // say whether they're part of the problem
+    self->active = SCIPconsIsInProb(self->constraint);
+    if (!strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(self->constraint)), "linear")) {
+        lhs = SCIPgetLhsLinear(self->scip, self->constraint);
+        rhs = SCIPgetRhsLinear(self->scip, self->constraint);
+        if (!SCIPisInfinity(self->scip, -lhs) && (self->lower = PyFloat_FromDouble(lhs)) == NULL)
+            return -1;
+        if (!SCIPisInfinity(self->scip, rhs) && (self->upper = PyFloat_FromDouble(rhs)) == NULL)
+            return -1;
+    }
+
+    self->flyweight = &solv->conss;
+    PyScipRegistrySetWrapper(&solv->conss, self->index, (PyObject *) self);
+    return 0;
+}
+
 static int constraint_init(constraint *self, PyObject *args, PyObject *kwds) {
     static char *argnames[] = {
         "solver", "linear_vars", "linear_coef", "bilin_var1", "bilin_var2",
@@ -13,27 +432,50 @@ static int constraint_init(constraint *self, PyObject *args, PyObject *kwds) {
     };
     PyObject *s;           // solver Python object
     solver *solv;          // solver C object
+    PyObject *expr;        // python-algebraic expression, if given
     PyObject *linear_vars; // list of linear terms in constraint
     PyObject *linear_coef; // list of their associated coefficients
     PyObject *bilin_var1;  // list of first bilinear terms in constraint
     PyObject *bilin_var2;  // list of second bilinear terms in constraint
     PyObject *bilin_coef;  // list of their associated coefficients
     double lhs, rhs;       // lhs <= f(x) <= rhs
+    void *scratch;         // temporary storage for terms
+    SCIP_VAR **linvars, **bilinvars1, **bilinvars2;
+    SCIP_Real *lincoefs, *bilincoefs;
+    int nlinear, nbilin;   // number of linear and bilinear terms
     int i;
 
+    if (PyTuple_Size(args) == 1 && PyScipConstraintBlock_Check(PyTuple_GET_ITEM(args, 0)))
+        return _constraint_adopt(self, (constraint_block *) PyTuple_GET_ITEM(args, 0), kwds);
+
+    // An expression can be given instead of lists of terms, as in
+    // constraint(solver, x1 + 2*x2 <= 4).  That skips building the lists.
+    expr = NULL;
+    if (PyTuple_Size(args) == 2 && (kwds == NULL || PyDict_Size(kwds) == 0)) {
+        if (!PyArg_ParseTuple(args, "OO", &s, &expr))
+            return -1;
+
     // SCIPinfinity requires self->scip, so we have to parse the args twice
-    if (!PyArg_ParseTuple(args, "OOOOOO|dd", &s, &linear_vars, &linear_coef,
-        &bilin_var1, &bilin_var2, &bilin_coef))
+    } else if (!PyArg_ParseTuple(args, "OOOOOO|dd", &s, &linear_vars, &linear_coef,
+        &bilin_var1, &bilin_var2, &bilin_coef)) {
         return -1;
+    }
 
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
 
     solv = (solver *) s;
+    PY_SCIP_CHECK_IDLE(error, -1, solv);
     self->scip = solv->scip;
+    self->solv = solv;
+
+    if (expr != NULL && PyScipLinearExpr_Check(expr))
+        return _constraint_linear(self, solv, (linear_expr *) expr);
+    if (expr != NULL)
+        return _constraint_compile(self, solv, expr);
         
     lhs = -SCIPinfinity(self->scip);
     rhs = SCIPinfinity(self->scip);
@@ -51,16 +493,16 @@ static int constraint_init(constraint *self, PyObject *args, PyObject *kwds) {
         return -1;
     }
  
-    self->linear_nvars = PyList_Size(linear_vars);
-    if (self->linear_nvars != PyList_Size(linear_coef)) {
+    nlinear = PyList_Size(linear_vars);
+    if (nlinear != PyList_Size(linear_coef)) {
         PyErr_SetString(error, "linear_vars and linear_coef must be the same length");
         return -1;
     }
 
-    for (i = 0; i < self->linear_nvars; i++ ) {
+    for (i = 0; i < nlinear; i++ ) {
         // Check that each element is a variable
         PyObject *v = PyList_GetItem(linear_vars, i);
-        if (strcmp(v->ob_type->tp_name, VARIABLE_TYPE_NAME)) {
+        if (!PyScipVariable_Check(v)) {
             PyErr_SetString(error, "invalid variable type");
             return -1;
         }
@@ -95,18 +537,18 @@ static int constraint_init(constraint *self, PyObject *args, PyObject *kwds) {
         return -1;
     }
  
-    self->bilin_nvars = PyList_Size(bilin_var1);
-    if (self->bilin_nvars != PyList_Size(bilin_var2) || self->bilin_nvars != PyList_Size(bilin_coef)) {
+    nbilin = PyList_Size(bilin_var1);
+    if (nbilin != PyList_Size(bilin_var2) || nbilin != PyList_Size(bilin_coef)) {
         PyErr_SetString(error, "bilin_var1, bilin_var2, and bilin_coef must be the same length");
         return -1;
     }
 
-    for (i = 0; i < self->bilin_nvars; i++ ) {
+    for (i = 0; i < nbilin; i++ ) {
         // Check that each element is a variable
         PyObject *v1 = PyList_GetItem(bilin_var1, i);
         PyObject *v2 = PyList_GetItem(bilin_var2, i);
-        if (strcmp(v1->ob_type->tp_name, VARIABLE_TYPE_NAME) || 
-            strcmp(v2->ob_type->tp_name, VARIABLE_TYPE_NAME)) {
+        if (!PyScipVariable_Check(v1) || 
+            !PyScipVariable_Check(v2)) {
             PyErr_SetString(error, "invalid variable type");
             return -1;
         }
@@ -130,106 +572,156 @@ static int constraint_init(constraint *self, PyObject *args, PyObject *kwds) {
         &linear_vars, &linear_coef, &bilin_var1, &bilin_var2, &bilin_coef, &lhs, &rhs))
         return -1;
 
-    // Store linear variables and coefficients to pass in to the constraint
-    if (self->linear_nvars > 0) {
-        self->linear_vars = malloc(self->linear_nvars * sizeof(SCIP_VAR *));
-        self->linear_coef = malloc(self->linear_nvars * sizeof(SCIP_Real));
-
-        // Add vars and coefficients into these lists
-        for (i = 0; i < self->linear_nvars; i++) {
-            self->linear_vars[i] = ((variable *) PyList_GetItem(linear_vars, i))->variable;
+    // SCIP copies terms into its own memory when it creates a constraint,
+    // so they only need to live in the solver's scratch space until then.
+    // Reals go first so everything stays aligned.
+    scratch = PyScipScratchGet(error, &solv->scratch,
+        (nlinear + nbilin) * sizeof(SCIP_Real) + (nlinear + 2*nbilin) * sizeof(SCIP_VAR *));
+    if (scratch == NULL)
+        return -1;
 
-            PyObject *coefficient_obj = PyList_GetItem(linear_coef, i);
-            SCIP_Real coefficient;
-            if (PyLong_Check(coefficient_obj)) {
-                coefficient = PyLong_AsDouble(coefficient_obj);
-            } else {
-                coefficient = PyFloat_AsDouble(coefficient_obj);
-            }
-            self->linear_coef[i] = coefficient;        
-        }
+    lincoefs = (SCIP_Real *) scratch;
+    bilincoefs = lincoefs + nlinear;
+    linvars = (SCIP_VAR **) (bilincoefs + nbilin);
+    bilinvars1 = linvars + nlinear;
+    bilinvars2 = bilinvars1 + nbilin;
 
-    } else {
-        self->linear_vars = NULL;
-        self->linear_coef = NULL;
+    // Add vars and coefficients into these arrays
+    for (i = 0; i < nlinear; i++) {
+        linvars[i] = ((variable *) PyList_GetItem(linear_vars, i))->variable;
+        lincoefs[i] = _constraint_coef(PyList_GetItem(linear_coef, i));
     }
 
-    // Store bilinear variables and coefficients to pass in to the constraint
-    if (self->bilin_nvars > 0) {
-        self->bilin_var1 = malloc(self->bilin_nvars * sizeof(SCIP_VAR *));
-        self->bilin_var2 = malloc(self->bilin_nvars * sizeof(SCIP_VAR *));
-        self->bilin_coef = malloc(self->bilin_nvars * sizeof(SCIP_Real));
-
-        // Add vars and coefficients into these lists
-        for (i = 0; i < self->bilin_nvars; i++) {
-            self->bilin_var1[i] = ((variable *) PyList_GetItem(bilin_var1, i))->variable;
-            self->bilin_var2[i] = ((variable *) PyList_GetItem(bilin_var2, i))->variable;
-
-            PyObject *coefficient_obj = PyList_GetItem(bilin_coef, i);
-            SCIP_Real coefficient;
-            if (PyLong_Check(coefficient_obj)) {
-                coefficient = PyLong_AsDouble(coefficient_obj);
-            } else {
-                coefficient = PyFloat_AsDouble(coefficient_obj);
-            }
-            self->bilin_coef[i] = coefficient;        
-        }
-
-    } else {
-        self->bilin_var1 = NULL;
-        self->bilin_var2 = NULL;
-        self->bilin_coef = NULL;
-    }
-
-    // If we have bilinear variables, instantiate a quadratic constraint.
-    // Otherwise use the basic linear constraint.
-    if (self->bilin_nvars > 0) {
-        PY_SCIP_CALL(error, -1,
-            SCIPcreateConsQuadratic(self->scip, &self->constraint, "", 
-                self->linear_nvars, self->linear_vars, self->linear_coef, 
-                self->bilin_nvars, self->bilin_var1, self->bilin_var2, self->bilin_coef,
-                lhs, rhs, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE)
-        );
-
-    } else {
-        PY_SCIP_CALL(error, -1,
-            SCIPcreateConsLinear(self->scip, &self->constraint, "", 
-                self->linear_nvars, self->linear_vars, self->linear_coef, 
-                lhs, rhs, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE)
-        );
+    for (i = 0; i < nbilin; i++) {
+        bilinvars1[i] = ((variable *) PyList_GetItem(bilin_var1, i))->variable;
+        bilinvars2[i] = ((variable *) PyList_GetItem(bilin_var2, i))->variable;
+        bilincoefs[i] = _constraint_coef(PyList_GetItem(bilin_coef, i));
     }
-    
 
-    // Put new constraint at head of linked list
-    self->next = (struct constraint *) solv->first_cons;
-    solv->first_cons = self;
+    // Keep bounds around as they were given
+    self->lower = kwds ? PyDict_GetItemString(kwds, "lower") : NULL;
+    self->upper = kwds ? PyDict_GetItemString(kwds, "upper") : NULL;
+    Py_XINCREF(self->lower);
+    Py_XINCREF(self->upper);
 
-    return 0;
+    return _constraint_create(self, solv, nlinear, linvars, lincoefs,
+        nbilin, bilinvars1, bilinvars2, bilincoefs, lhs, rhs);
 }
 
 static void constraint_dealloc(constraint *self) {
-    if (self->linear_vars != NULL) free(self->linear_vars);
-    if (self->linear_coef != NULL) free(self->linear_coef);
-    if (self->bilin_var1 != NULL) free(self->bilin_var1);
-    if (self->bilin_var2 != NULL) free(self->bilin_var2);
-    if (self->bilin_coef != NULL) free(self->bilin_coef);
+    if (self->flyweight != NULL)
+        PyScipRegistryDropWrapper(self->flyweight, self->index, (PyObject *) self);
+    Py_XDECREF(self->lower);
+    Py_XDECREF(self->upper);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject *constraint_register(constraint *self) {
+    PY_SCIP_CHECK_ASSOCIATED(error, NULL, self, "constraint");
+    PY_SCIP_CHECK_IDLE(error, NULL, self->solv);
+    if (self->active)
+        Py_RETURN_NONE;
+
     // In case a constraint is being re-added after optimization,
     // it may be necessary to restart the solver.
     PY_SCIP_CALL(error, NULL, SCIPfreeTransform(self->scip));
     PY_SCIP_CALL(error, NULL, SCIPaddCons(self->scip, self->constraint));
+    self->active = true;
     Py_RETURN_NONE;
 }
 
+static int _constraint_add_term(PyObject *terms, SCIP_Real coef, SCIP_VAR *v1, SCIP_VAR *v2) {
+    // Adds coef to terms[(index of v1, index of v2)], or to terms[(index of
+    // v1,)] if v2 is NULL.  Terms SCIP split up get summed back together.
+    PyObject *key, *old, *value;
+    int result;
+
+    if (coef == 0.0)
+        return 0;
+
+    if (v2 == NULL)
+        key = Py_BuildValue("(i)", SCIPvarGetProbindex(v1));
+    else
+        key = Py_BuildValue("(ii)", SCIPvarGetProbindex(v1), SCIPvarGetProbindex(v2));
+    if (key == NULL)
+        return -1;
+
+    old = PyDict_GetItem(terms, key);
+    if (old != NULL)
+        coef += PyFloat_AsDouble(old);
+
+    value = PyFloat_FromDouble(coef);
+    result = value == NULL ? -1 : PyDict_SetItem(terms, key, value);
+    Py_XDECREF(value);
+    Py_DECREF(key);
+    return result;
+}
+
+static PyObject *constraint_terms(constraint *self) {
+    // Reads coefficients back out of SCIP as a dict keyed on tuples of
+    // variable indices, like {(0,): 1.0, (0, 2): 3.0}.  We don't keep our
+    // own copy of them around.
+    PyObject *terms;
+    SCIP_VAR **vars;
+    SCIP_Real *vals;
+    int i, n;
+
+    PY_SCIP_CHECK_ASSOCIATED(error, NULL, self, "constraint");
+    terms = PyDict_New();
+    if (terms == NULL)
+        return NULL;
+
+    if (!strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(self->constraint)), "linear")) {
+        vars = SCIPgetVarsLinear(self->scip, self->constraint);
+        vals = SCIPgetValsLinear(self->scip, self->constraint);
+        n = SCIPgetNVarsLinear(self->scip, self->constraint);
+        for (i = 0; i < n; i++) {
+            if (_constraint_add_term(terms, vals[i], vars[i], NULL))
+                goto error;
+        }
+
+    } else {
+        // Quadratic constraints keep linear coefficients of variables that
+        // also appear in quadratic terms separately from the others.
+        SCIP_QUADVARTERM *quad = SCIPgetQuadVarTermsQuadratic(self->scip, self->constraint);
+        SCIP_BILINTERM *bilin = SCIPgetBilinTermsQuadratic(self->scip, self->constraint);
+
+        vars = SCIPgetLinearVarsQuadratic(self->scip, self->constraint);
+        vals = SCIPgetCoefsLinearVarsQuadratic(self->scip, self->constraint);
+        n = SCIPgetNLinearVarsQuadratic(self->scip, self->constraint);
+        for (i = 0; i < n; i++) {
+            if (_constraint_add_term(terms, vals[i], vars[i], NULL))
+                goto error;
+        }
+
+        n = SCIPgetNQuadVarTermsQuadratic(self->scip, self->constraint);
+        for (i = 0; i < n; i++) {
+            if (_constraint_add_term(terms, quad[i].lincoef, quad[i].var, NULL) ||
+                _constraint_add_term(terms, quad[i].sqrcoef, quad[i].var, quad[i].var))
+                goto error;
+        }
+
+        n = SCIPgetNBilinTermsQuadratic(self->scip, self->constraint);
+        for (i = 0; i < n; i++) {
+            if (_constraint_add_term(terms, bilin[i].coef, bilin[i].var1, bilin[i].var2))
+                goto error;
+        }
+    }
+
+    return terms;
+
+error:
+    Py_DECREF(terms);
+    return NULL;
+}
+
 static PyObject* constraint_getattr(constraint *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
         if (PyUnicode_CompareWithASCIIString(attr_name, "dual_sol_linear") == 0) {
             // We have to get dual values off of the transformed problem
             SCIP_CONS *transformed;
+            PY_SCIP_CHECK_ASSOCIATED(error, NULL, self, "constraint");
             PY_SCIP_CALL(error, NULL, SCIPgetTransformedCons(self->scip, self->constraint, &transformed));
 
             if (transformed == NULL) {
@@ -246,11 +738,271 @@ static PyObject* constraint_getattr(constraint *self, PyObject *attr_name) {
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
 
+/*****************************************************************************/
+/* CONSTRAINT BLOCKS                                                         */
+/*****************************************************************************/
+static int _constraint_block_adopt(constraint_block *self, PyObject *args, PyObject *kwds) {
+    // Wraps n constraints the solver already has, from index start on,
+    // like those a problem file brings in
+    static char *argnames[] = {"solver", "n", "start", NULL};
+    PyObject *s;
+    solver *solv;
+    int n, start;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oii", argnames, &s, &n, &start))
+        return -1;
+
+    if (!PyScipSolver_Check(s)) {
+        PyErr_SetString(error, "invalid solver type");
+        return -1;
+    }
+
+    solv = (solver *) s;
+    if (n < 0 || start < 0 || start + n > solv->conss.size) {
+        PyErr_SetString(error, "constraint index out of range");
+        return -1;
+    }
+
+    Py_INCREF(solv);
+    Py_XDECREF(self->solv);
+    self->solv = solv;
+    self->scip = solv->scip;
+    self->start = start;
+    self->nconss = n;
+    return 0;
+}
+
+static int constraint_block_init(constraint_block *self, PyObject *args, PyObject *kwds) {
+    static char *argnames[] = {"solver", "indptr", "indices", "data", "lower", "upper", NULL};
+    PyObject *s;                          // solver Python object
+    solver *solv;                         // solver C object
+    PyObject *indptr_obj, *indices_obj, *data_obj;
+    PyObject *lower_obj = NULL, *upper_obj = NULL;
+    py_scip_array indptr, indices, data, lower, upper;
+    SCIP_VAR **vars;                      // variables in the order they were added
+    int nvars;
+    void *scratch;
+    SCIP_VAR **row_vars = NULL;           // scratch space for a single row
+    SCIP_Real *row_coef = NULL;
+    SCIP_Real *coef;                      // coefficients, if usable in place
+    SCIP_Real lhs, rhs, inf;
+    Py_ssize_t nrows, row, k, beg, end, maxlen, j;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    int result = -1;
+
+    if (kwds && PyDict_GetItemString(kwds, "start"))
+        return _constraint_block_adopt(self, args, kwds);
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|OO", argnames, &s,
+        &indptr_obj, &indices_obj, &data_obj, &lower_obj, &upper_obj))
+        return -1;
+
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
+        PyErr_SetString(error, "invalid solver type");
+        return -1;
+    }
+
+    solv = (solver *) s;
+    PY_SCIP_CHECK_IDLE(error, -1, solv);
+    self->scip = solv->scip;
+    inf = SCIPinfinity(self->scip);
+
+    // Row pointers, column indices and coefficients in CSR format
+    if (PyScipArrayGet(error, indptr_obj, &indptr, "indptr", true, false))
+        return -1;
+    if (PyScipArrayGet(error, indices_obj, &indices, "indices", true, false)) {
+        PyScipArrayRelease(&indptr);
+        return -1;
+    }
+    if (PyScipArrayGet(error, data_obj, &data, "data", false, false)) {
+        PyScipArrayRelease(&indptr);
+        PyScipArrayRelease(&indices);
+        return -1;
+    }
+
+    nrows = indptr.size - 1;
+    memset(&lower, 0, sizeof(py_scip_array));
+    memset(&upper, 0, sizeof(py_scip_array));
+
+    if (nrows < 0) {
+        PyErr_SetString(error, "indptr must have at least one element");
+        goto cleanup;
+    }
+
+    if (indices.size != data.size) {
+        PyErr_SetString(error, "indices and data must be the same length");
+        goto cleanup;
+    }
+
+    if (PyScipArrayGetReals(error, lower_obj, &lower, "lower", nrows, -inf) ||
+        PyScipArrayGetReals(error, upper_obj, &upper, "upper", nrows, inf))
+        goto cleanup;
+
+    // Validate everything up front so we never leave half a block behind
+    vars = (SCIP_VAR **) solv->vars.handles;
+    nvars = solv->vars.size;
+
+    maxlen = 0;
+    for (row = 0; row < nrows; row++) {
+        beg = PyScipArrayIndex(&indptr, row);
+        end = PyScipArrayIndex(&indptr, row+1);
+        if (beg < 0 || end < beg || end > indices.size) {
+            PyErr_SetString(error, "indptr must be nondecreasing and within indices");
+            goto cleanup;
+        }
+        if (end - beg > maxlen)
+            maxlen = end - beg;
+
+        lhs = PyScipArrayReal(&lower, row);
+        rhs = PyScipArrayReal(&upper, row);
+        if (rhs < lhs) {
+            PyErr_SetString(error, "invalid constraint: upper < lower");
+            goto cleanup;
+        }
+    }
+
+    for (k = 0; k < indices.size; k++) {
+        j = PyScipArrayIndex(&indices, k);
+        if (j < 0 || j >= nvars) {
+            PyErr_SetString(error, "variable index out of range");
+            goto cleanup;
+        }
+    }
+
+    // In case constraints are being added after optimization, it may be
+    // necessary to restart the solver.  One restart covers the whole block.
+    if ((retcode = SCIPfreeTransform(self->scip)) != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+
+    // Block members occupy a contiguous range of the solver's registry
+    if (PyScipRegistryReserve(error, &solv->conss, nrows))
+        goto cleanup;
+
+    Py_INCREF(solv);
+    Py_XDECREF(self->solv);
+    self->solv = solv;
+    self->start = solv->conss.size;
+
+    // Rows are built in the solver's scratch space, reals first.  If the
+    // coefficients are already doubles SCIP can read them in place.
+    coef = PyScipArrayReals(&data);
+    scratch = PyScipScratchGet(error, &solv->scratch,
+        maxlen * (sizeof(SCIP_VAR *) + (coef == NULL ? sizeof(SCIP_Real) : 0)));
+    if (scratch == NULL)
+        goto cleanup;
+
+    if (coef == NULL) {
+        row_coef = (SCIP_Real *) scratch;
+        row_vars = (SCIP_VAR **) (row_coef + maxlen);
+    } else {
+        row_vars = (SCIP_VAR **) scratch;
+    }
+
+    for (row = 0; row < nrows; row++) {
+        SCIP_CONS *cons;
+
+        beg = PyScipArrayIndex(&indptr, row);
+        end = PyScipArrayIndex(&indptr, row+1);
+        for (k = beg; k < end; k++) {
+            row_vars[k-beg] = vars[PyScipArrayIndex(&indices, k)];
+            if (row_coef != NULL)
+                row_coef[k-beg] = PyScipArrayReal(&data, k);
+        }
+
+        lhs = PyScipArrayReal(&lower, row);
+        rhs = PyScipArrayReal(&upper, row);
+        if (lhs < -inf) lhs = -inf;
+        if (rhs > inf)  rhs = inf;
+
+        retcode = SCIPcreateConsLinear(self->scip, &cons, "",
+            (int) (end - beg), row_vars, row_coef != NULL ? row_coef : coef + beg,
+            lhs, rhs, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE);
+        if (retcode != SCIP_OKAY)
+            break;
+
+        // Room was reserved above, so this can't fail
+        PyScipRegistryAdd(error, &solv->conss, cons, NULL);
+        self->nconss++;
+
+        retcode = SCIPaddCons(self->scip, cons);
+        if (retcode != SCIP_OKAY)
+            break;
+    }
+
+    if (retcode != SCIP_OKAY)
+        PyScipSetError(error, retcode);
+    else
+        result = 0;
+
+cleanup:
+    PyScipArrayRelease(&indptr);
+    PyScipArrayRelease(&indices);
+    PyScipArrayRelease(&data);
+    PyScipArrayRelease(&lower);
+    PyScipArrayRelease(&upper);
+    return result;
+}
+
+static int constraint_block_traverse(constraint_block *self, visitproc visit, void *arg) {
+    Py_VISIT(self->solv);
+    return 0;
+}
+
+static int constraint_block_clear(constraint_block *self) {
+    Py_CLEAR(self->solv);
+    return 0;
+}
+
+static void constraint_block_dealloc(constraint_block *self) {
+    PyObject_GC_UnTrack(self);
+    Py_CLEAR(self->solv);
+    ((PyObject *) self)->ob_type->tp_free(self);
+}
+
+static Py_ssize_t constraint_block_length(constraint_block *self) {
+    return self->nconss;
+}
+
+static PyObject *constraint_block_wrapper(constraint_block *self, PyObject *arg) {
+    // Returns the Python constraint for a block row, or None if it hasn't
+    // been materialized yet
+    PyObject *c;
+    long i;
+
+    if (!PyLong_Check(arg)) {
+        PyErr_SetString(error, "constraint index must be an integer");
+        return NULL;
+    }
+
+    i = PyLong_AsLong(arg);
+    if (i < 0 || i >= self->nconss || self->solv == NULL) {
+        PyErr_SetString(PyExc_IndexError, "constraint index out of range");
+        return NULL;
+    }
+
+    c = self->solv->conss.wrappers[self->start + i];
+    if (c == NULL)
+        Py_RETURN_NONE;
+
+    Py_INCREF(c);
+    return c;
+}
+
 /*****************************************************************************/
 /* MODULE INITIALIZATION                                                     */
 /*****************************************************************************/
+static PyMemberDef constraint_members[] = {
+    {"lower", T_OBJECT, offsetof(constraint, lower), READONLY, "lower bound, or None"},
+    {"upper", T_OBJECT, offsetof(constraint, upper), READONLY, "upper bound, or None"},
+    {NULL} /* Sentinel */
+};
+
 static PyMethodDef constraint_methods[] = {
     {"register", (PyCFunction) constraint_register, METH_NOARGS,  "registers the constraint with the solver"},
+    {"terms", (PyCFunction) constraint_terms, METH_NOARGS,  "returns coefficients keyed on variable indices"},
     {NULL} /* Sentinel */
 };
 
@@ -283,7 +1035,7 @@ static PyTypeObject constraint_type = {
     0,                               /* tp_iter */
     0,                               /* tp_iternext */
     constraint_methods,              /* tp_methods */
-    0,                               /* tp_members */
+    constraint_members,              /* tp_members */
     0,                               /* tp_getset */
     0,                               /* tp_base */
     0,                               /* tp_dict */
@@ -295,6 +1047,56 @@ static PyTypeObject constraint_type = {
     0,                               /* tp_new */
 };
 
+static PyMethodDef constraint_block_methods[] = {
+    {"wrapper", (PyCFunction) constraint_block_wrapper, METH_O, "returns the Python constraint for a block row, if there is one"},
+    {NULL} /* Sentinel */
+};
+
+static PySequenceMethods constraint_block_sequence = {
+    (lenfunc) constraint_block_length, /* sq_length */
+};
+
+static PyTypeObject constraint_block_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_cons.constraint_block",        /* tp_name */
+    sizeof(constraint_block),        /* tp_basicsize */
+    0,                               /* tp_itemsize */
+    (destructor) constraint_block_dealloc, /* tp_dealloc */
+    0,                               /* tp_print */
+    0,                               /* tp_getattr */
+    0,                               /* tp_setattr */
+    0,                               /* tp_compare */
+    0,                               /* tp_repr */
+    0,                               /* tp_as_number */
+    &constraint_block_sequence,      /* tp_as_sequence */
+    0,                               /* tp_as_mapping */
+    0,                               /* tp_hash */
+    0,                               /* tp_call */
+    0,                               /* tp_str */
+    0,                               /* tp_getattro */
+    0,                               /* tp_setattro */
+    0,                               /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC, /* tp_flags */
+    "SCIP linear constraint blocks", /* tp_doc */
+    (traverseproc) constraint_block_traverse, /* tp_traverse */
+    (inquiry) constraint_block_clear, /* tp_clear */
+    0,                               /* tp_richcompare */
+    0,                               /* tp_weaklistoffset */
+    0,                               /* tp_iter */
+    0,                               /* tp_iternext */
+    constraint_block_methods,        /* tp_methods */
+    0,                               /* tp_members */
+    0,                               /* tp_getset */
+    0,                               /* tp_base */
+    0,                               /* tp_dict */
+    0,                               /* tp_descr_get */
+    0,                               /* tp_descr_set */
+    0,                               /* tp_dictoffset */
+    (initproc) constraint_block_init, /* tp_init */
+    0,                               /* tp_alloc */
+    0,                               /* tp_new */
+};
+
 #if PY_MAJOR_VERSION >= 3
 static PyModuleDef cons_module = {
     PyModuleDef_HEAD_INIT,
@@ -319,15 +1121,37 @@ PyMODINIT_FUNC PyInit__cons(void) {
         return;
 #endif
 
+    constraint_block_type.tp_new = PyType_GenericNew;
+    if (PyType_Ready(&constraint_block_type) < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&cons_module); 
 #else
     m = Py_InitModule3("_cons", NULL, "SCIP Constraint");
 #endif
 
+    py_scip_types_table->constraint = &constraint_type;
+    py_scip_types_table->constraint_block = &constraint_block_type;
+
     Py_INCREF(&constraint_type);
     PyModule_AddObject(m, "constraint", (PyObject *) &constraint_type);
 
+    Py_INCREF(&constraint_block_type);
+    PyModule_AddObject(m, "constraint_block", (PyObject *) &constraint_block_type);
+
     // Initialize exception type
     error = PyErr_NewException("_cons.error", NULL, NULL);
     Py_INCREF(error);
@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -14,14 +15,18 @@ static int display_column_init(display_column *self, PyObject *args, PyObject *k
     if (!PyArg_ParseTuple(args, "Os", &s, &name))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_XDECREF(self->solver_ref);
+    self->solver_ref = PyWeakref_NewRef(s, NULL);
+    if (self->solver_ref == NULL)
+        return -1;
     
     // Load the display column from SCIP
     d = SCIPfindDisp(self->scip, name);
@@ -35,18 +40,16 @@ static int display_column_init(display_column *self, PyObject *args, PyObject *k
 }
 
 static void display_column_dealloc(display_column *self) {
+    Py_XDECREF(self->solver_ref);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* display_column_getattr(display_column *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "position") == 0)
-            return Py_BuildValue("i", SCIPdispGetPosition(self->display));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0)
-            return Py_BuildValue("i", SCIPdispGetPriority(self->display));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "width") == 0)
-            return Py_BuildValue("i", SCIPdispGetWidth(self->display));
+        PY_SCIP_GET("position", "i", SCIPdispGetPosition(self->display));
+        PY_SCIP_GET("priority", "i", SCIPdispGetPriority(self->display));
+        PY_SCIP_GET("width", "i", SCIPdispGetWidth(self->display));
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -56,6 +59,7 @@ static int display_column_setattr(display_column *self, PyObject *attr_name, PyO
     
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
+        PY_SCIP_CHECK_SETTINGS_IDLE(error, -1);
          PY_SCIP_SET_INT_MIN("position", self->display->position, -1);
          PY_SCIP_SET_INT_MIN("priority", self->display->priority, -1);
          PY_SCIP_SET_INT_MIN("width", self->display->width, -1);
@@ -143,6 +147,14 @@ PyMODINIT_FUNC PyInit__disp(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&disp_module); 
 #else
@@ -0,0 +1,492 @@
+#include "python_zibopt.h"
+#include "python_zibopt_buffer.h"
+#include "python_zibopt_error.h"
+#include "python_zibopt_types.h"
+
+static PyObject *error;
+
+/*****************************************************************************/
+/* PYTHON TYPE METHODS                                                       */
+/*****************************************************************************/
+static int linear_expr_init(linear_expr *self, PyObject *args, PyObject *kwds) {
+    static char *argnames[] = {"solver", NULL};
+    PyObject *s;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", argnames, &s))
+        return -1;
+
+    if (!PyScipSolver_Check(s)) {
+        PyErr_SetString(error, "invalid solver type");
+        return -1;
+    }
+
+    Py_INCREF(s);
+    Py_XDECREF(self->solv);
+    self->solv = (solver *) s;
+    return 0;
+}
+
+static int linear_expr_traverse(linear_expr *self, visitproc visit, void *arg) {
+    Py_VISIT(self->solv);
+    return 0;
+}
+
+static int linear_expr_clear(linear_expr *self) {
+    Py_CLEAR(self->solv);
+    return 0;
+}
+
+static void linear_expr_dealloc(linear_expr *self) {
+    PyObject_GC_UnTrack(self);
+    Py_CLEAR(self->solv);
+    Py_CLEAR(self->lower);
+    Py_CLEAR(self->upper);
+    if (self->indices != NULL) free(self->indices);
+    if (self->coefs != NULL) free(self->coefs);
+    ((PyObject *) self)->ob_type->tp_free(self);
+}
+
+static Py_ssize_t linear_expr_length(linear_expr *self) {
+    return self->nterms;
+}
+
+static int _linear_reserve(linear_expr *self, Py_ssize_t n) {
+    // Makes room for n more terms, growing by doubling
+    int *indices;
+    SCIP_Real *coefs;
+    Py_ssize_t capacity;
+
+    if (self->solv == NULL) {
+        PyErr_SetString(error, "linear expression has no solver");
+        return -1;
+    }
+    if (self->nterms + n <= self->capacity)
+        return 0;
+    if (self->nterms + n > INT_MAX) {
+        PyErr_SetString(error, "too many terms in linear expression");
+        return -1;
+    }
+
+    capacity = self->capacity > 0 ? self->capacity : 16;
+    while (capacity < self->nterms + n)
+        capacity = capacity <= INT_MAX / 2 ? 2 * capacity : INT_MAX;
+
+    indices = realloc(self->indices, capacity * sizeof(int));
+    if (indices != NULL)
+        self->indices = indices;
+    coefs = realloc(self->coefs, capacity * sizeof(SCIP_Real));
+    if (coefs != NULL)
+        self->coefs = coefs;
+    if (indices == NULL || coefs == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        return -1;
+    }
+
+    self->capacity = (int) capacity;
+    return 0;
+}
+
+static int _linear_add_variable(linear_expr *self, PyObject *v, SCIP_Real coef) {
+    if (!PyScipVariable_Check(v)) {
+        PyErr_SetString(error, "invalid variable type");
+        return -1;
+    }
+    if (self->solv == NULL || ((variable *) v)->scip != self->solv->scip) {
+        PyErr_SetString(error, "variable not associated with solver");
+        return -1;
+    }
+    if (_linear_reserve(self, 1))
+        return -1;
+
+    self->indices[self->nterms] = ((variable *) v)->index;
+    self->coefs[self->nterms++] = coef;
+    return 0;
+}
+
+static int _linear_add_terms(linear_expr *self, PyObject *terms, SCIP_Real sign) {
+    // Adds terms of a python-algebraic expression, like {(x,): 2, (): 1}
+    PyObject *key, *value;
+    Py_ssize_t pos;
+    double coef;
+
+    if (!PyDict_Check(terms)) {
+        PyErr_SetString(error, "invalid expression terms");
+        return -1;
+    }
+    if (_linear_reserve(self, PyDict_Size(terms)))
+        return -1;
+
+    pos = 0;
+    while (PyDict_Next(terms, &pos, &key, &value)) {
+        if (!PyTuple_Check(key) || PyTuple_GET_SIZE(key) > 1) {
+            PyErr_SetString(error, "linear expressions can only hold linear terms");
+            return -1;
+        }
+        if (!(PyFloat_Check(value) || PyLong_Check(value))) {
+            PyErr_SetString(error, "invalid coefficient");
+            return -1;
+        }
+
+        coef = sign * PyFloat_AsDouble(value);
+        if (PyTuple_GET_SIZE(key) == 0)
+            self->constant += coef;
+        else if (_linear_add_variable(self, PyTuple_GET_ITEM(key, 0), coef))
+            return -1;
+    }
+    return 0;
+}
+
+static int _linear_add(linear_expr *self, PyObject *other, SCIP_Real sign) {
+    // Adds sign*other in place.  Returns 1 for types we don't know.
+    linear_expr *e;
+    PyObject *terms;
+    int i, n;
+
+    if (PyFloat_Check(other) || PyLong_Check(other)) {
+        self->constant += sign * PyFloat_AsDouble(other);
+        return PyErr_Occurred() ? -1 : 0;
+    }
+
+    if (PyScipVariable_Check(other))
+        return _linear_add_variable(self, other, sign);
+
+    if (PyScipLinearExpr_Check(other)) {
+        e = (linear_expr *) other;
+        if (e->solv != self->solv) {
+            PyErr_SetString(error, "variable not associated with solver");
+            return -1;
+        }
+
+        // Read the count first, in case e is self
+        n = e->nterms;
+        if (_linear_reserve(self, n))
+            return -1;
+        for (i = 0; i < n; i++) {
+            self->indices[self->nterms + i] = e->indices[i];
+            self->coefs[self->nterms + i] = sign * e->coefs[i];
+        }
+        self->nterms += n;
+        self->constant += sign * e->constant;
+        return 0;
+    }
+
+    // Anything else with terms is taken for a python-algebraic expression
+    terms = PyObject_GetAttrString(other, "terms");
+    if (terms == NULL) {
+        PyErr_Clear();
+        return 1;
+    }
+    i = _linear_add_terms(self, terms, sign);
+    Py_DECREF(terms);
+    return i;
+}
+
+static PyObject *_linear_inplace(linear_expr *self, PyObject *other, SCIP_Real sign) {
+    int result;
+
+    // Reflected operands don't get here for in place operators, but check
+    if (!PyScipLinearExpr_Check((PyObject *) self)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    result = _linear_add(self, other, sign);
+    if (result < 0)
+        return NULL;
+    if (result > 0) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+static PyObject *linear_expr_iadd(linear_expr *self, PyObject *other) {
+    return _linear_inplace(self, other, 1.0);
+}
+
+static PyObject *linear_expr_isub(linear_expr *self, PyObject *other) {
+    return _linear_inplace(self, other, -1.0);
+}
+
+static PyObject *linear_expr_imul(linear_expr *self, PyObject *other) {
+    double d;
+    int i;
+
+    if (!PyScipLinearExpr_Check((PyObject *) self) || !(PyFloat_Check(other) || PyLong_Check(other))) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    d = PyFloat_AsDouble(other);
+    if (d == -1 && PyErr_Occurred())
+        return NULL;
+    for (i = 0; i < self->nterms; i++)
+        self->coefs[i] *= d;
+    self->constant *= d;
+
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+static PyObject *linear_expr_add(linear_expr *self, PyObject *args, PyObject *kwds) {
+    // Adds coef*variable without building any intermediate objects
+    static char *argnames[] = {"variable", "coef", NULL};
+    PyObject *v;
+    double coef = 1.0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|d", argnames, &v, &coef))
+        return NULL;
+    if (_linear_add_variable(self, v, coef))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *linear_expr_add_terms(linear_expr *self, PyObject *args) {
+    // Adds coefs[i]*x[i] for a variable block or an array of variable
+    // indices.  coefs may be one number for every term.
+    PyObject *x, *c;
+    py_scip_array indices, coefs;
+    Py_ssize_t i, n;
+    Py_ssize_t index, start = 0;
+    bool block;
+
+    if (!PyArg_ParseTuple(args, "OO", &x, &c))
+        return NULL;
+    if (self->solv == NULL) {
+        PyErr_SetString(error, "linear expression has no solver");
+        return NULL;
+    }
+
+    block = PyScipVariableBlock_Check(x);
+    if (block) {
+        if (((variable_block *) x)->solv != self->solv) {
+            PyErr_SetString(error, "variable block not associated with solver");
+            return NULL;
+        }
+        n = ((variable_block *) x)->nvars;
+        start = ((variable_block *) x)->start;
+    } else {
+        if (PyScipArrayGet(error, x, &indices, "indices", true, false))
+            return NULL;
+        n = indices.size;
+    }
+
+    if (PyScipArrayGetReals(error, c, &coefs, "coefs", n, 1.0))
+        goto cleanup;
+    if (_linear_reserve(self, n)) {
+        PyScipArrayRelease(&coefs);
+        goto cleanup;
+    }
+
+    for (i = 0; i < n; i++) {
+        index = block ? start + i : PyScipArrayIndex(&indices, i);
+        if (index < 0 || index >= self->solv->vars.size) {
+            PyScipArrayRelease(&coefs);
+            PyErr_SetString(error, "variable index out of range");
+            goto cleanup;
+        }
+        self->indices[self->nterms + i] = (int) index;
+        self->coefs[self->nterms + i] = PyScipArrayReal(&coefs, i);
+    }
+    self->nterms += (int) n;
+
+    PyScipArrayRelease(&coefs);
+    if (!block)
+        PyScipArrayRelease(&indices);
+    Py_RETURN_NONE;
+
+cleanup:
+    if (!block)
+        PyScipArrayRelease(&indices);
+    return NULL;
+}
+
+static PyObject *linear_expr_terms(linear_expr *self) {
+    // Returns coefficients keyed on variable indices, with repeats summed
+    PyObject *terms, *key, *value;
+    double d;
+    int i;
+
+    if ((terms = PyDict_New()) == NULL)
+        return NULL;
+
+    for (i = 0; i < self->nterms; i++) {
+        if ((key = PyLong_FromLong(self->indices[i])) == NULL)
+            goto error;
+        value = PyDict_GetItem(terms, key);
+        d = self->coefs[i] + (value != NULL ? PyFloat_AS_DOUBLE(value) : 0.0);
+        if ((value = PyFloat_FromDouble(d)) == NULL || PyDict_SetItem(terms, key, value)) {
+            Py_XDECREF(value);
+            Py_DECREF(key);
+            goto error;
+        }
+        Py_DECREF(value);
+        Py_DECREF(key);
+    }
+    return terms;
+
+error:
+    Py_DECREF(terms);
+    return NULL;
+}
+
+static PyObject *linear_expr_clear_bounds(linear_expr *self) {
+    Py_CLEAR(self->lower);
+    Py_CLEAR(self->upper);
+    Py_RETURN_NONE;
+}
+
+static PyObject *linear_expr_richcompare(linear_expr *self, PyObject *other, int op) {
+    // Comparisons put bounds on the expression itself, the same way
+    // python-algebraic does, so 1 <= e <= 2 works as a constraint
+    PyObject *bound;
+
+    if (!(PyFloat_Check(other) || PyLong_Check(other)) || !(op == Py_LE || op == Py_GE || op == Py_EQ)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    if ((bound = PyNumber_Float(other)) == NULL)
+        return NULL;
+
+    if (op == Py_GE || op == Py_EQ) {
+        Py_INCREF(bound);
+        Py_XDECREF(self->lower);
+        self->lower = bound;
+    }
+    if (op == Py_LE || op == Py_EQ) {
+        Py_INCREF(bound);
+        Py_XDECREF(self->upper);
+        self->upper = bound;
+    }
+    Py_DECREF(bound);
+
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+static PyMemberDef linear_expr_members[] = {
+    {"constant", T_DOUBLE, offsetof(linear_expr, constant), 0, "constant term"},
+    {"expr_lower", T_OBJECT, offsetof(linear_expr, lower), READONLY, "lower bound from a comparison, or None"},
+    {"expr_upper", T_OBJECT, offsetof(linear_expr, upper), READONLY, "upper bound from a comparison, or None"},
+    {"solver", T_OBJECT, offsetof(linear_expr, solv), READONLY, "solver the variables belong to"},
+    {NULL} /* Sentinel */
+};
+
+static PyMethodDef linear_expr_methods[] = {
+    {"add", (PyCFunction) linear_expr_add, METH_VARARGS | METH_KEYWORDS, "adds coef*variable"},
+    {"add_terms", (PyCFunction) linear_expr_add_terms, METH_VARARGS, "adds terms for a variable block or index array"},
+    {"terms", (PyCFunction) linear_expr_terms, METH_NOARGS, "returns coefficients keyed on variable indices"},
+    {"_clear_bounds", (PyCFunction) linear_expr_clear_bounds, METH_NOARGS, "removes bounds from comparisons"},
+    {NULL} /* Sentinel */
+};
+
+// Python 2 and 3 lay these out differently, so only name the slots we use
+static PyNumberMethods linear_expr_number = {
+    .nb_inplace_add      = (binaryfunc) linear_expr_iadd,
+    .nb_inplace_subtract = (binaryfunc) linear_expr_isub,
+    .nb_inplace_multiply = (binaryfunc) linear_expr_imul,
+};
+
+static PySequenceMethods linear_expr_sequence = {
+    (lenfunc) linear_expr_length,    /* sq_length */
+};
+
+static PyTypeObject linear_expr_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_expr.linear_expr",             /* tp_name */
+    sizeof(linear_expr),             /* tp_basicsize */
+    0,                               /* tp_itemsize */
+    (destructor) linear_expr_dealloc, /* tp_dealloc */
+    0,                               /* tp_print */
+    0,                               /* tp_getattr */
+    0,                               /* tp_setattr */
+    0,                               /* tp_compare */
+    0,                               /* tp_repr */
+    &linear_expr_number,             /* tp_as_number */
+    &linear_expr_sequence,           /* tp_as_sequence */
+    0,                               /* tp_as_mapping */
+    0,                               /* tp_hash */
+    0,                               /* tp_call */
+    0,                               /* tp_str */
+    0,                               /* tp_getattro */
+    0,                               /* tp_setattro */
+    0,                               /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC
+#if PY_MAJOR_VERSION < 3
+        | Py_TPFLAGS_HAVE_INPLACEOPS | Py_TPFLAGS_HAVE_RICHCOMPARE
+#endif
+        ,                            /* tp_flags */
+    "SCIP linear expressions",       /* tp_doc */
+    (traverseproc) linear_expr_traverse, /* tp_traverse */
+    (inquiry) linear_expr_clear,     /* tp_clear */
+    (richcmpfunc) linear_expr_richcompare, /* tp_richcompare */
+    0,                               /* tp_weaklistoffset */
+    0,                               /* tp_iter */
+    0,                               /* tp_iternext */
+    linear_expr_methods,             /* tp_methods */
+    linear_expr_members,             /* tp_members */
+    0,                               /* tp_getset */
+    0,                               /* tp_base */
+    0,                               /* tp_dict */
+    0,                               /* tp_descr_get */
+    0,                               /* tp_descr_set */
+    0,                               /* tp_dictoffset */
+    (initproc) linear_expr_init,     /* tp_init */
+    0,                               /* tp_alloc */
+    0,                               /* tp_new */
+};
+
+#if PY_MAJOR_VERSION >= 3
+static PyModuleDef expr_module = {
+    PyModuleDef_HEAD_INIT,
+    "_expr",
+    "SCIP Linear Expression",
+    -1,
+    NULL, NULL, NULL, NULL, NULL
+};
+#endif
+
+#ifndef PyMODINIT_FUNC    /* declarations for DLL import/export */
+#define PyMODINIT_FUNC void
+#endif
+PyMODINIT_FUNC PyInit__expr(void) {
+    PyObject* m;
+
+    linear_expr_type.tp_new = PyType_GenericNew;
+    if (PyType_Ready(&linear_expr_type) < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
+#if PY_MAJOR_VERSION >= 3
+    m = PyModule_Create(&expr_module);
+#else
+    m = Py_InitModule3("_expr", NULL, "SCIP Linear Expression");
+#endif
+
+    py_scip_types_table->linear_expr = &linear_expr_type;
+
+    Py_INCREF(&linear_expr_type);
+    PyModule_AddObject(m, "linear_expr", (PyObject *) &linear_expr_type);
+
+    // Initialize exception type
+    error = PyErr_NewException("_expr.error", NULL, NULL);
+    Py_INCREF(error);
+    PyModule_AddObject(m, "error", error);
+
+#if PY_MAJOR_VERSION >= 3
+    return m;
+#endif
+}
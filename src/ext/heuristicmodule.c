@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -14,14 +15,18 @@ static int heuristic_init(heuristic *self, PyObject *args, PyObject *kwds) {
     if (!PyArg_ParseTuple(args, "Os", &s, &name))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_XDECREF(self->solver_ref);
+    self->solver_ref = PyWeakref_NewRef(s, NULL);
+    if (self->solver_ref == NULL)
+        return -1;
     
     // Load the heuristic from SCIP
     r = SCIPfindHeur(self->scip, name);
@@ -35,20 +40,17 @@ static int heuristic_init(heuristic *self, PyObject *args, PyObject *kwds) {
 }
 
 static void heuristic_dealloc(heuristic *self) {
+    Py_XDECREF(self->solver_ref);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* heuristic_getattr(heuristic *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "freqofs") == 0)
-            return Py_BuildValue("i", SCIPheurGetFreqofs(self->heur));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "frequency") == 0)
-            return Py_BuildValue("i", SCIPheurGetFreq(self->heur));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "maxdepth") == 0)
-            return Py_BuildValue("i", SCIPheurGetMaxdepth(self->heur));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0)
-            return Py_BuildValue("i", SCIPheurGetPriority(self->heur));
+        PY_SCIP_GET("freqofs", "i", SCIPheurGetFreqofs(self->heur));
+        PY_SCIP_GET("frequency", "i", SCIPheurGetFreq(self->heur));
+        PY_SCIP_GET("maxdepth", "i", SCIPheurGetMaxdepth(self->heur));
+        PY_SCIP_GET("priority", "i", SCIPheurGetPriority(self->heur));
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -58,6 +60,7 @@ static int heuristic_setattr(heuristic *self, PyObject *attr_name, PyObject *val
     
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
+        PY_SCIP_CHECK_SETTINGS_IDLE(error, -1);
         PY_SCIP_SET_INT_MIN("freqofs", self->heur->freqofs, 0); 
         PY_SCIP_SET_INT_MIN("frequency", self->heur->freq, -1); 
         PY_SCIP_SET_INT_MIN("maxdepth", self->heur->maxdepth, -1); 
@@ -146,6 +149,14 @@ PyMODINIT_FUNC PyInit__heur(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&heur_module); 
 #else
@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_buffer.h"
 #include "python_zibopt_error.h"
 
 static PyObject *error;
@@ -13,7 +14,6 @@ static int lp_init(lp *self, PyObject *args, PyObject *kwds) {
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "i", argnames, &sense))
         return -1;
 
-    // TODO: unit test this
     if (sense != SCIP_OBJSENSE_MAXIMIZE && sense != SCIP_OBJSENSE_MINIMIZE) {
         PyErr_SetString(error, "invalid objective sense");
         return -1;
@@ -30,14 +30,660 @@ static void lp_dealloc(lp *self) {
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
+static PyObject* lp_getattr(lp *self, PyObject *attr_name) {
+    // Check and make sure we have a string as attribute name...
+    if (PyUnicode_Check(attr_name)) {
+        int n;
+        SCIP_Real d;
+
+        if (PyUnicode_CompareWithASCIIString(attr_name, "nrows") == 0) {
+            PY_SCIP_CHECK_IDLE(error, NULL, self);
+            PY_SCIP_CALL(error, NULL, SCIPlpiGetNRows(self->lpi, &n));
+            return Py_BuildValue("i", n);
+        }
+        if (PyUnicode_CompareWithASCIIString(attr_name, "ncols") == 0) {
+            PY_SCIP_CHECK_IDLE(error, NULL, self);
+            PY_SCIP_CALL(error, NULL, SCIPlpiGetNCols(self->lpi, &n));
+            return Py_BuildValue("i", n);
+        }
+        if (PyUnicode_CompareWithASCIIString(attr_name, "iterations") == 0) {
+            PY_SCIP_CHECK_IDLE(error, NULL, self);
+            PY_SCIP_CALL(error, NULL, SCIPlpiGetIterations(self->lpi, &n));
+            return Py_BuildValue("i", n);
+        }
+        if (PyUnicode_CompareWithASCIIString(attr_name, "objective") == 0) {
+            PY_SCIP_CHECK_IDLE(error, NULL, self);
+            PY_SCIP_CALL(error, NULL, SCIPlpiGetObjval(self->lpi, &d));
+            return Py_BuildValue("d", d);
+        }
+
+        // Status of the last solve
+        if (PyUnicode_CompareWithASCIIString(attr_name, "optimal") == 0) {
+            PY_SCIP_CHECK_IDLE(error, NULL, self);
+            return PyBool_FromLong(SCIPlpiIsOptimal(self->lpi));
+        }
+        if (PyUnicode_CompareWithASCIIString(attr_name, "infeasible") == 0) {
+            PY_SCIP_CHECK_IDLE(error, NULL, self);
+            return PyBool_FromLong(SCIPlpiIsPrimalInfeasible(self->lpi));
+        }
+        if (PyUnicode_CompareWithASCIIString(attr_name, "unbounded") == 0) {
+            PY_SCIP_CHECK_IDLE(error, NULL, self);
+            return PyBool_FromLong(SCIPlpiIsPrimalUnbounded(self->lpi));
+        }
+    }
+    return PyObject_GenericGetAttr((PyObject *) self, attr_name);
+}
+
+/*****************************************************************************/
+/* ARRAY CONVERSION                                                          */
+/*****************************************************************************/
+// The LPI wants int indices and SCIP_Real values, so everything is copied
+// into C arrays first.  That also means nothing reaches the LPI until the
+// whole input has been checked.
+
+static int _lp_size(lp *self, bool rows, int *n) {
+    if (rows) {
+        PY_SCIP_CALL(error, -1, SCIPlpiGetNRows(self->lpi, n));
+    } else {
+        PY_SCIP_CALL(error, -1, SCIPlpiGetNCols(self->lpi, n));
+    }
+    return 0;
+}
+
+static SCIP_Real _lp_clip(SCIP_Real d, SCIP_Real inf) {
+    return d < -inf ? -inf : (d > inf ? inf : d);
+}
+
+// Reads a compressed sparse block of vectors: vector i has entries
+// indptr[i]:indptr[i+1] of indices and data, and indices must be below
+// bound.  If *n is negative it is set from indptr, otherwise indptr must
+// match it.  Arrays are allocated with malloc.  Returns 0 on success.
+static int _lp_sparse(PyObject *indptr_obj, PyObject *indices_obj, PyObject *data_obj,
+    int bound, const char *what, int *n, int **beg, int **ind, SCIP_Real **val, int *nnonz) {
+
+    py_scip_array indptr, indices, data;
+    Py_ssize_t b, e, first, last, k, j;
+    int i, result = -1;
+
+    *beg = NULL;
+    *ind = NULL;
+    *val = NULL;
+
+    if (PyScipArrayGet(error, indptr_obj, &indptr, "indptr", true, false))
+        return -1;
+    if (PyScipArrayGet(error, indices_obj, &indices, "indices", true, false)) {
+        PyScipArrayRelease(&indptr);
+        return -1;
+    }
+    if (PyScipArrayGet(error, data_obj, &data, "data", false, false)) {
+        PyScipArrayRelease(&indptr);
+        PyScipArrayRelease(&indices);
+        return -1;
+    }
+
+    if (indptr.size < 1 || indptr.size - 1 > INT_MAX || (*n >= 0 && indptr.size != *n + 1)) {
+        PyErr_SetString(error, "indptr must have one more element than there are vectors");
+        goto cleanup;
+    }
+    if (indices.size != data.size) {
+        PyErr_SetString(error, "indices and data must be the same length");
+        goto cleanup;
+    }
+
+    // Entries before indptr[0] or after indptr[n] are skipped
+    *n = (int) (indptr.size - 1);
+    first = PyScipArrayIndex(&indptr, 0);
+    last = PyScipArrayIndex(&indptr, *n);
+    if (first < 0 || last < first || last > indices.size || last - first > INT_MAX) {
+        PyErr_SetString(error, "indptr must be nondecreasing and within indices");
+        goto cleanup;
+    }
+
+    *beg = malloc((*n > 0 ? *n : 1) * sizeof(int));
+    *ind = malloc((last > first ? last - first : 1) * sizeof(int));
+    *val = malloc((last > first ? last - first : 1) * sizeof(SCIP_Real));
+    if (*beg == NULL || *ind == NULL || *val == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+
+    for (i = 0; i < *n; i++) {
+        b = PyScipArrayIndex(&indptr, i);
+        e = PyScipArrayIndex(&indptr, i+1);
+        if (b < first || e < b || e > last) {
+            PyErr_SetString(error, "indptr must be nondecreasing and within indices");
+            goto cleanup;
+        }
+        (*beg)[i] = (int) (b - first);
+    }
+
+    for (k = first; k < last; k++) {
+        j = PyScipArrayIndex(&indices, k);
+        if (j < 0 || j >= bound) {
+            PyErr_Format(error, "%s index out of range", what);
+            goto cleanup;
+        }
+        (*ind)[k - first] = (int) j;
+        (*val)[k - first] = PyScipArrayReal(&data, k);
+    }
+
+    *nnonz = (int) (last - first);
+    result = 0;
+
+cleanup:
+    if (result != 0) {
+        if (*beg != NULL) free(*beg);
+        if (*ind != NULL) free(*ind);
+        if (*val != NULL) free(*val);
+        *beg = NULL;
+        *ind = NULL;
+        *val = NULL;
+    }
+    PyScipArrayRelease(&indptr);
+    PyScipArrayRelease(&indices);
+    PyScipArrayRelease(&data);
+    return result;
+}
+
+// Reads row or column indices and one or two arrays of values for them,
+// the way SCIPlpiChgObj, SCIPlpiChgBounds and SCIPlpiChgSides take them.
+// Values may be single numbers.  second_obj is NULL if there is only one.
+// Returns the number of indices, or -1 on error.
+static int _lp_indexed(lp *self, bool rows, PyObject *indices_obj, PyObject *first_obj,
+    PyObject *second_obj, int **ind, SCIP_Real **first, SCIP_Real **second) {
+
+    py_scip_array indices, a, b;
+    Py_ssize_t i, j;
+    int bound, n, result = -1;
+
+    *ind = NULL;
+    *first = NULL;
+    if (second != NULL)
+        *second = NULL;
+
+    if (first_obj == Py_None || second_obj == Py_None) {
+        PyErr_SetString(error, "values are required for every index");
+        return -1;
+    }
+    if (_lp_size(self, rows, &bound))
+        return -1;
+
+    if (PyScipArrayGet(error, indices_obj, &indices, "indices", true, false))
+        return -1;
+    memset(&b, 0, sizeof(py_scip_array));
+    if (PyScipArrayGetReals(error, first_obj, &a, "values", indices.size, 0.0)) {
+        PyScipArrayRelease(&indices);
+        return -1;
+    }
+    if (second_obj != NULL && PyScipArrayGetReals(error, second_obj, &b, "values", indices.size, 0.0))
+        goto cleanup;
+
+    if (indices.size > INT_MAX) {
+        PyErr_SetString(error, "too many indices");
+        goto cleanup;
+    }
+    n = (int) indices.size;
+
+    *ind = malloc((n > 0 ? n : 1) * sizeof(int));
+    *first = malloc((n > 0 ? n : 1) * sizeof(SCIP_Real));
+    if (second_obj != NULL)
+        *second = malloc((n > 0 ? n : 1) * sizeof(SCIP_Real));
+    if (*ind == NULL || *first == NULL || (second_obj != NULL && *second == NULL)) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+
+    for (i = 0; i < n; i++) {
+        j = PyScipArrayIndex(&indices, i);
+        if (j < 0 || j >= bound) {
+            PyErr_Format(error, "%s index out of range", rows ? "row" : "column");
+            goto cleanup;
+        }
+        (*ind)[i] = (int) j;
+        (*first)[i] = PyScipArrayReal(&a, i);
+        if (second_obj != NULL)
+            (*second)[i] = PyScipArrayReal(&b, i);
+    }
+
+    result = n;
+
+cleanup:
+    if (result < 0) {
+        if (*ind != NULL) free(*ind);
+        if (*first != NULL) free(*first);
+        if (second != NULL && *second != NULL) free(*second);
+        *ind = NULL;
+        *first = NULL;
+        if (second != NULL)
+            *second = NULL;
+    }
+    PyScipArrayRelease(&indices);
+    PyScipArrayRelease(&a);
+    PyScipArrayRelease(&b);
+    return result;
+}
+
+// Acquires a writable output buffer of n elements in the LPI's own type
+static int _lp_output(PyObject *o, py_scip_array *out, const char *name, Py_ssize_t n, bool integral) {
+    memset(out, 0, sizeof(py_scip_array));
+    if (o == NULL || o == Py_None)
+        return 0;
+
+    if (PyScipArrayGet(error, o, out, name, integral, true))
+        return -1;
+
+    if (out->size != n || (integral ? (out->format != 'i' || out->view.itemsize != sizeof(int))
+                                    : PyScipArrayReals(out) == NULL)) {
+        PyScipArrayRelease(out);
+        PyErr_Format(error, "%s must be an array of %zd %s", name, n, integral ? "ints" : "doubles");
+        return -1;
+    }
+
+    return 0;
+}
+
 /*****************************************************************************/
 /* ADDITONAL METHODS                                                         */
 /*****************************************************************************/
+static PyObject *lp_add_cols(lp *self, PyObject *args, PyObject *kwds) {
+    // Adds n columns and returns the index of the first.  Column entries
+    // come as compressed sparse columns over existing rows, or not at all
+    // for empty columns that rows fill in later.
+    static char *argnames[] = {"n", "obj", "lower", "upper", "indptr", "indices", "data", NULL};
+    PyObject *obj_obj = NULL, *lower_obj = NULL, *upper_obj = NULL;
+    PyObject *indptr_obj = NULL, *indices_obj = NULL, *data_obj = NULL;
+    py_scip_array obj, lower, upper;
+    SCIP_Real *obj_vals = NULL, *lb, *ub, *val = NULL;
+    SCIP_Real inf;
+    int *beg = NULL, *ind = NULL;
+    int n, nrows, ncols, nnonz = 0, i;
+    SCIP_RETCODE retcode;
+    PyObject *result = NULL;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|OOOOOO", argnames, &n, &obj_obj,
+        &lower_obj, &upper_obj, &indptr_obj, &indices_obj, &data_obj))
+        return NULL;
+
+    if (n < 0) {
+        PyErr_SetString(error, "number of columns must be nonnegative");
+        return NULL;
+    }
+    if (_lp_size(self, true, &nrows) || _lp_size(self, false, &ncols))
+        return NULL;
+    inf = SCIPlpiInfinity(self->lpi);
+
+    memset(&lower, 0, sizeof(py_scip_array));
+    memset(&upper, 0, sizeof(py_scip_array));
+    if (PyScipArrayGetReals(error, obj_obj, &obj, "obj", n, 0.0) ||
+        PyScipArrayGetReals(error, lower_obj, &lower, "lower", n, 0.0) ||
+        PyScipArrayGetReals(error, upper_obj, &upper, "upper", n, inf))
+        goto cleanup;
+
+    if (indptr_obj != NULL && indptr_obj != Py_None) {
+        if (indices_obj == NULL || indices_obj == Py_None || data_obj == NULL || data_obj == Py_None) {
+            PyErr_SetString(error, "indptr, indices and data must be given together");
+            goto cleanup;
+        }
+        if (_lp_sparse(indptr_obj, indices_obj, data_obj, nrows, "row", &n, &beg, &ind, &val, &nnonz))
+            goto cleanup;
+    } else if ((beg = calloc(n > 0 ? n : 1, sizeof(int))) == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+
+    // Objective and bounds share one allocation
+    obj_vals = malloc((n > 0 ? 3 * n : 1) * sizeof(SCIP_Real));
+    if (obj_vals == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+    lb = obj_vals + n;
+    ub = lb + n;
+
+    for (i = 0; i < n; i++) {
+        obj_vals[i] = PyScipArrayReal(&obj, i);
+        lb[i] = _lp_clip(PyScipArrayReal(&lower, i), inf);
+        ub[i] = _lp_clip(PyScipArrayReal(&upper, i), inf);
+        if (ub[i] < lb[i]) {
+            PyErr_SetString(error, "invalid column: upper < lower");
+            goto cleanup;
+        }
+    }
+
+    retcode = SCIPlpiAddCols(self->lpi, n, obj_vals, lb, ub, NULL, nnonz, beg, ind, val);
+    if (retcode != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+    result = Py_BuildValue("i", ncols);
+
+cleanup:
+    if (obj_vals != NULL) free(obj_vals);
+    if (beg != NULL) free(beg);
+    if (ind != NULL) free(ind);
+    if (val != NULL) free(val);
+    PyScipArrayRelease(&obj);
+    PyScipArrayRelease(&lower);
+    PyScipArrayRelease(&upper);
+    return result;
+}
+
+static PyObject *lp_add_rows(lp *self, PyObject *args, PyObject *kwds) {
+    // Adds rows lower <= A*x <= upper over existing columns, with A as
+    // compressed sparse rows, and returns the index of the first
+    static char *argnames[] = {"indptr", "indices", "data", "lower", "upper", NULL};
+    PyObject *indptr_obj, *indices_obj, *data_obj, *lower_obj = Py_None, *upper_obj = Py_None;
+    py_scip_array lower, upper;
+    SCIP_Real *lhs = NULL, *rhs, *val = NULL;
+    SCIP_Real inf;
+    int *beg = NULL, *ind = NULL;
+    int n = -1, nrows, ncols, nnonz, i;
+    SCIP_RETCODE retcode;
+    PyObject *result = NULL;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO|OO", argnames, &indptr_obj, &indices_obj,
+        &data_obj, &lower_obj, &upper_obj))
+        return NULL;
+
+    if (lower_obj == Py_None && upper_obj == Py_None) {
+        PyErr_SetString(error, "at least one bound is required");
+        return NULL;
+    }
+    if (_lp_size(self, true, &nrows) || _lp_size(self, false, &ncols))
+        return NULL;
+    inf = SCIPlpiInfinity(self->lpi);
+
+    if (_lp_sparse(indptr_obj, indices_obj, data_obj, ncols, "column", &n, &beg, &ind, &val, &nnonz))
+        return NULL;
+
+    memset(&lower, 0, sizeof(py_scip_array));
+    memset(&upper, 0, sizeof(py_scip_array));
+    if (PyScipArrayGetReals(error, lower_obj, &lower, "lower", n, -inf) ||
+        PyScipArrayGetReals(error, upper_obj, &upper, "upper", n, inf))
+        goto cleanup;
+
+    lhs = malloc((n > 0 ? 2 * n : 1) * sizeof(SCIP_Real));
+    if (lhs == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+    rhs = lhs + n;
+
+    for (i = 0; i < n; i++) {
+        lhs[i] = _lp_clip(PyScipArrayReal(&lower, i), inf);
+        rhs[i] = _lp_clip(PyScipArrayReal(&upper, i), inf);
+        if (rhs[i] < lhs[i]) {
+            PyErr_SetString(error, "invalid row: upper < lower");
+            goto cleanup;
+        }
+    }
+
+    retcode = SCIPlpiAddRows(self->lpi, n, lhs, rhs, NULL, nnonz, beg, ind, val);
+    if (retcode != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+    result = Py_BuildValue("i", nrows);
+
+cleanup:
+    if (lhs != NULL) free(lhs);
+    if (beg != NULL) free(beg);
+    if (ind != NULL) free(ind);
+    if (val != NULL) free(val);
+    PyScipArrayRelease(&lower);
+    PyScipArrayRelease(&upper);
+    return result;
+}
+
+static PyObject *_lp_solve(lp *self, bool dual) {
+    // Runs the simplex from whatever basis the LPI has, which after a
+    // change to bounds or sides is usually still dual feasible
+    SCIP_RETCODE retcode;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+
+    self->solving = true;
+    Py_BEGIN_ALLOW_THREADS
+    retcode = dual ? SCIPlpiSolveDual(self->lpi) : SCIPlpiSolvePrimal(self->lpi);
+    Py_END_ALLOW_THREADS
+    self->solving = false;
+    PY_SCIP_CALL(error, NULL, retcode);
+
+    return PyBool_FromLong(SCIPlpiIsOptimal(self->lpi));
+}
+
+static PyObject *lp_solve_primal(lp *self) {
+    return _lp_solve(self, false);
+}
+
+static PyObject *lp_solve_dual(lp *self) {
+    return _lp_solve(self, true);
+}
+
+static PyObject *lp_set_objective(lp *self, PyObject *args) {
+    // Changes objective coefficients of the columns at indices
+    PyObject *indices_obj, *values_obj;
+    SCIP_Real *obj;
+    SCIP_RETCODE retcode;
+    int *ind;
+    int n;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "OO", &indices_obj, &values_obj))
+        return NULL;
+
+    if ((n = _lp_indexed(self, false, indices_obj, values_obj, NULL, &ind, &obj, NULL)) < 0)
+        return NULL;
+    retcode = SCIPlpiChgObj(self->lpi, n, ind, obj);
+    free(ind);
+    free(obj);
+    PY_SCIP_CALL(error, NULL, retcode);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *_lp_change_bounds(lp *self, PyObject *args, bool rows) {
+    PyObject *indices_obj, *lower_obj, *upper_obj;
+    SCIP_Real *lower, *upper;
+    SCIP_Real inf;
+    SCIP_RETCODE retcode;
+    bool valid;
+    int *ind;
+    int n, i;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "OOO", &indices_obj, &lower_obj, &upper_obj))
+        return NULL;
+
+    if ((n = _lp_indexed(self, rows, indices_obj, lower_obj, upper_obj, &ind, &lower, &upper)) < 0)
+        return NULL;
+
+    inf = SCIPlpiInfinity(self->lpi);
+    valid = true;
+    for (i = 0; i < n && valid; i++) {
+        lower[i] = _lp_clip(lower[i], inf);
+        upper[i] = _lp_clip(upper[i], inf);
+        valid = lower[i] <= upper[i];
+    }
+
+    retcode = SCIP_OKAY;
+    if (valid && rows)
+        retcode = SCIPlpiChgSides(self->lpi, n, ind, lower, upper);
+    else if (valid)
+        retcode = SCIPlpiChgBounds(self->lpi, n, ind, lower, upper);
+    free(ind);
+    free(lower);
+    free(upper);
+
+    if (!valid) {
+        PyErr_SetString(error, "invalid bounds: upper < lower");
+        return NULL;
+    }
+    PY_SCIP_CALL(error, NULL, retcode);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *lp_set_bounds(lp *self, PyObject *args) {
+    return _lp_change_bounds(self, args, false);
+}
+
+static PyObject *lp_set_sides(lp *self, PyObject *args) {
+    return _lp_change_bounds(self, args, true);
+}
+
+static PyObject *lp_set_sense(lp *self, PyObject *arg) {
+    int sense;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    sense = PyLong_Check(arg) ? (int) PyLong_AsLong(arg) : 0;
+    if (sense != SCIP_OBJSENSE_MAXIMIZE && sense != SCIP_OBJSENSE_MINIMIZE) {
+        PyErr_SetString(error, "invalid objective sense");
+        return NULL;
+    }
+
+    PY_SCIP_CALL(error, NULL, SCIPlpiChgObjsen(self->lpi, sense));
+    Py_RETURN_NONE;
+}
+
+static PyObject *lp_basis_into(lp *self, PyObject *args) {
+    // Writes the basis status of every column and row into int arrays,
+    // as SCIP_BASESTAT values.  Either may be None.
+    PyObject *cstat_obj, *rstat_obj;
+    py_scip_array cstat, rstat;
+    SCIP_RETCODE retcode;
+    int nrows, ncols;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "OO", &cstat_obj, &rstat_obj))
+        return NULL;
+    if (_lp_size(self, true, &nrows) || _lp_size(self, false, &ncols))
+        return NULL;
+
+    if (_lp_output(cstat_obj, &cstat, "cstat", ncols, true))
+        return NULL;
+    if (_lp_output(rstat_obj, &rstat, "rstat", nrows, true)) {
+        PyScipArrayRelease(&cstat);
+        return NULL;
+    }
+
+    retcode = SCIPlpiGetBase(self->lpi, (int *) cstat.view.buf, (int *) rstat.view.buf);
+    PyScipArrayRelease(&cstat);
+    PyScipArrayRelease(&rstat);
+    PY_SCIP_CALL(error, NULL, retcode);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *lp_set_basis(lp *self, PyObject *args) {
+    // Starts the next solve from a basis, as basis_into returns it
+    PyObject *cstat_obj, *rstat_obj;
+    py_scip_array cstat, rstat;
+    SCIP_RETCODE retcode;
+    int *stat = NULL;
+    int nrows, ncols, i;
+    PyObject *result = NULL;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "OO", &cstat_obj, &rstat_obj))
+        return NULL;
+    if (_lp_size(self, true, &nrows) || _lp_size(self, false, &ncols))
+        return NULL;
+
+    if (PyScipArrayGet(error, cstat_obj, &cstat, "cstat", true, false))
+        return NULL;
+    if (PyScipArrayGet(error, rstat_obj, &rstat, "rstat", true, false)) {
+        PyScipArrayRelease(&cstat);
+        return NULL;
+    }
+
+    if (cstat.size != ncols || rstat.size != nrows) {
+        PyErr_Format(error, "basis must have %d column and %d row statuses", ncols, nrows);
+        goto cleanup;
+    }
+
+    // Columns first, then rows, in one allocation
+    stat = malloc((ncols + nrows > 0 ? ncols + nrows : 1) * sizeof(int));
+    if (stat == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+    for (i = 0; i < ncols + nrows; i++) {
+        stat[i] = (int) (i < ncols ? PyScipArrayIndex(&cstat, i) : PyScipArrayIndex(&rstat, i - ncols));
+        if (stat[i] < SCIP_BASESTAT_LOWER || stat[i] > SCIP_BASESTAT_ZERO) {
+            PyErr_SetString(error, "invalid basis status");
+            goto cleanup;
+        }
+    }
+
+    retcode = SCIPlpiSetBase(self->lpi, stat, stat + ncols);
+    if (retcode != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+cleanup:
+    if (stat != NULL) free(stat);
+    PyScipArrayRelease(&cstat);
+    PyScipArrayRelease(&rstat);
+    return result;
+}
+
+static PyObject *lp_solution_into(lp *self, PyObject *args, PyObject *kwds) {
+    // Writes the last solution into arrays of doubles: primal values and
+    // reduced costs by column, duals and activities by row.  Arguments
+    // left as None are skipped.  Returns the objective value.
+    static char *argnames[] = {"primal", "dual", "activity", "redcost", NULL};
+    PyObject *objs[4] = {NULL, NULL, NULL, NULL};
+    py_scip_array out[4];
+    const char *names[4] = {"primal", "dual", "activity", "redcost"};
+    SCIP_Real objval;
+    SCIP_RETCODE retcode;
+    int nrows, ncols, i, j;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OOOO", argnames, &objs[0], &objs[1], &objs[2], &objs[3]))
+        return NULL;
+    if (_lp_size(self, true, &nrows) || _lp_size(self, false, &ncols))
+        return NULL;
+
+    for (i = 0; i < 4; i++) {
+        if (_lp_output(objs[i], &out[i], names[i], (i == 0 || i == 3) ? ncols : nrows, false)) {
+            for (j = 0; j < i; j++)
+                PyScipArrayRelease(&out[j]);
+            return NULL;
+        }
+    }
+
+    retcode = SCIPlpiGetSol(self->lpi, &objval, PyScipArrayReals(&out[0]), PyScipArrayReals(&out[1]),
+        PyScipArrayReals(&out[2]), PyScipArrayReals(&out[3]));
+    for (i = 0; i < 4; i++)
+        PyScipArrayRelease(&out[i]);
+    PY_SCIP_CALL(error, NULL, retcode);
+
+    return Py_BuildValue("d", objval);
+}
 
 /*****************************************************************************/
 /* MODULE INITIALIZATION                                                     */
 /*****************************************************************************/
 static PyMethodDef lp_methods[] = {
+    {"add_cols", (PyCFunction) lp_add_cols, METH_VARARGS | METH_KEYWORDS, "adds columns from compressed sparse columns"},
+    {"add_rows", (PyCFunction) lp_add_rows, METH_VARARGS | METH_KEYWORDS, "adds rows from compressed sparse rows"},
+    {"basis_into", (PyCFunction) lp_basis_into, METH_VARARGS, "writes column and row basis statuses into int arrays"},
+    {"set_basis", (PyCFunction) lp_set_basis, METH_VARARGS, "sets column and row basis statuses"},
+    {"set_bounds", (PyCFunction) lp_set_bounds, METH_VARARGS, "changes bounds of columns"},
+    {"set_objective", (PyCFunction) lp_set_objective, METH_VARARGS, "changes objective coefficients of columns"},
+    {"set_sense", (PyCFunction) lp_set_sense, METH_O, "changes the objective sense"},
+    {"set_sides", (PyCFunction) lp_set_sides, METH_VARARGS, "changes left and right hand sides of rows"},
+    {"solution_into", (PyCFunction) lp_solution_into, METH_VARARGS | METH_KEYWORDS, "writes solution values into arrays"},
+    {"solve_dual", (PyCFunction) lp_solve_dual, METH_NOARGS, "solves with the dual simplex"},
+    {"solve_primal", (PyCFunction) lp_solve_primal, METH_NOARGS, "solves with the primal simplex"},
     {NULL} /* Sentinel */
 };
 
@@ -58,7 +704,7 @@ static PyTypeObject lp_type = {
     0,                           /* tp_hash */
     0,                           /* tp_call */
     0,                           /* tp_str */
-    0,                           /* tp_getattro */
+    (getattrofunc) lp_getattr,   /* tp_getattro */
     0,                           /* tp_setattro */
     0,                           /* tp_as_buffer */
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /* tp_flags */
@@ -116,6 +762,12 @@ PyMODINIT_FUNC PyInit__lp(void) {
     PyModule_AddIntConstant(m, "MAXIMIZE", SCIP_OBJSENSE_MAXIMIZE);
     PyModule_AddIntConstant(m, "MINIMIZE", SCIP_OBJSENSE_MINIMIZE);
 
+    // Basis statuses
+    PyModule_AddIntConstant(m, "LOWER", SCIP_BASESTAT_LOWER);
+    PyModule_AddIntConstant(m, "BASIC", SCIP_BASESTAT_BASIC);
+    PyModule_AddIntConstant(m, "UPPER", SCIP_BASESTAT_UPPER);
+    PyModule_AddIntConstant(m, "ZERO", SCIP_BASESTAT_ZERO);
+
     Py_INCREF(&lp_type);
     PyModule_AddObject(m, "lp", (PyObject *) &lp_type);
 
@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -14,14 +15,18 @@ static int selector_init(selector *self, PyObject *args, PyObject *kwds) {
     if (!PyArg_ParseTuple(args, "Os", &s, &name))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_XDECREF(self->solver_ref);
+    self->solver_ref = PyWeakref_NewRef(s, NULL);
+    if (self->solver_ref == NULL)
+        return -1;
     
     // Load the selector from SCIP
     r = SCIPfindNodesel(self->scip, name);
@@ -35,16 +40,15 @@ static int selector_init(selector *self, PyObject *args, PyObject *kwds) {
 }
 
 static void selector_dealloc(selector *self) {
+    Py_XDECREF(self->solver_ref);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* selector_getattr(selector *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "memsavepriority") == 0)
-            return Py_BuildValue("i", SCIPnodeselGetMemsavePriority(self->nodesel));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "stdpriority") == 0)
-            return Py_BuildValue("i", SCIPnodeselGetStdPriority(self->nodesel));
+        PY_SCIP_GET("memsavepriority", "i", SCIPnodeselGetMemsavePriority(self->nodesel));
+        PY_SCIP_GET("stdpriority", "i", SCIPnodeselGetStdPriority(self->nodesel));
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -52,6 +56,7 @@ static PyObject* selector_getattr(selector *self, PyObject *attr_name) {
 static int selector_setattr(selector *self, PyObject *attr_name, PyObject *value) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
+        PY_SCIP_CHECK_SETTINGS_IDLE(error, -1);
         if (PyUnicode_CompareWithASCIIString(attr_name, "memsavepriority") == 0) {
             if (PyLong_Check(value)) {
                 SCIPnodeselSetMemsavePriority(self->nodesel, self->scip->set, PyLong_AsLong(value));
@@ -155,6 +160,14 @@ PyMODINIT_FUNC PyInit__nodesel(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&nodesel_module); 
 #else
@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -14,14 +15,18 @@ static int propagator_init(propagator *self, PyObject *args, PyObject *kwds) {
     if (!PyArg_ParseTuple(args, "Os", &s, &name))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_XDECREF(self->solver_ref);
+    self->solver_ref = PyWeakref_NewRef(s, NULL);
+    if (self->solver_ref == NULL)
+        return -1;
     
     // Load the propagator from SCIP
     r = SCIPfindProp(self->scip, name);
@@ -35,16 +40,15 @@ static int propagator_init(propagator *self, PyObject *args, PyObject *kwds) {
 }
 
 static void propagator_dealloc(propagator *self) {
+    Py_XDECREF(self->solver_ref);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* propagator_getattr(propagator *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "frequency") == 0)
-            return Py_BuildValue("i", SCIPpropGetFreq(self->prop));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0)
-            return Py_BuildValue("i", SCIPpropGetPriority(self->prop));
+        PY_SCIP_GET("frequency", "i", SCIPpropGetFreq(self->prop));
+        PY_SCIP_GET("priority", "i", SCIPpropGetPriority(self->prop));
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -54,6 +58,7 @@ static int propagator_setattr(propagator *self, PyObject *attr_name, PyObject *v
     
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
+        PY_SCIP_CHECK_SETTINGS_IDLE(error, -1);
         PY_SCIP_SET_INT_MIN("frequency", self->prop->freq, -1); 
         PY_SCIP_SET_PRIORITY(SCIPpropSetPriority, self->prop);
     }
@@ -140,6 +145,14 @@ PyMODINIT_FUNC PyInit__prop(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&prop_module); 
 #else
@@ -4,6 +4,7 @@
 #include <Python.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <structmember.h>
 
@@ -45,10 +46,12 @@
 #define PyUnicode_Check(A) PyString_Check(A)
 #define PyUnicode_CompareWithASCIIString(A, B) strcmp(PyString_AS_STRING(A), B)
 
+#define PyInit__batch init_batch
 #define PyInit__branch init_branch
 #define PyInit__conflict init_conflict
 #define PyInit__cons init_cons
 #define PyInit__disp init_disp
+#define PyInit__expr init_expr
 #define PyInit__heur init_heur
 #define PyInit__lp init_lp
 #define PyInit__nodesel init_nodesel
@@ -63,61 +66,164 @@
 // Note that the above macros must apply to the following:
 #include "python_zibopt_util.h"
 
-#define CONSTRAINT_TYPE_NAME "constraint"
-#define SOLVER_TYPE_NAME "solver"
-#define VARIABLE_TYPE_NAME "variable"
-
 // These are from set.c in SCIP code
 #define SCIP_DEFAULT_LIMIT_TIME 1e+20 /**< maximal time in seconds to run */
 #define SCIP_DEFAULT_LIMIT_GAP    0.0 /**< solving stops, if the gap is below the given value */
 #define SCIP_DEFAULT_LIMIT_ABSGAP 0.0 /**< solving stops, if the absolute difference between primal and dual
                                        *   bound reaches this value */
 #define SCIP_DEFAULT_LIMIT_SOLUTIONS -1 /** solving stops after this number of solutions */
+#define SCIP_DEFAULT_LIMIT_MEMORY 1e+20 /**< maximal memory usage in MB */
+
+typedef struct {
+    void **handles;       // captured SCIP_VAR or SCIP_CONS pointers
+    PyObject **wrappers;  // Python object for each handle, or NULL
+    bool *borrowed;       // wrapper is a flyweight the registry doesn't own
+    int nwrappers;        // number of entries with wrappers
+    int size;             // number of entries
+    int capacity;         // number of entries allocated
+} py_scip_registry;
+
+typedef struct {
+    void *buf;            // reusable memory for building constraints
+    size_t size;          // bytes allocated
+} py_scip_scratch;
+
+typedef struct {
+    SCIP_Real *vals;      // start values by variable index, NaN if unknown
+    int n;                // number of values in the start, 0 for none
+    int capacity;         // number of values allocated
+    SCIP_Longint nodes;   // node limit for completing partial starts
+} py_scip_warm;
+
+typedef struct {
+    char *name;             // SCIP parameter name, like "limits/nodes"
+    SCIP_PARAMTYPE type;    // which member of value is set
+    union {
+        SCIP_Bool b;
+        int i;
+        SCIP_Longint l;
+        SCIP_Real r;
+        char c;
+        char *s;
+    } value;
+} py_scip_param;
+
+typedef struct {
+    PyObject_HEAD
+    py_scip_param *params;  // compiled parameters, in SCIP's order
+    int nparams;            // number of compiled parameters
+} param_preset;
+
+typedef struct {
+    PyObject_HEAD
+    SCIP **idle;            // initialized instances with empty problems
+    int nidle;              // number of idle instances
+    int capacity;           // number of instances allocated
+    PyObject *params;       // dict or preset for instances handed out, or NULL
+} solver_pool;
+
+typedef struct {
+    bool valid;             // the source problem hasn't been solved since
+    SCIP_STATUS status;     // what the winning worker returned
+    SCIP_Real primal, dual, gap; // its bounds, as the source problem has them
+} py_scip_outcome;
+
+typedef struct {
+    PyObject_HEAD
+    SCIP *scip;
+    solver_pool *pool;      // where scip goes back to, or NULL
+    py_scip_registry vars;  // every variable, by problem index
+    py_scip_registry conss; // every constraint, added or not
+    py_scip_scratch scratch; // temporary space for constraint terms
+    py_scip_warm warm;      // start for the next fresh solve
+    struct py_scip_events *events; // progress callback, or NULL
+    struct py_scip_lazy *lazy; // row generation callback, or NULL
+    struct py_scip_control *control; // limits and interrupts from other threads
+    bool solving;           // SCIPsolve is running without the GIL
+    bool reuse_incumbent;   // replace the start with each new incumbent
+    py_scip_outcome portfolio; // how the last portfolio solve came out
+    PyObject *weakreflist;  // settings and wrappers refer back weakly
+} solver;
 
 typedef struct {
     PyObject_HEAD
     SCIP_VAR *variable;
     SCIP *scip;
+    solver *solv;          // solver holding the variable, NULL once orphaned
+    py_scip_registry *flyweight; // registry borrowing this wrapper, or NULL
     double upper;          // upper bound
     double lower;          // lower bound
-    struct variable *next; // linked list next
+    int index;             // index in the solver's variable registry
 } variable;
 
 typedef struct {
     PyObject_HEAD
     SCIP_CONS *constraint;
     SCIP *scip;
-    SCIP_VAR **linear_vars;  // linear terms
-    SCIP_Real *linear_coef;  // linear coefficients
-    int linear_nvars;        // number of linear terms
-    SCIP_VAR **bilin_var1;   // first bilinear terms
-    SCIP_VAR **bilin_var2;   // second bilinear terms
-    SCIP_Real *bilin_coef;   // bilinear coefficients
-    int bilin_nvars;         // number of bilinear terms
-    struct constraint *next; // linked list next
+    solver *solv;            // solver holding the constraint, NULL once orphaned
+    py_scip_registry *flyweight; // registry borrowing this wrapper, or NULL
+    PyObject *lower;         // lower bound as given, or NULL
+    PyObject *upper;         // upper bound as given, or NULL
+    int index;               // index in the solver's constraint registry
+    bool active;             // currently added to the problem
 } constraint;
 
 typedef struct {
     PyObject_HEAD
     SCIP *scip;
-    variable   *first_var;   // linked list head
-    constraint *first_cons;  // linked list head
-} solver;
+    solver *solv;          // owning solver, which holds the variables
+    int nvars;             // number of variables in the block
+    int start;             // solver index of the first variable
+} variable_block;
+
+typedef struct {
+    PyObject_HEAD
+    SCIP *scip;
+    solver *solv;            // owning solver, which holds the constraints
+    int nconss;              // number of constraints in the block
+    int start;               // solver index of the first constraint
+} constraint_block;
+
+typedef struct {
+    PyObject_HEAD
+    solver *solv;            // solver the variables belong to
+    int *indices;            // solver index of each term's variable
+    SCIP_Real *coefs;        // coefficient of each term, repeats allowed
+    int nterms;              // number of terms
+    int capacity;            // number of terms allocated
+    SCIP_Real constant;      // constant term
+    PyObject *lower;         // lower bound from a comparison, or NULL
+    PyObject *upper;         // upper bound from a comparison, or NULL
+} linear_expr;
+
+// Type objects shared between modules through a capsule
+typedef struct {
+    PyTypeObject *solver;
+    PyTypeObject *variable;
+    PyTypeObject *variable_block;
+    PyTypeObject *constraint;
+    PyTypeObject *constraint_block;
+    PyTypeObject *linear_expr;
+} py_scip_types;
 
 typedef struct {
     PyObject_HEAD
     SCIP_SOL *solution;
     SCIP *scip;
+    solver *solv;     // solver the solution came from
     double objective; // objective value
     bool optimal;     // solution status flags
     bool infeasible;
     bool unbounded;
     bool inforunbd;
+    bool interrupted; // stopped by an interrupt
+    bool memlimit;    // stopped by the memory limit
 } solution;
 
 typedef struct {
     PyObject_HEAD
     SCIP_LPI *lpi;
+    bool solving;     // simplex is running without the GIL
 } lp;
 
 #define PY_SCIP_SETTINGS_TYPE(setting_type, setting_field, struct_name) \
@@ -125,6 +231,7 @@ typedef struct { \
     PyObject_HEAD \
     setting_type *setting_field; \
     SCIP *scip; \
+    PyObject *solver_ref; /* weak reference to the solver */ \
 } struct_name;
   
 PY_SCIP_SETTINGS_TYPE(SCIP_BRANCHRULE, branch, branching_rule);
@@ -0,0 +1,139 @@
+#ifndef PYTHON_ZIBOPT_BUFFER_H
+#define PYTHON_ZIBOPT_BUFFER_H
+
+// Header file for reading and writing buffer protocol arrays.  These let
+// the bulk APIs take NumPy arrays, array.array instances, memoryviews and
+// so on without copying them into Python lists first.
+
+typedef struct {
+    Py_buffer view;  // underlying buffer
+    Py_ssize_t size; // number of elements
+    char format;     // struct module format character
+    bool broadcast;  // no buffer: every element equals value
+    double value;
+} py_scip_array;
+
+// Acquires a one-dimensional, contiguous buffer from obj.  If integral is
+// true then only integer formats are accepted.  Returns 0 on success.
+static int PyScipArrayGet(PyObject *error_type, PyObject *obj, py_scip_array *a,
+    const char *name, bool integral, bool writable) {
+
+    const char *f;
+    int flags = PyBUF_FORMAT | PyBUF_C_CONTIGUOUS;
+    if (writable)
+        flags |= PyBUF_WRITABLE;
+
+    memset(a, 0, sizeof(py_scip_array));
+
+    if (PyObject_GetBuffer(obj, &a->view, flags) < 0) {
+        PyErr_Clear();
+        PyErr_Format(error_type, "%s must be a contiguous %sarray", name, writable ? "writable " : "");
+        return -1;
+    }
+
+    if (a->view.ndim > 1) {
+        PyBuffer_Release(&a->view);
+        PyErr_Format(error_type, "%s must be one-dimensional", name);
+        return -1;
+    }
+
+    // Only native byte order is supported, which is all NumPy and the
+    // array module produce by default.
+    f = a->view.format ? a->view.format : "B";
+    if (*f == '@' || *f == '=')
+        f++;
+    a->format = f[0];
+
+    switch (a->format) {
+        case '?': case 'b': case 'B': case 'h': case 'H': case 'i': case 'I':
+        case 'l': case 'L': case 'q': case 'Q': case 'n': case 'N':
+            break;
+        case 'f': case 'd':
+            if (!integral)
+                break;
+            // fall through
+        default:
+            PyBuffer_Release(&a->view);
+            PyErr_Format(error_type, "%s has an unsupported element type", name);
+            return -1;
+    }
+
+    if (f[1] != '\0') {
+        PyBuffer_Release(&a->view);
+        PyErr_Format(error_type, "%s has an unsupported element type", name);
+        return -1;
+    }
+
+    a->size = a->view.itemsize ? a->view.len / a->view.itemsize : 0;
+    return 0;
+}
+
+// Acquires an array of size numbers.  None means every element takes the
+// default value, and a single number is used for every element.
+static int PyScipArrayGetReals(PyObject *error_type, PyObject *obj, py_scip_array *a,
+    const char *name, Py_ssize_t size, double default_value) {
+
+    if (obj == NULL || obj == Py_None || PyFloat_Check(obj) || PyLong_Check(obj)) {
+        memset(a, 0, sizeof(py_scip_array));
+        a->broadcast = true;
+        a->size = size;
+        a->value = (obj == NULL || obj == Py_None) ? default_value : PyFloat_AsDouble(obj);
+        return 0;
+    }
+
+    if (PyScipArrayGet(error_type, obj, a, name, false, false))
+        return -1;
+
+    if (a->size != size) {
+        PyBuffer_Release(&a->view);
+        PyErr_Format(error_type, "%s must have %zd elements", name, size);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void PyScipArrayRelease(py_scip_array *a) {
+    if (a->view.obj != NULL)
+        PyBuffer_Release(&a->view);
+}
+
+// Reads element i as an integer
+static Py_ssize_t PyScipArrayIndex(py_scip_array *a, Py_ssize_t i) {
+    switch (a->format) {
+        case '?': return ((unsigned char *) a->view.buf)[i] != 0;
+        case 'b': return ((signed char *) a->view.buf)[i];
+        case 'B': return ((unsigned char *) a->view.buf)[i];
+        case 'h': return ((short *) a->view.buf)[i];
+        case 'H': return ((unsigned short *) a->view.buf)[i];
+        case 'i': return ((int *) a->view.buf)[i];
+        case 'I': return ((unsigned int *) a->view.buf)[i];
+        case 'l': return ((long *) a->view.buf)[i];
+        case 'L': return ((unsigned long *) a->view.buf)[i];
+        case 'q': return ((PY_LONG_LONG *) a->view.buf)[i];
+        case 'Q': return ((unsigned PY_LONG_LONG *) a->view.buf)[i];
+        case 'n': return ((Py_ssize_t *) a->view.buf)[i];
+        case 'N': return ((size_t *) a->view.buf)[i];
+    }
+    return 0;
+}
+
+// Reads element i as a double
+static double PyScipArrayReal(py_scip_array *a, Py_ssize_t i) {
+    if (a->broadcast)
+        return a->value;
+    switch (a->format) {
+        case 'd': return ((double *) a->view.buf)[i];
+        case 'f': return ((float *) a->view.buf)[i];
+    }
+    return (double) PyScipArrayIndex(a, i);
+}
+
+// Returns the buffer itself if it already holds SCIP_Reals, else NULL
+static SCIP_Real *PyScipArrayReals(py_scip_array *a) {
+    if (!a->broadcast && a->format == 'd' && a->view.itemsize == sizeof(SCIP_Real))
+        return (SCIP_Real *) a->view.buf;
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,375 @@
+#ifndef PYTHON_ZIBOPT_CONTROL_H
+#define PYTHON_ZIBOPT_CONTROL_H
+
+// Header file for steering a solve from other threads.  SCIP reads its
+// limits from set->limit_* whenever it checks whether to stop, so they
+// can't be written from outside the solving thread.  Instead new limits
+// wait here under a C lock, and an event handler on the solving thread
+// copies them in after every LP and node.  Interrupts set the flag SCIP's
+// own ctrl-c handling uses, which SCIP only ever reads, so they take
+// effect even during presolving, where there are no events.  The handler
+// also samples block memory use, since SCIP's memory counters can't be
+// walked safely from other threads either, and copies reduced costs off
+// the final root LP once the root node is done, since SCIP only hands
+// those out while it is solving.  SCIP keeps no history of its bounds,
+// so the handler also records them whenever either one improves.
+// Portfolio workers solve on the source solver's behalf, so interrupts
+// reach them as well, and their own event handlers pick up new limits.
+
+#include "python_zibopt_error.h"
+
+#define PY_SCIP_CONTROL_NAME "python-zibopt-control"
+#define PY_SCIP_CONTROL_TYPES (SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_LPSOLVED | SCIP_EVENTTYPE_NODESOLVED)
+
+typedef struct {
+    SCIP_Real time;           // solving time when the bounds changed
+    SCIP_Longint node;        // nodes solved by then
+    SCIP_Real primal, dual;   // bounds, as the user's objective sees them
+} py_scip_bounds;
+
+typedef struct py_scip_control {
+    PyThread_type_lock lock;  // guards everything below
+    bool running;             // SCIPsolve is running
+    bool busy;                // SCIP is in use without the GIL, but not solving
+    bool pending;             // limits below haven't been applied yet
+    bool interrupt;           // stop solving as soon as possible
+    double time, gap, absgap; // limits for the running solve
+    double memory;            // memory limit in MB
+    int nsol;
+    int version;              // bumped whenever the limits above change
+    SCIP **workers;           // instances solving on the solver's behalf
+    int nworkers;             // number of workers, 0 for a plain solve
+    SCIP_Longint memused;     // block memory in use at the last event
+    SCIP_Real *redcosts;      // root LP reduced costs by variable index
+    int nredcosts;            // number of reduced costs, 0 for none
+    int redcapacity;          // number of reduced costs allocated
+    py_scip_bounds *history;  // bounds every time one of them improved
+    int nhistory;             // number of entries in history
+    int histcapacity;         // number of entries allocated
+} py_scip_control;
+
+/*****************************************************************************/
+/* SCIP SIDE: runs on the solving thread, without the GIL                    */
+/*****************************************************************************/
+static SCIP_DECL_EVENTINITSOL(_control_initsol) {
+    SCIP_CALL( SCIPcatchEvent(scip, PY_SCIP_CONTROL_TYPES, eventhdlr, NULL, NULL) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXITSOL(_control_exitsol) {
+    SCIP_CALL( SCIPdropEvent(scip, PY_SCIP_CONTROL_TYPES, eventhdlr, NULL, -1) );
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE _control_redcosts(py_scip_control *c, SCIP *scip) {
+    // Copies reduced costs of the final root LP, by original
+    // variable index.  Like duals, they use the objective sense so they
+    // look as expected when maximizing.  Called with the lock held.
+    SCIP_VAR **vars, *transformed;
+    SCIP_Real *redcosts;
+    int i, nvars;
+
+    vars = SCIPgetOrigVars(scip);
+    nvars = SCIPgetNOrigVars(scip);
+    if (nvars > c->redcapacity) {
+        if ((redcosts = realloc(c->redcosts, nvars * sizeof(SCIP_Real))) == NULL)
+            return SCIP_NOMEMORY;
+        c->redcosts = redcosts;
+        c->redcapacity = nvars;
+    }
+
+    for (i = 0; i < nvars; i++) {
+        SCIP_CALL( SCIPgetTransformedVar(scip, vars[i], &transformed) );
+        c->redcosts[i] = transformed == NULL ? 0.0 :
+            SCIPgetObjsense(scip) * SCIPgetVarRedcost(scip, transformed);
+    }
+    c->nredcosts = nvars;
+    return SCIP_OKAY;
+}
+
+static SCIP_RETCODE _control_record(py_scip_control *c, SCIP *scip) {
+    // Adds the current bounds to the history if either one moved since
+    // the last entry.  Called with the lock held.
+    py_scip_bounds *history;
+    SCIP_Real primal = SCIPgetPrimalbound(scip);
+    SCIP_Real dual = SCIPgetDualbound(scip);
+    int capacity;
+
+    if (c->nhistory > 0 && c->history[c->nhistory-1].primal == primal && c->history[c->nhistory-1].dual == dual)
+        return SCIP_OKAY;
+
+    if (c->nhistory == c->histcapacity) {
+        capacity = c->histcapacity > 0 ? 2 * c->histcapacity : 16;
+        if ((history = realloc(c->history, capacity * sizeof(py_scip_bounds))) == NULL)
+            return SCIP_NOMEMORY;
+        c->history = history;
+        c->histcapacity = capacity;
+    }
+
+    history = &c->history[c->nhistory++];
+    history->time = SCIPgetSolvingTime(scip);
+    history->node = SCIPgetNNodes(scip);
+    history->primal = primal;
+    history->dual = dual;
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXEC(_control_exec) {
+    py_scip_control *c = (py_scip_control *) SCIPeventhdlrGetData(eventhdlr);
+    SCIP_RETCODE retcode;
+    bool interrupt;
+
+    // Pooled instances keep the handler between solvers
+    if (c == NULL)
+        return SCIP_OKAY;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    if (c->pending) {
+        scip->set->limit_time   = c->time;
+        scip->set->limit_gap    = c->gap;
+        scip->set->limit_absgap = c->absgap;
+        scip->set->limit_solutions = c->nsol;
+        scip->set->limit_memory = c->memory;
+        c->pending = false;
+    }
+    interrupt = c->interrupt;
+    c->memused = SCIPgetMemUsed(scip);
+    if (SCIPeventGetType(event) == SCIP_EVENTTYPE_NODESOLVED && SCIPgetDepth(scip) == 0 &&
+        SCIPgetLPSolstat(scip) == SCIP_LPSOLSTAT_OPTIMAL && _control_redcosts(c, scip) != SCIP_OKAY)
+        c->nredcosts = 0;
+    retcode = _control_record(c, scip);
+    PyThread_release_lock(c->lock);
+    SCIP_CALL( retcode );
+
+    // SCIPsolve clears the flag as it starts, which can race the interrupt
+    if (interrupt)
+        SCIP_CALL( SCIPinterruptSolve(scip) );
+    return SCIP_OKAY;
+}
+
+/*****************************************************************************/
+/* PYTHON SIDE                                                               */
+/*****************************************************************************/
+static py_scip_control *PyScipControlNew(PyObject *error_type) {
+    py_scip_control *c = calloc(1, sizeof(py_scip_control));
+    if (c == NULL || (c->lock = PyThread_allocate_lock()) == NULL) {
+        if (c != NULL) free(c);
+        PyErr_SetString(error_type, "ran out of memory");
+        return NULL;
+    }
+    return c;
+}
+
+static void PyScipControlFree(py_scip_control *c) {
+    if (c->redcosts != NULL) free(c->redcosts);
+    if (c->history != NULL) free(c->history);
+    PyThread_free_lock(c->lock);
+    free(c);
+}
+
+// Points the SCIP instance's handler at c, including the handler the first
+// time.  Must be called before the problem is transformed.  c may be NULL
+// to detach.  Returns 0 on success.
+static int PyScipControlAttach(PyObject *error_type, SCIP *scip, py_scip_control *c) {
+    SCIP_EVENTHDLR *eventhdlr = SCIPfindEventhdlr(scip, PY_SCIP_CONTROL_NAME);
+
+    if (eventhdlr != NULL) {
+        SCIPeventhdlrSetData(eventhdlr, (SCIP_EVENTHDLRDATA *) c);
+    } else if (c != NULL) {
+        // See _portfolio_worker_init in scipmodule.c for arguments
+        PY_SCIP_CALL(error_type, -1,
+            SCIPincludeEventhdlr(scip, PY_SCIP_CONTROL_NAME, "applies limits and interrupts from other threads",
+                NULL, NULL, NULL, NULL, _control_initsol, _control_exitsol, NULL, _control_exec,
+                (SCIP_EVENTHDLRDATA *) c)
+        );
+    }
+    return 0;
+}
+
+// Call right before SCIPsolve, once the limits are set
+static void PyScipControlStart(py_scip_control *c, SCIP *scip) {
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    c->running = true;
+    c->pending = false;
+    c->interrupt = false;
+    c->time = scip->set->limit_time;
+    c->gap = scip->set->limit_gap;
+    c->absgap = scip->set->limit_absgap;
+    c->nsol = scip->set->limit_solutions;
+    c->memory = scip->set->limit_memory;
+    c->version = 0;
+    c->memused = SCIPgetMemUsed(scip);
+
+    // Solves that go on from where the last one stopped keep its root,
+    // and its history
+    if (SCIPgetStage(scip) < SCIP_STAGE_PRESOLVING) {
+        c->nredcosts = 0;
+        c->nhistory = 0;
+    }
+    PyThread_release_lock(c->lock);
+}
+
+// Call right before SCIP goes off without the GIL for anything but a
+// solve, like reading a problem.  Memory reads get what it used before.
+// There is nothing to interrupt, so interrupts and limits are ignored.
+static void PyScipControlBusy(py_scip_control *c, SCIP *scip) {
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    c->busy = true;
+    c->memused = SCIPgetMemUsed(scip);
+    PyThread_release_lock(c->lock);
+}
+
+// Call right after PyScipControlStart when other instances solve on the
+// solver's behalf, like portfolio workers.  They have to stay around until
+// PyScipControlStop, and pick up new limits with PyScipControlWorker.
+static void PyScipControlShare(py_scip_control *c, SCIP **workers, int nworkers) {
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    c->workers = workers;
+    c->nworkers = nworkers;
+    PyThread_release_lock(c->lock);
+}
+
+// Call right after SCIPsolve, after every worker is done, or once SCIP is
+// back from whatever PyScipControlBusy was for
+static void PyScipControlStop(py_scip_control *c) {
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    c->running = false;
+    c->busy = false;
+    c->interrupt = false;
+    c->workers = NULL;
+    c->nworkers = 0;
+    PyThread_release_lock(c->lock);
+}
+
+// Call on a worker's own thread, from its event handler.  version is the
+// last limits version the worker applied, 0 at first.  Workers take the
+// whole set, so new limits also replace any their profile had.
+static SCIP_RETCODE PyScipControlWorker(py_scip_control *c, SCIP *scip, int *version) {
+    bool interrupt;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    if (*version != c->version) {
+        scip->set->limit_time   = c->time;
+        scip->set->limit_gap    = c->gap;
+        scip->set->limit_absgap = c->absgap;
+        scip->set->limit_solutions = c->nsol;
+        scip->set->limit_memory = c->memory;
+        *version = c->version;
+    }
+    interrupt = c->interrupt;
+    PyThread_release_lock(c->lock);
+
+    if (interrupt)
+        SCIP_CALL( SCIPinterruptSolve(scip) );
+    return SCIP_OKAY;
+}
+
+// Call on a worker's own thread once it stops.  Returns whether a limit
+// of the whole solve stopped it, rather than one from its own profile.
+static bool PyScipControlShared(py_scip_control *c, SCIP *scip) {
+    bool shared;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    switch (SCIPgetStatus(scip)) {
+    case SCIP_STATUS_TIMELIMIT:
+        shared = scip->set->limit_time == c->time;
+        break;
+    case SCIP_STATUS_MEMLIMIT:
+        shared = scip->set->limit_memory == c->memory;
+        break;
+    case SCIP_STATUS_SOLLIMIT:
+        shared = scip->set->limit_solutions == c->nsol;
+        break;
+    default:
+        shared = false;
+    }
+    PyThread_release_lock(c->lock);
+    return shared;
+}
+
+// Asks a running solve to stop.  Returns whether one was running.
+static bool PyScipControlInterrupt(py_scip_control *c, SCIP *scip) {
+    bool running;
+    int i;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    running = c->running;
+    if (running) {
+        c->interrupt = true;
+        scip->stat->userinterrupt = TRUE;
+        for (i = 0; i < c->nworkers; i++)
+            c->workers[i]->stat->userinterrupt = TRUE;
+    }
+    PyThread_release_lock(c->lock);
+    return running;
+}
+
+// Replaces limits of a running solve.  NULL arguments keep their limit.
+// Returns whether a solve was running.
+static bool PyScipControlLimits(py_scip_control *c, const double *time, const double *gap,
+    const double *absgap, const int *nsol, const double *memory) {
+
+    bool running;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    running = c->running;
+    if (running) {
+        if (time != NULL) c->time = *time;
+        if (gap != NULL) c->gap = *gap;
+        if (absgap != NULL) c->absgap = *absgap;
+        if (nsol != NULL) c->nsol = *nsol;
+        if (memory != NULL) c->memory = *memory;
+        c->pending = true;
+        c->version++;
+    }
+    PyThread_release_lock(c->lock);
+    return running;
+}
+
+// Copies root LP reduced costs of n variables from index start on into
+// out.  Variables added since then get 0.  Returns false if there are none.
+static bool PyScipControlRedcosts(py_scip_control *c, int start, int n, SCIP_Real *out) {
+    bool found;
+    int i;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    found = c->nredcosts > 0;
+    for (i = 0; found && i < n; i++)
+        out[i] = start + i < c->nredcosts ? c->redcosts[start + i] : 0.0;
+    PyThread_release_lock(c->lock);
+    return found;
+}
+
+// Returns a list of (time, node, primal, dual) tuples, one for each time a
+// bound improved during the last solve, or NULL with an exception set
+static PyObject *PyScipControlHistory(py_scip_control *c) {
+    PyObject *history, *o;
+    int i;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    history = PyList_New(c->nhistory);
+    for (i = 0; history != NULL && i < c->nhistory; i++) {
+        o = Py_BuildValue("(dLdd)", c->history[i].time, (PY_LONG_LONG) c->history[i].node,
+            c->history[i].primal, c->history[i].dual);
+        if (o == NULL)
+            Py_CLEAR(history);
+        else
+            PyList_SET_ITEM(history, i, o);
+    }
+    PyThread_release_lock(c->lock);
+    return history;
+}
+
+// Reads the block memory in use, as of the last LP or node if a solve is
+// running, or as of the start of anything else SCIP is busy with.  SCIP's
+// own count is only safe to read while idle.
+static SCIP_Longint PyScipControlMemory(py_scip_control *c, SCIP *scip) {
+    SCIP_Longint used;
+
+    PyThread_acquire_lock(c->lock, WAIT_LOCK);
+    used = c->running || c->busy ? c->memused : SCIPgetMemUsed(scip);
+    PyThread_release_lock(c->lock);
+    return used;
+}
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef PYTHON_ZIBOPT_EVENTS_H
+#define PYTHON_ZIBOPT_EVENTS_H
+
+// Header file for streaming solver progress to a Python callback.  An
+// event handler copies each new incumbent, and every nth solved node, into
+// a queue of compact snapshots.  That only takes a short C lock.  A
+// delivery thread takes the GIL and hands snapshots to the callback in
+// batches, so SCIP never waits on Python.
+
+#include "python_zibopt_threads.h"
+
+#define PY_SCIP_EVENTS_NAME "python-zibopt-events"
+#define PY_SCIP_EVENTS_TYPES (SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED)
+
+// Snapshot records are stored back to back as doubles:
+// kind, objective, dual bound, nodes, time, then nvalues solution values
+#define PY_SCIP_SNAPSHOT_INCUMBENT 0
+#define PY_SCIP_SNAPSHOT_NODE      1
+#define PY_SCIP_SNAPSHOT_HEADER    6
+
+typedef struct {
+    double *records;          // snapshots, back to back
+    size_t size;              // doubles used
+    size_t capacity;          // doubles allocated
+} py_scip_snapshots;
+
+typedef struct py_scip_events {
+    PyObject *callback;       // called with lists of snapshot tuples
+    int batch;                // snapshots to queue before delivering
+    int nodes;                // report every nth node, or 0 for none
+    bool active;              // callback is set.  Changed only when idle.
+
+    PyThread_type_lock lock;  // guards everything below
+    py_scip_snapshots queue;  // filled from SCIP
+    py_scip_snapshots spare;  // drained by the delivery thread
+    int count;                // snapshots in queue
+    bool signaled;            // wakeup has been released
+    bool stopping;            // SCIPsolve has returned
+    bool interrupt;           // the callback failed, so stop solving
+
+    PyThread_type_lock wakeup; // released when there is work
+    py_scip_thread thread;     // delivery thread, while solving
+    PyObject *exc_type, *exc_value, *exc_tb; // first callback error
+} py_scip_events;
+
+/*****************************************************************************/
+/* SCIP SIDE: runs on the solving thread, without the GIL                    */
+/*****************************************************************************/
+static void _events_signal(py_scip_events *ev) {
+    // Must hold ev->lock
+    if (!ev->signaled) {
+        ev->signaled = true;
+        PyThread_release_lock(ev->wakeup);
+    }
+}
+
+static double *_events_reserve(py_scip_snapshots *s, size_t n) {
+    // Must hold ev->lock.  Returns room for n more doubles, or NULL.
+    double *records;
+    size_t capacity;
+
+    if (s->size + n > s->capacity) {
+        capacity = s->capacity > 0 ? s->capacity : 1024;
+        while (capacity < s->size + n)
+            capacity *= 2;
+        records = realloc(s->records, capacity * sizeof(double));
+        if (records == NULL)
+            return NULL;
+        s->records = records;
+        s->capacity = capacity;
+    }
+
+    s->size += n;
+    return s->records + s->size - n;
+}
+
+static SCIP_DECL_EVENTINITSOL(_events_initsol) {
+    SCIP_CALL( SCIPcatchEvent(scip, PY_SCIP_EVENTS_TYPES, eventhdlr, NULL, NULL) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXITSOL(_events_exitsol) {
+    SCIP_CALL( SCIPdropEvent(scip, PY_SCIP_EVENTS_TYPES, eventhdlr, NULL, -1) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXEC(_events_exec) {
+    py_scip_events *ev = (py_scip_events *) SCIPeventhdlrGetData(eventhdlr);
+    SCIP_SOL *sol = NULL;
+    SCIP_Longint nnodes;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    bool interrupt;
+    double *r;
+    int nvalues = 0;
+
+    // Instances from a solver pool keep the handler after their solver
+    // is gone.  It does nothing until another solver sets a callback.
+    if (ev == NULL || !ev->active)
+        return SCIP_OKAY;
+
+    nnodes = SCIPgetNNodes(scip);
+    if (SCIPeventGetType(event) == SCIP_EVENTTYPE_BESTSOLFOUND) {
+        sol = SCIPgetBestSol(scip);
+        nvalues = SCIPgetNOrigVars(scip);
+    } else if (ev->nodes <= 0 || nnodes % ev->nodes != 0) {
+        return SCIP_OKAY;
+    }
+
+    PyThread_acquire_lock(ev->lock, WAIT_LOCK);
+    interrupt = ev->interrupt;
+    if (!interrupt) {
+        // Snapshots that don't fit in memory are dropped.  The solve matters more.
+        r = _events_reserve(&ev->queue, PY_SCIP_SNAPSHOT_HEADER + nvalues);
+        if (r != NULL) {
+            // Objective values are reported like solution_init does.  Node
+            // snapshots carry the best objective so far.
+            r[0] = sol != NULL ? PY_SCIP_SNAPSHOT_INCUMBENT : PY_SCIP_SNAPSHOT_NODE;
+            r[1] = (sol != NULL ? SCIPgetSolOrigObj(scip, sol) : SCIPgetPrimalbound(scip)) + scip->origprob->objoffset;
+            r[2] = SCIPgetDualbound(scip) + scip->origprob->objoffset;
+            r[3] = (double) nnodes;
+            r[4] = SCIPgetSolvingTime(scip);
+            r[5] = nvalues;
+            if (nvalues > 0)
+                retcode = SCIPgetSolVals(scip, sol, nvalues, SCIPgetOrigVars(scip), r + PY_SCIP_SNAPSHOT_HEADER);
+
+            if (retcode == SCIP_OKAY) {
+                if (++ev->count >= ev->batch)
+                    _events_signal(ev);
+            } else {
+                ev->queue.size -= PY_SCIP_SNAPSHOT_HEADER + nvalues;
+            }
+        }
+    }
+    PyThread_release_lock(ev->lock);
+
+    if (interrupt)
+        SCIP_CALL( SCIPinterruptSolve(scip) );
+    return retcode;
+}
+
+/*****************************************************************************/
+/* PYTHON SIDE                                                               */
+/*****************************************************************************/
+static void _events_deliver(py_scip_events *ev, py_scip_snapshots *s) {
+    // Must hold the GIL.  Hands every snapshot in s to the callback and
+    // empties it.  The first error is kept and stops further deliveries.
+    PyObject *list, *item, *values, *result;
+    double *r;
+    size_t pos;
+    int nvalues;
+
+    if (s->size == 0 || ev->exc_type != NULL)
+        goto done;
+
+    list = PyList_New(0);
+    if (list == NULL)
+        goto error;
+
+    for (pos = 0; pos < s->size; pos += PY_SCIP_SNAPSHOT_HEADER + nvalues) {
+        r = s->records + pos;
+        nvalues = (int) r[5];
+
+        if (r[0] == PY_SCIP_SNAPSHOT_INCUMBENT) {
+            values = PyBytes_FromStringAndSize((char *) (r + PY_SCIP_SNAPSHOT_HEADER), nvalues * sizeof(double));
+            if (values == NULL) {
+                Py_DECREF(list);
+                goto error;
+            }
+        } else {
+            Py_INCREF(Py_None);
+            values = Py_None;
+        }
+
+        item = Py_BuildValue("(sddddN)",
+            r[0] == PY_SCIP_SNAPSHOT_INCUMBENT ? "incumbent" : "node", r[1], r[2], r[3], r[4], values);
+        if (item == NULL || PyList_Append(list, item) < 0) {
+            Py_XDECREF(item);
+            Py_DECREF(list);
+            goto error;
+        }
+        Py_DECREF(item);
+    }
+
+    result = PyObject_CallFunctionObjArgs(ev->callback, list, NULL);
+    Py_DECREF(list);
+    if (result == NULL)
+        goto error;
+    Py_DECREF(result);
+    goto done;
+
+error:
+    PyErr_Fetch(&ev->exc_type, &ev->exc_value, &ev->exc_tb);
+    PyThread_acquire_lock(ev->lock, WAIT_LOCK);
+    ev->interrupt = true;
+    PyThread_release_lock(ev->lock);
+
+done:
+    s->size = 0;
+}
+
+static void _events_run(void *arg) {
+    // Delivery thread body.  Sleeps until there's work, then swaps the
+    // queue out so SCIP can keep filling the other one.
+    py_scip_events *ev = (py_scip_events *) arg;
+    py_scip_snapshots swap;
+    bool stopping;
+
+    do {
+        PyThread_acquire_lock(ev->wakeup, WAIT_LOCK);
+
+        PyThread_acquire_lock(ev->lock, WAIT_LOCK);
+        swap = ev->spare;
+        ev->spare = ev->queue;
+        ev->queue = swap;
+        ev->count = 0;
+        ev->signaled = false;
+        stopping = ev->stopping;
+        PyThread_release_lock(ev->lock);
+
+        if (ev->spare.size > 0) {
+            PY_SCIP_ENTER_PYTHON();
+            _events_deliver(ev, &ev->spare);
+            PY_SCIP_LEAVE_PYTHON();
+        }
+    } while (!stopping);
+}
+
+static py_scip_events *PyScipEventsNew(PyObject *error_type) {
+    py_scip_events *ev = calloc(1, sizeof(py_scip_events));
+    if (ev == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return NULL;
+    }
+
+    ev->lock = PyThread_allocate_lock();
+    ev->wakeup = PyThread_allocate_lock();
+    if (ev->lock == NULL || ev->wakeup == NULL || PyScipThreadInit(error_type, &ev->thread)) {
+        if (ev->lock != NULL) PyThread_free_lock(ev->lock);
+        if (ev->wakeup != NULL) PyThread_free_lock(ev->wakeup);
+        free(ev);
+        PyErr_SetString(error_type, "ran out of memory");
+        return NULL;
+    }
+
+    // The wakeup lock is held whenever there is nothing to deliver
+    PyThread_acquire_lock(ev->wakeup, WAIT_LOCK);
+    return ev;
+}
+
+static void PyScipEventsFree(py_scip_events *ev) {
+    Py_XDECREF(ev->callback);
+    Py_XDECREF(ev->exc_type);
+    Py_XDECREF(ev->exc_value);
+    Py_XDECREF(ev->exc_tb);
+    PyThread_free_lock(ev->wakeup);
+    PyThread_free_lock(ev->lock);
+    PyScipThreadFree(&ev->thread);
+    if (ev->queue.records != NULL) free(ev->queue.records);
+    if (ev->spare.records != NULL) free(ev->spare.records);
+    free(ev);
+}
+
+// Points the SCIP instance's event handler at ev, including the handler
+// the first time.  ev may be NULL to detach.  Returns 0 on success.
+static int PyScipEventsAttach(PyObject *error_type, SCIP *scip, py_scip_events *ev) {
+    SCIP_EVENTHDLR *eventhdlr = SCIPfindEventhdlr(scip, PY_SCIP_EVENTS_NAME);
+
+    if (eventhdlr != NULL) {
+        SCIPeventhdlrSetData(eventhdlr, (SCIP_EVENTHDLRDATA *) ev);
+    } else if (ev != NULL) {
+        // See _portfolio_worker_init in scipmodule.c for arguments
+        PY_SCIP_CALL(error_type, -1,
+            SCIPincludeEventhdlr(scip, PY_SCIP_EVENTS_NAME, "delivers progress to Python callbacks",
+                NULL, NULL, NULL, NULL, _events_initsol, _events_exitsol, NULL, _events_exec,
+                (SCIP_EVENTHDLRDATA *) ev)
+        );
+    }
+    return 0;
+}
+
+// Call with the GIL, right before SCIPsolve.  Starts the delivery thread.
+static int PyScipEventsStart(PyObject *error_type, py_scip_events *ev) {
+    if (ev == NULL || !ev->active)
+        return 0;
+
+    ev->stopping = false;
+    ev->interrupt = false;
+    if (PyScipThreadStart(&ev->thread, _events_run, ev)) {
+        PyErr_SetString(error_type, "could not start callback thread");
+        return -1;
+    }
+    return 0;
+}
+
+// Call without the GIL, right after SCIPsolve.  Delivers what's left and
+// waits for the delivery thread to finish.
+static void PyScipEventsStop(py_scip_events *ev) {
+    if (ev == NULL || !ev->active)
+        return;
+
+    PyThread_acquire_lock(ev->lock, WAIT_LOCK);
+    ev->stopping = true;
+    _events_signal(ev);
+    PyThread_release_lock(ev->lock);
+
+    PyScipThreadJoin(&ev->thread);
+}
+
+// Call with the GIL after PyScipEventsStop.  Raises the first callback
+// error, if there was one.  Returns 0 if there wasn't.
+static int PyScipEventsFinish(py_scip_events *ev) {
+    if (ev == NULL || ev->exc_type == NULL)
+        return 0;
+
+    PyErr_Restore(ev->exc_type, ev->exc_value, ev->exc_tb);
+    ev->exc_type = ev->exc_value = ev->exc_tb = NULL;
+    return -1;
+}
+
+#endif
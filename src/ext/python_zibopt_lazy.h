@@ -0,0 +1,382 @@
+#ifndef PYTHON_ZIBOPT_LAZY_H
+#define PYTHON_ZIBOPT_LAZY_H
+
+#include "python_zibopt_buffer.h"
+#include "python_zibopt_scratch.h"
+
+// Header file for generating rows from Python during the search.  A
+// constraint handler hands candidate solutions to a Python callback, which
+// returns violated linear rows in CSR format.  Those go into the LP and the
+// global cut pool, so solving carries on instead of starting over.  The
+// callback runs on the solving thread and holds the GIL while it runs.
+
+#define PY_SCIP_LAZY_NAME "python-zibopt-lazy"
+
+typedef struct py_scip_lazy {
+    PyObject *callback;       // called with (values, integral), returns rows
+    PyObject *error_type;     // module error for malformed rows
+    bool fractional;          // also called on fractional LP solutions
+    SCIP_CONS *cons;          // constraint that turns the handler on
+    py_scip_scratch scratch;  // space for building one row
+    PyObject *exc_type, *exc_value, *exc_tb; // first callback error
+} py_scip_lazy;
+
+/*****************************************************************************/
+/* ROW GENERATION: runs on the solving thread                                */
+/*****************************************************************************/
+static int _lazy_add_rows(SCIP *scip, py_scip_lazy *lazy, SCIP_SOL *sol, PyObject *rows,
+    SCIP_Real *vals, int nvals, bool add, int *nviolated) {
+
+    // Must hold the GIL.  Counts the violated rows and adds them as cuts
+    // if add is true.  Returns -1 with a Python error set if the rows are
+    // malformed or SCIP won't take them.
+    PyObject *indptr_obj, *indices_obj, *data_obj, *lower_obj, *upper_obj;
+    py_scip_array indptr, indices, data, lower, upper;
+    SCIP_VAR **vars, **row_vars, **trans_vars;
+    SCIP_Real *row_coef, lhs, rhs, activity, inf;
+    SCIP_ROW *row;
+    Py_ssize_t nrows, r, k, beg, end, maxlen, j;
+    SCIP_RETCODE retcode;
+    int result = -1;
+
+    if (!PyTuple_Check(rows) || !PyArg_ParseTuple(rows, "OOOOO", &indptr_obj, &indices_obj, &data_obj, &lower_obj, &upper_obj)) {
+        PyErr_Clear();
+        PyErr_SetString(lazy->error_type, "rows must be None or (indptr, indices, data, lower, upper)");
+        return -1;
+    }
+
+    if (PyScipArrayGet(lazy->error_type, indptr_obj, &indptr, "indptr", true, false))
+        return -1;
+    if (PyScipArrayGet(lazy->error_type, indices_obj, &indices, "indices", true, false)) {
+        PyScipArrayRelease(&indptr);
+        return -1;
+    }
+    if (PyScipArrayGet(lazy->error_type, data_obj, &data, "data", false, false)) {
+        PyScipArrayRelease(&indptr);
+        PyScipArrayRelease(&indices);
+        return -1;
+    }
+
+    inf = SCIPinfinity(scip);
+    nrows = indptr.size - 1;
+    memset(&lower, 0, sizeof(py_scip_array));
+    memset(&upper, 0, sizeof(py_scip_array));
+
+    if (nrows < 0) {
+        PyErr_SetString(lazy->error_type, "indptr must have at least one element");
+        goto cleanup;
+    }
+    if (indices.size != data.size) {
+        PyErr_SetString(lazy->error_type, "indices and data must be the same length");
+        goto cleanup;
+    }
+    if (PyScipArrayGetReals(lazy->error_type, lower_obj, &lower, "lower", nrows, -inf) ||
+        PyScipArrayGetReals(lazy->error_type, upper_obj, &upper, "upper", nrows, inf))
+        goto cleanup;
+
+    // Check everything before SCIP sees any of it
+    maxlen = 0;
+    for (r = 0; r < nrows; r++) {
+        beg = PyScipArrayIndex(&indptr, r);
+        end = PyScipArrayIndex(&indptr, r+1);
+        if (beg < 0 || end < beg || end > indices.size) {
+            PyErr_SetString(lazy->error_type, "indptr must be nondecreasing and within indices");
+            goto cleanup;
+        }
+        if (end - beg > maxlen)
+            maxlen = end - beg;
+    }
+    for (k = 0; k < indices.size; k++) {
+        j = PyScipArrayIndex(&indices, k);
+        if (j < 0 || j >= nvals) {
+            PyErr_SetString(lazy->error_type, "variable index out of range");
+            goto cleanup;
+        }
+    }
+
+    row_coef = (SCIP_Real *) PyScipScratchGet(lazy->error_type, &lazy->scratch,
+        maxlen * (sizeof(SCIP_Real) + 2 * sizeof(SCIP_VAR *)));
+    if (row_coef == NULL)
+        goto cleanup;
+    row_vars = (SCIP_VAR **) (row_coef + maxlen);
+    trans_vars = row_vars + maxlen;
+
+    vars = SCIPgetOrigVars(scip);
+    result = 0;
+    for (r = 0; r < nrows; r++) {
+        beg = PyScipArrayIndex(&indptr, r);
+        end = PyScipArrayIndex(&indptr, r+1);
+
+        activity = 0;
+        for (k = beg; k < end; k++) {
+            j = PyScipArrayIndex(&indices, k);
+            row_vars[k-beg] = vars[j];
+            row_coef[k-beg] = PyScipArrayReal(&data, k);
+            activity += row_coef[k-beg] * vals[j];
+        }
+
+        lhs = PyScipArrayReal(&lower, r);
+        rhs = PyScipArrayReal(&upper, r);
+        if (lhs < -inf) lhs = -inf;
+        if (rhs > inf)  rhs = inf;
+
+        // Rows the solution already satisfies don't help
+        if (!SCIPisFeasLT(scip, activity, lhs) && !SCIPisFeasGT(scip, activity, rhs))
+            continue;
+        (*nviolated)++;
+        if (!add)
+            continue;
+
+        // Rows are globally valid and removable from the LP.  The pool
+        // brings them back wherever they are violated again.
+        if ((retcode = SCIPgetTransformedVars(scip, (int) (end - beg), row_vars, trans_vars)) != SCIP_OKAY ||
+            (retcode = SCIPcreateEmptyRow(scip, &row, PY_SCIP_LAZY_NAME, lhs, rhs, FALSE, FALSE, TRUE)) != SCIP_OKAY) {
+            PyScipSetError(lazy->error_type, retcode);
+            result = -1;
+            break;
+        }
+
+        if ((retcode = SCIPcacheRowExtensions(scip, row)) != SCIP_OKAY ||
+            (retcode = SCIPaddVarsToRow(scip, row, (int) (end - beg), trans_vars, row_coef)) != SCIP_OKAY ||
+            (retcode = SCIPflushRowExtensions(scip, row)) != SCIP_OKAY ||
+            (retcode = SCIPaddCut(scip, sol, row, TRUE)) != SCIP_OKAY ||
+            (retcode = SCIPaddPoolCut(scip, row)) != SCIP_OKAY) {
+            PyScipSetError(lazy->error_type, retcode);
+            result = -1;
+        }
+        SCIPreleaseRow(scip, &row);
+        if (result)
+            break;
+    }
+
+cleanup:
+    PyScipArrayRelease(&indptr);
+    PyScipArrayRelease(&indices);
+    PyScipArrayRelease(&data);
+    PyScipArrayRelease(&lower);
+    PyScipArrayRelease(&upper);
+    return result;
+}
+
+static SCIP_RETCODE _lazy_separate(SCIP *scip, py_scip_lazy *lazy, SCIP_SOL *sol, bool integral, bool add, int *nviolated) {
+    // Calls back into Python with the solution values by solver index.
+    // Sets *nviolated to the number of violated rows returned, or -1 if
+    // the callback failed.  That error is kept and solving stops.
+    PyObject *values, *rows;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    bool failed = false;
+    int nvals;
+
+    *nviolated = 0;
+    if (lazy->exc_type != NULL) {
+        *nviolated = -1;
+        return SCIP_OKAY;
+    }
+
+    nvals = SCIPgetNOrigVars(scip);
+
+    PY_SCIP_ENTER_PYTHON();
+    rows = NULL;
+    values = PyBytes_FromStringAndSize(NULL, nvals * sizeof(SCIP_Real));
+    if (values == NULL) {
+        failed = true;
+    } else if ((retcode = SCIPgetSolVals(scip, sol, nvals, SCIPgetOrigVars(scip), (SCIP_Real *) PyBytes_AS_STRING(values))) == SCIP_OKAY) {
+        rows = PyObject_CallFunction(lazy->callback, "(OO)", values, integral ? Py_True : Py_False);
+        if (rows == NULL)
+            failed = true;
+        else if (rows != Py_None && _lazy_add_rows(scip, lazy, sol, rows,
+            (SCIP_Real *) PyBytes_AS_STRING(values), nvals, add, nviolated))
+            failed = true;
+    }
+    Py_XDECREF(rows);
+    Py_XDECREF(values);
+
+    if (failed) {
+        PyErr_Fetch(&lazy->exc_type, &lazy->exc_value, &lazy->exc_tb);
+        *nviolated = -1;
+    }
+    PY_SCIP_LEAVE_PYTHON();
+
+    if (failed)
+        SCIP_CALL( SCIPinterruptSolve(scip) );
+    return retcode;
+}
+
+/*****************************************************************************/
+/* CONSTRAINT HANDLER                                                        */
+/*****************************************************************************/
+static SCIP_RETCODE _lazy_create_cons(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **cons) {
+    // SCIPcreateCons Arguments:
+    //     name, handler, data, initial, separate, enforce, check, propagate,
+    //     local, modifiable, dynamic, removable, stickingatnode
+    SCIP_CALL( SCIPcreateCons(scip, cons, PY_SCIP_LAZY_NAME, conshdlr, NULL,
+        FALSE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE, FALSE) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSTRANS(_lazy_trans) {
+    SCIP_CALL( _lazy_create_cons(scip, conshdlr, targetcons) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSLOCK(_lazy_lock) {
+    // Rows can come back on any variable, in either direction, so dual
+    // reductions must not assume otherwise
+    SCIP_VAR **vars = SCIPgetVars(scip);
+    int i, nvars = SCIPgetNVars(scip);
+    for (i = 0; i < nvars; i++)
+        SCIP_CALL( SCIPaddVarLocks(scip, vars[i], nlockspos + nlocksneg, nlockspos + nlocksneg) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSSEPALP(_lazy_sepalp) {
+    py_scip_lazy *lazy = (py_scip_lazy *) SCIPconshdlrGetData(conshdlr);
+    int nviolated;
+
+    *result = SCIP_DIDNOTRUN;
+    if (lazy == NULL || lazy->callback == NULL || !lazy->fractional)
+        return SCIP_OKAY;
+
+    SCIP_CALL( _lazy_separate(scip, lazy, NULL, false, true, &nviolated) );
+    *result = nviolated > 0 ? SCIP_SEPARATED : SCIP_DIDNOTFIND;
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSENFOLP(_lazy_enfolp) {
+    // This runs after the integrality handler, so the LP is integral
+    py_scip_lazy *lazy = (py_scip_lazy *) SCIPconshdlrGetData(conshdlr);
+    int nviolated;
+
+    *result = SCIP_FEASIBLE;
+    if (lazy == NULL || lazy->callback == NULL)
+        return SCIP_OKAY;
+
+    SCIP_CALL( _lazy_separate(scip, lazy, NULL, true, true, &nviolated) );
+    if (nviolated > 0)
+        *result = SCIP_SEPARATED;
+    else if (nviolated < 0)
+        *result = SCIP_CUTOFF;
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSENFOPS(_lazy_enfops) {
+    // Pseudo solutions can't take cuts, so ask for the LP instead
+    py_scip_lazy *lazy = (py_scip_lazy *) SCIPconshdlrGetData(conshdlr);
+    int nviolated;
+
+    *result = SCIP_FEASIBLE;
+    if (lazy == NULL || lazy->callback == NULL)
+        return SCIP_OKAY;
+
+    SCIP_CALL( _lazy_separate(scip, lazy, NULL, true, false, &nviolated) );
+    if (nviolated > 0)
+        *result = SCIP_SOLVELP;
+    else if (nviolated < 0)
+        *result = SCIP_CUTOFF;
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSCHECK(_lazy_check) {
+    // Heuristic solutions get the same treatment, but only as a yes or no
+    py_scip_lazy *lazy = (py_scip_lazy *) SCIPconshdlrGetData(conshdlr);
+    int nviolated;
+
+    *result = SCIP_FEASIBLE;
+    if (lazy == NULL || lazy->callback == NULL)
+        return SCIP_OKAY;
+
+    SCIP_CALL( _lazy_separate(scip, lazy, sol, true, false, &nviolated) );
+    if (nviolated != 0)
+        *result = SCIP_INFEASIBLE;
+    return SCIP_OKAY;
+}
+
+/*****************************************************************************/
+/* PYTHON SIDE                                                               */
+/*****************************************************************************/
+static py_scip_lazy *PyScipLazyNew(PyObject *error_type) {
+    py_scip_lazy *lazy = calloc(1, sizeof(py_scip_lazy));
+    if (lazy == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return NULL;
+    }
+    lazy->error_type = error_type;
+    return lazy;
+}
+
+// Gives up the constraint and detaches the handler, so pooled instances
+// don't call into a solver that is gone.  The problem itself still holds
+// the constraint until it is freed.
+static void PyScipLazyDetach(SCIP *scip, py_scip_lazy *lazy) {
+    SCIP_CONSHDLR *conshdlr = SCIPfindConshdlr(scip, PY_SCIP_LAZY_NAME);
+    if (conshdlr != NULL)
+        SCIPconshdlrSetData(conshdlr, NULL);
+    if (lazy->cons != NULL)
+        SCIPreleaseCons(scip, &lazy->cons);
+    lazy->cons = NULL;
+}
+
+static void PyScipLazyFree(py_scip_lazy *lazy) {
+    Py_XDECREF(lazy->callback);
+    Py_XDECREF(lazy->exc_type);
+    Py_XDECREF(lazy->exc_value);
+    Py_XDECREF(lazy->exc_tb);
+    PyScipScratchFree(&lazy->scratch);
+    free(lazy);
+}
+
+// Turns the handler on or off for this SCIP instance, depending on whether
+// lazy->callback is set.  Call only while idle.  Returns 0 on success.
+static int PyScipLazyUpdate(PyObject *error_type, SCIP *scip, py_scip_lazy *lazy) {
+    SCIP_CONSHDLR *conshdlr;
+
+    // SCIPincludeConshdlr Arguments:
+    //     name, description, separation priority, enforcement priority,
+    //     check priority, separation frequency, propagation frequency, eager
+    //     frequency, max presolving rounds, delay separation, delay
+    //     propagation, delay presolving, needs constraints, callbacks...
+    //
+    // Negative enforcement and check priorities run after integrality.
+    conshdlr = SCIPfindConshdlr(scip, PY_SCIP_LAZY_NAME);
+    if (conshdlr == NULL && lazy->callback != NULL) {
+        PY_SCIP_CALL(error_type, -1,
+            SCIPincludeConshdlr(scip, PY_SCIP_LAZY_NAME, "separates rows from a Python callback",
+                0, -1, -1, 1, -1, 1, 0, FALSE, FALSE, FALSE, TRUE,
+                NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, _lazy_trans, NULL,
+                _lazy_sepalp, NULL, _lazy_enfolp, _lazy_enfops, _lazy_check, NULL, NULL, NULL,
+                _lazy_lock, NULL, NULL, NULL, NULL, NULL, NULL, NULL, (SCIP_CONSHDLRDATA *) lazy)
+        );
+        conshdlr = SCIPfindConshdlr(scip, PY_SCIP_LAZY_NAME);
+    }
+    if (conshdlr != NULL)
+        SCIPconshdlrSetData(conshdlr, (SCIP_CONSHDLRDATA *) lazy);
+
+    if ((lazy->callback != NULL) == (lazy->cons != NULL))
+        return 0;
+
+    // The constraint locks every variable, so it can't join or leave a
+    // transformed problem
+    PY_SCIP_CALL(error_type, -1, SCIPfreeTransform(scip));
+    if (lazy->callback != NULL) {
+        PY_SCIP_CALL(error_type, -1, _lazy_create_cons(scip, conshdlr, &lazy->cons));
+        PY_SCIP_CALL(error_type, -1, SCIPaddCons(scip, lazy->cons));
+    } else {
+        PY_SCIP_CALL(error_type, -1, SCIPdelCons(scip, lazy->cons));
+        PY_SCIP_CALL(error_type, -1, SCIPreleaseCons(scip, &lazy->cons));
+        lazy->cons = NULL;
+    }
+    return 0;
+}
+
+// Call with the GIL after SCIPsolve.  Raises the first callback error, if
+// there was one.  Returns 0 if there wasn't.
+static int PyScipLazyFinish(py_scip_lazy *lazy) {
+    if (lazy == NULL || lazy->exc_type == NULL)
+        return 0;
+
+    PyErr_Restore(lazy->exc_type, lazy->exc_value, lazy->exc_tb);
+    lazy->exc_type = lazy->exc_value = lazy->exc_tb = NULL;
+    return -1;
+}
+
+#endif
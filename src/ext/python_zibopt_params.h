@@ -0,0 +1,245 @@
+#ifndef PYTHON_ZIBOPT_PARAMS_H
+#define PYTHON_ZIBOPT_PARAMS_H
+
+// Header file for setting SCIP parameters by name from Python values, as
+// in {"limits/nodes": 1000, "separating/maxrounds": 0}, and for compiling
+// them into tables that can be applied over and over without Python.
+
+// Converts a Python value for one parameter.  The parameter's own type
+// decides which Python values are accepted.  String values are copied and
+// belong to out afterwards; out->name is left alone.  Returns 0 on success.
+static int PyScipParamConvert(PyObject *error_type, SCIP *scip, const char *name, PyObject *value, py_scip_param *out) {
+    SCIP_PARAM *param;
+    PyObject *bytes;
+    PY_LONG_LONG l;
+
+    param = SCIPgetParam(scip, name);
+    if (param == NULL) {
+        PyErr_Format(error_type, "unknown SCIP parameter: %s", name);
+        return -1;
+    }
+
+    out->type = SCIPparamGetType(param);
+    switch (out->type) {
+        case SCIP_PARAMTYPE_BOOL:
+            if (!PyBool_Check(value))
+                goto wrong_type;
+            out->value.b = value == Py_True;
+            break;
+
+        case SCIP_PARAMTYPE_INT:
+        case SCIP_PARAMTYPE_LONGINT:
+            if (!PyLong_Check(value) || PyBool_Check(value))
+                goto wrong_type;
+            l = PyLong_AsLongLong(value);
+            if (l == -1 && PyErr_Occurred())
+                return -1;
+            if (out->type == SCIP_PARAMTYPE_LONGINT) {
+                out->value.l = (SCIP_Longint) l;
+            } else if (l < INT_MIN || l > INT_MAX) {
+                PyScipSetError(error_type, SCIP_PARAMETERWRONGVAL);
+                return -1;
+            } else {
+                out->value.i = (int) l;
+            }
+            break;
+
+        case SCIP_PARAMTYPE_REAL:
+            if (!(PyFloat_Check(value) || PyLong_Check(value)) || PyBool_Check(value))
+                goto wrong_type;
+            out->value.r = PyFloat_AsDouble(value);
+            break;
+
+        case SCIP_PARAMTYPE_CHAR:
+        case SCIP_PARAMTYPE_STRING:
+            if (!PyUnicode_Check(value))
+                goto wrong_type;
+            bytes = PyUnicode_AsUTF8String(value);
+            if (bytes == NULL)
+                return -1;
+            if (out->type == SCIP_PARAMTYPE_CHAR) {
+                if (PyBytes_GET_SIZE(bytes) != 1) {
+                    Py_DECREF(bytes);
+                    PyScipSetError(error_type, SCIP_PARAMETERWRONGVAL);
+                    return -1;
+                }
+                out->value.c = PyBytes_AS_STRING(bytes)[0];
+            } else if ((out->value.s = strdup(PyBytes_AS_STRING(bytes))) == NULL) {
+                Py_DECREF(bytes);
+                PyErr_NoMemory();
+                return -1;
+            }
+            Py_DECREF(bytes);
+            break;
+
+        default:
+            goto wrong_type;
+    }
+    return 0;
+
+wrong_type:
+    PyErr_Format(error_type, "invalid value for SCIP parameter: %s", name);
+    return -1;
+}
+
+// Sets a converted parameter.  This doesn't touch Python, so it can run
+// without the GIL held.
+static SCIP_RETCODE PyScipParamApply(SCIP *scip, const char *name, const py_scip_param *p) {
+    switch (p->type) {
+        case SCIP_PARAMTYPE_BOOL:    return SCIPsetBoolParam(scip, name, p->value.b);
+        case SCIP_PARAMTYPE_INT:     return SCIPsetIntParam(scip, name, p->value.i);
+        case SCIP_PARAMTYPE_LONGINT: return SCIPsetLongintParam(scip, name, p->value.l);
+        case SCIP_PARAMTYPE_REAL:    return SCIPsetRealParam(scip, name, p->value.r);
+        case SCIP_PARAMTYPE_CHAR:    return SCIPsetCharParam(scip, name, p->value.c);
+        case SCIP_PARAMTYPE_STRING:  return SCIPsetStringParam(scip, name, p->value.s);
+        default:                     return SCIP_PARAMETERWRONGTYPE;
+    }
+}
+
+// Releases what a converted or copied parameter owns
+static void PyScipParamClear(py_scip_param *p) {
+    if (p->type == SCIP_PARAMTYPE_STRING && p->value.s != NULL)
+        free(p->value.s);
+    if (p->name != NULL)
+        free(p->name);
+    p->name = NULL;
+    p->type = SCIP_PARAMTYPE_BOOL;
+}
+
+// Sets one parameter from a Python value.  Returns 0 on success.
+static int PyScipSetParam(PyObject *error_type, SCIP *scip, const char *name, PyObject *value) {
+    py_scip_param p;
+    SCIP_RETCODE retcode;
+
+    p.name = NULL;
+    if (PyScipParamConvert(error_type, scip, name, value, &p))
+        return -1;
+    retcode = PyScipParamApply(scip, name, &p);
+    PyScipParamClear(&p);
+
+    if (retcode != SCIP_OKAY) {
+        PyScipSetError(error_type, retcode);
+        return -1;
+    }
+    return 0;
+}
+
+// Sets every parameter in a dict of names to values.  Returns 0 on success.
+static int PyScipSetParams(PyObject *error_type, SCIP *scip, PyObject *params) {
+    PyObject *key, *value, *bytes;
+    Py_ssize_t pos;
+    int rc;
+
+    if (!PyDict_Check(params)) {
+        PyErr_SetString(error_type, "SCIP parameters must be a dict");
+        return -1;
+    }
+
+    pos = 0;
+    while (PyDict_Next(params, &pos, &key, &value)) {
+        if (!PyUnicode_Check(key)) {
+            PyErr_SetString(error_type, "SCIP parameter names must be strings");
+            return -1;
+        }
+
+        bytes = PyUnicode_AsUTF8String(key);
+        if (bytes == NULL)
+            return -1;
+        rc = PyScipSetParam(error_type, scip, PyBytes_AS_STRING(bytes), value);
+        Py_DECREF(bytes);
+        if (rc)
+            return -1;
+    }
+
+    return 0;
+}
+
+// Copies the current value of a parameter, along with its name.  Returns
+// 0 on success.
+static int PyScipParamCopy(SCIP_PARAM *param, py_scip_param *out) {
+    out->name = NULL;
+    out->type = SCIPparamGetType(param);
+    out->value.s = NULL;
+    switch (out->type) {
+        case SCIP_PARAMTYPE_BOOL:    out->value.b = SCIPparamGetBool(param);    break;
+        case SCIP_PARAMTYPE_INT:     out->value.i = SCIPparamGetInt(param);     break;
+        case SCIP_PARAMTYPE_LONGINT: out->value.l = SCIPparamGetLongint(param); break;
+        case SCIP_PARAMTYPE_REAL:    out->value.r = SCIPparamGetReal(param);    break;
+        case SCIP_PARAMTYPE_CHAR:    out->value.c = SCIPparamGetChar(param);    break;
+        case SCIP_PARAMTYPE_STRING:
+            if ((out->value.s = strdup(SCIPparamGetString(param))) == NULL)
+                return -1;
+            break;
+    }
+    if ((out->name = strdup(SCIPparamGetName(param))) == NULL) {
+        PyScipParamClear(out);
+        return -1;
+    }
+    return 0;
+}
+
+// Frees a table of parameters from PyScipParamsCompile
+static void PyScipParamsFree(py_scip_param *table, int n) {
+    int i;
+    if (table == NULL)
+        return;
+    for (i = 0; i < n; i++)
+        PyScipParamClear(&table[i]);
+    free(table);
+}
+
+// Copies every parameter of scip that differs from its default, and any
+// named in the optional dict keep, into a new table.  Applying the table
+// later sets them without name conversions or type checks.  Returns the
+// number of parameters copied, or -1.
+static int PyScipParamsCompile(PyObject *error_type, SCIP *scip, PyObject *keep, py_scip_param **table) {
+    SCIP_PARAM **params;
+    int i, n, nparams;
+
+    params = SCIPgetParams(scip);
+    nparams = SCIPgetNParams(scip);
+    *table = NULL;
+    if (nparams > 0 && (*table = calloc(nparams, sizeof(py_scip_param))) == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (i = n = 0; i < nparams; i++) {
+        if (SCIPparamIsDefault(params[i]) &&
+            (keep == NULL || PyDict_GetItemString(keep, SCIPparamGetName(params[i])) == NULL))
+            continue;
+
+        if (PyScipParamCopy(params[i], &(*table)[n])) {
+            PyScipParamsFree(*table, n);
+            *table = NULL;
+            PyErr_NoMemory();
+            return -1;
+        }
+        n++;
+    }
+
+    return n;
+}
+
+// Sets every parameter in a compiled table.  This doesn't touch Python.
+static SCIP_RETCODE PyScipParamsApply(SCIP *scip, const py_scip_param *table, int n) {
+    int i;
+    for (i = 0; i < n; i++)
+        SCIP_CALL( PyScipParamApply(scip, table[i].name, &table[i]) );
+    return SCIP_OKAY;
+}
+
+// Returns the Python value of a converted or copied parameter
+static PyObject *PyScipParamValue(const py_scip_param *p) {
+    switch (p->type) {
+        case SCIP_PARAMTYPE_BOOL:    return PyBool_FromLong(p->value.b);
+        case SCIP_PARAMTYPE_INT:     return PyLong_FromLong(p->value.i);
+        case SCIP_PARAMTYPE_LONGINT: return PyLong_FromLongLong(p->value.l);
+        case SCIP_PARAMTYPE_REAL:    return PyFloat_FromDouble(p->value.r);
+        case SCIP_PARAMTYPE_CHAR:    return PyUnicode_FromStringAndSize(&p->value.c, 1);
+        case SCIP_PARAMTYPE_STRING:  return PyUnicode_FromString(p->value.s);
+        default:                     Py_RETURN_NONE;
+    }
+}
+
+#endif
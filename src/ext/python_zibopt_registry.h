@@ -0,0 +1,150 @@
+#ifndef PYTHON_ZIBOPT_REGISTRY_H
+#define PYTHON_ZIBOPT_REGISTRY_H
+
+// Header file for the registries solvers keep of their variables and
+// constraints.  Entries are appended and never move, so an index handed
+// out once stays valid for the life of the solver.  Each entry holds one
+// capture of its SCIP handle and, optionally, the Python object wrapping
+// it.  Objects the user created are owned by the registry.  Objects made
+// on demand for existing entries are flyweights: the registry only
+// borrows them, and they take themselves out when they are freed, so a
+// model with millions of entries only pays for wrappers still in use.
+
+#define PY_SCIP_REGISTRY_MIN_CAPACITY 64
+
+// Makes sure there is room for n more entries.  Returns 0 on success.
+static int PyScipRegistryReserve(PyObject *error_type, py_scip_registry *r, int n) {
+    void **handles;
+    PyObject **wrappers;
+    bool *borrowed;
+    int capacity;
+
+    if (r->size + n <= r->capacity)
+        return 0;
+
+    capacity = r->capacity > 0 ? r->capacity : PY_SCIP_REGISTRY_MIN_CAPACITY;
+    while (capacity < r->size + n)
+        capacity *= 2;
+
+    handles = realloc(r->handles, capacity * sizeof(void *));
+    if (handles == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return -1;
+    }
+    r->handles = handles;
+
+    wrappers = realloc(r->wrappers, capacity * sizeof(PyObject *));
+    if (wrappers == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return -1;
+    }
+    r->wrappers = wrappers;
+
+    borrowed = realloc(r->borrowed, capacity * sizeof(bool));
+    if (borrowed == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return -1;
+    }
+    r->borrowed = borrowed;
+
+    memset(r->wrappers + r->capacity, 0, (capacity - r->capacity) * sizeof(PyObject *));
+    memset(r->borrowed + r->capacity, 0, (capacity - r->capacity) * sizeof(bool));
+    r->capacity = capacity;
+    return 0;
+}
+
+// Appends a handle, taking over one capture of it, and returns its index.
+// The wrapper may be NULL.  Returns -1 if the registry can't grow.
+static int PyScipRegistryAdd(PyObject *error_type, py_scip_registry *r, void *handle, PyObject *wrapper) {
+    if (PyScipRegistryReserve(error_type, r, 1))
+        return -1;
+
+    if (wrapper != NULL) {
+        Py_INCREF(wrapper);
+        r->nwrappers++;
+    }
+    r->handles[r->size] = handle;
+    r->wrappers[r->size] = wrapper;
+    return r->size++;
+}
+
+// Sets a flyweight for entry i, which must not have one yet.  The wrapper
+// must call PyScipRegistryDropWrapper when it is freed.
+static void PyScipRegistrySetWrapper(py_scip_registry *r, int i, PyObject *wrapper) {
+    r->wrappers[i] = wrapper;
+    r->borrowed[i] = true;
+    r->nwrappers++;
+}
+
+// Takes a flyweight out of entry i if it is still there
+static void PyScipRegistryDropWrapper(py_scip_registry *r, int i, PyObject *wrapper) {
+    if (i < 0 || i >= r->size || r->wrappers[i] != wrapper)
+        return;
+    r->wrappers[i] = NULL;
+    r->borrowed[i] = false;
+    r->nwrappers--;
+}
+
+// Visits the Python objects the registry owns, for garbage collection
+static int PyScipRegistryTraverse(py_scip_registry *r, visitproc visit, void *arg) {
+    int i;
+    for (i = 0; r->nwrappers > 0 && i < r->size; i++) {
+        if (!r->borrowed[i])
+            Py_VISIT(r->wrappers[i]);
+    }
+    return 0;
+}
+
+// Returns a tuple of every Python object in the registry, in index order.
+// If active is given, only objects it returns true for are included.
+static PyObject *PyScipRegistryWrappers(py_scip_registry *r, bool (*active)(PyObject *)) {
+    PyObject *list, *tuple;
+    int i;
+
+    list = PyList_New(0);
+    if (list == NULL)
+        return NULL;
+
+    for (i = 0; i < r->size; i++) {
+        if (r->wrappers[i] == NULL || (active && !active(r->wrappers[i])))
+            continue;
+        if (PyList_Append(list, r->wrappers[i]) < 0) {
+            Py_DECREF(list);
+            return NULL;
+        }
+    }
+
+    tuple = PyList_AsTuple(list);
+    Py_DECREF(list);
+    return tuple;
+}
+
+// Drops references to Python objects, but leaves the handles alone.
+// Flyweights are only forgotten, so they must be orphaned first.
+static void PyScipRegistryClearWrappers(py_scip_registry *r) {
+    PyObject *w;
+    int i;
+
+    // Bulk-built models usually have nothing to clear
+    for (i = 0; r->nwrappers > 0 && i < r->size; i++) {
+        if ((w = r->wrappers[i]) == NULL)
+            continue;
+        r->wrappers[i] = NULL;
+        r->nwrappers--;
+        if (r->borrowed[i])
+            r->borrowed[i] = false;
+        else
+            Py_DECREF(w);
+    }
+}
+
+// Frees registry memory.  Handles must already have been released.
+static void PyScipRegistryFree(py_scip_registry *r) {
+    PyScipRegistryClearWrappers(r);
+    if (r->handles != NULL) free(r->handles);
+    if (r->wrappers != NULL) free(r->wrappers);
+    if (r->borrowed != NULL) free(r->borrowed);
+    memset(r, 0, sizeof(py_scip_registry));
+}
+
+#endif
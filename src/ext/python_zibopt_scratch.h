@@ -0,0 +1,40 @@
+#ifndef PYTHON_ZIBOPT_SCRATCH_H
+#define PYTHON_ZIBOPT_SCRATCH_H
+
+// Header file for per-solver scratch space.  Building a constraint needs
+// arrays of variables and coefficients only until SCIP has copied them,
+// so one buffer is grown as needed and reused for every constraint.
+
+// Returns at least nbytes of scratch space, or NULL if it can't be had.
+// Contents are not preserved from one call to the next.
+static void *PyScipScratchGet(PyObject *error_type, py_scip_scratch *s, size_t nbytes) {
+    void *buf;
+    size_t size;
+
+    if (nbytes <= s->size && s->buf != NULL)
+        return s->buf;
+
+    size = s->size > 0 ? s->size : 4096;
+    while (size < nbytes)
+        size *= 2;
+
+    // Nothing needs copying, so skip realloc
+    buf = malloc(size);
+    if (buf == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return NULL;
+    }
+
+    if (s->buf != NULL) free(s->buf);
+    s->buf = buf;
+    s->size = size;
+    return buf;
+}
+
+static void PyScipScratchFree(py_scip_scratch *s) {
+    if (s->buf != NULL) free(s->buf);
+    s->buf = NULL;
+    s->size = 0;
+}
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef PYTHON_ZIBOPT_SNAPSHOT_H
+#define PYTHON_ZIBOPT_SNAPSHOT_H
+
+// Header file for binary model snapshots.  A snapshot holds variable
+// bounds, types and objective coefficients plus the linear constraint
+// matrix in CSR format, as flat native arrays.  Loading one is a single
+// pass over a buffer, so a memory-mapped file goes into SCIP without any
+// parsing.  Layout, after the header:
+//
+//     double lower[nvars], upper[nvars], obj[nvars]
+//     int64  indptr[nconss+1], indices[nnz]
+//     double data[nnz], lhs[nconss], rhs[nconss]
+//     uint8  vartype[nvars]
+
+#include "python_zibopt_control.h"
+
+#define PY_SCIP_SNAPSHOT_MAGIC     "PYZIBOPT"
+#define PY_SCIP_SNAPSHOT_VERSION   1
+#define PY_SCIP_SNAPSHOT_BYTEORDER 0x01020304
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteorder;   // PY_SCIP_SNAPSHOT_BYTEORDER as the writer saw it
+    int64_t nvars;
+    int64_t nconss;
+    int64_t nnz;
+} py_scip_snapshot_header;
+
+// Buffers need not be aligned, so every read goes through memcpy
+static double _snapshot_real(const char *p, int64_t i) {
+    double d;
+    memcpy(&d, p + i * sizeof(double), sizeof(double));
+    return d;
+}
+
+static int64_t _snapshot_index(const char *p, int64_t i) {
+    int64_t j;
+    memcpy(&j, p + i * sizeof(int64_t), sizeof(int64_t));
+    return j;
+}
+
+static bool _snapshot_skip(SCIP_CONS *cons) {
+    // The lazy row handler's constraint belongs to the solver, not the model
+    return strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), PY_SCIP_LAZY_NAME) == 0;
+}
+
+/*****************************************************************************/
+/* WRITING                                                                   */
+/*****************************************************************************/
+static int _snapshot_write(FILE *f, const void *p, size_t size) {
+    return fwrite(p, size, 1, f) == 1 ? 0 : -1;
+}
+
+// Saves the problem as given to path.  Only linear constraints can be
+// saved.  Returns 0 on success.
+static int PyScipSnapshotSave(PyObject *error_type, SCIP *scip, const char *path) {
+    py_scip_snapshot_header header;
+    SCIP_VAR **vars, **row_vars;
+    SCIP_CONS **conss;
+    SCIP_Real *row_vals, d;
+    int64_t j;
+    int i, k, nvars, nconss, nrows, len;
+    uint8_t t;
+    FILE *f;
+    int rc = 0;
+
+    vars = SCIPgetOrigVars(scip);
+    nvars = SCIPgetNOrigVars(scip);
+    conss = SCIPgetOrigConss(scip);
+    nconss = SCIPgetNOrigConss(scip);
+
+    memset(&header, 0, sizeof(header));
+    nrows = 0;
+    for (i = 0; i < nconss; i++) {
+        if (_snapshot_skip(conss[i]))
+            continue;
+        if (strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(conss[i])), "linear")) {
+            PyErr_SetString(error_type, "snapshots only support linear constraints");
+            return -1;
+        }
+        header.nnz += SCIPgetNVarsLinear(scip, conss[i]);
+        nrows++;
+    }
+
+    memcpy(header.magic, PY_SCIP_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = PY_SCIP_SNAPSHOT_VERSION;
+    header.byteorder = PY_SCIP_SNAPSHOT_BYTEORDER;
+    header.nvars = nvars;
+    header.nconss = nrows;
+
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        PyErr_SetFromErrnoWithFilename(PyExc_IOError, path);
+        return -1;
+    }
+
+    // One array after another, in layout order
+    rc |= _snapshot_write(f, &header, sizeof(header));
+    for (i = 0; i < nvars && !rc; i++) {
+        d = SCIPvarGetLbOriginal(vars[i]);
+        rc |= _snapshot_write(f, &d, sizeof(d));
+    }
+    for (i = 0; i < nvars && !rc; i++) {
+        d = SCIPvarGetUbOriginal(vars[i]);
+        rc |= _snapshot_write(f, &d, sizeof(d));
+    }
+    for (i = 0; i < nvars && !rc; i++) {
+        d = SCIPvarGetObj(vars[i]);
+        rc |= _snapshot_write(f, &d, sizeof(d));
+    }
+
+    j = 0;
+    rc |= _snapshot_write(f, &j, sizeof(j));
+    for (i = 0; i < nconss && !rc; i++) {
+        if (_snapshot_skip(conss[i]))
+            continue;
+        j += SCIPgetNVarsLinear(scip, conss[i]);
+        rc |= _snapshot_write(f, &j, sizeof(j));
+    }
+    for (i = 0; i < nconss && !rc; i++) {
+        if (_snapshot_skip(conss[i]))
+            continue;
+        row_vars = SCIPgetVarsLinear(scip, conss[i]);
+        len = SCIPgetNVarsLinear(scip, conss[i]);
+        for (k = 0; k < len && !rc; k++) {
+            j = SCIPvarGetProbindex(row_vars[k]);
+            rc |= _snapshot_write(f, &j, sizeof(j));
+        }
+    }
+    for (i = 0; i < nconss && !rc; i++) {
+        if (_snapshot_skip(conss[i]))
+            continue;
+        row_vals = SCIPgetValsLinear(scip, conss[i]);
+        len = SCIPgetNVarsLinear(scip, conss[i]);
+        if (len > 0)
+            rc |= _snapshot_write(f, row_vals, len * sizeof(SCIP_Real));
+    }
+    for (i = 0; i < nconss && !rc; i++) {
+        if (_snapshot_skip(conss[i]))
+            continue;
+        d = SCIPgetLhsLinear(scip, conss[i]);
+        rc |= _snapshot_write(f, &d, sizeof(d));
+    }
+    for (i = 0; i < nconss && !rc; i++) {
+        if (_snapshot_skip(conss[i]))
+            continue;
+        d = SCIPgetRhsLinear(scip, conss[i]);
+        rc |= _snapshot_write(f, &d, sizeof(d));
+    }
+    for (i = 0; i < nvars && !rc; i++) {
+        t = (uint8_t) SCIPvarGetType(vars[i]);
+        rc |= _snapshot_write(f, &t, sizeof(t));
+    }
+
+    if (fclose(f) != 0)
+        rc = -1;
+    if (rc)
+        PyErr_SetFromErrnoWithFilename(PyExc_IOError, path);
+    return rc;
+}
+
+/*****************************************************************************/
+/* LOADING                                                                   */
+/*****************************************************************************/
+// Adds the model in a snapshot buffer to the solver.  Its variables and
+// constraints go at the end of the solver's registries, starting at the
+// sizes they had before.  Call with the GIL; it is released while SCIP
+// builds the model.  Returns 0 on success.
+static int PyScipSnapshotLoad(PyObject *error_type, solver *solv, const char *buf, Py_ssize_t size) {
+    py_scip_snapshot_header header;
+    const char *lower, *upper, *obj, *indptr, *indices, *data, *lhs, *rhs;
+    const uint8_t *vartype;
+    SCIP_VAR **vars, **row_vars;
+    SCIP_Real *row_coef, lb, ub, inf;
+    int64_t i, k, beg, end, maxlen, j, expected;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    int start;
+
+    if (size < (Py_ssize_t) sizeof(header)) {
+        PyErr_SetString(error_type, "snapshot is truncated");
+        return -1;
+    }
+    memcpy(&header, buf, sizeof(header));
+
+    if (memcmp(header.magic, PY_SCIP_SNAPSHOT_MAGIC, sizeof(header.magic)) ||
+        header.version != PY_SCIP_SNAPSHOT_VERSION) {
+        PyErr_SetString(error_type, "not a snapshot, or from another version");
+        return -1;
+    }
+    if (header.byteorder != PY_SCIP_SNAPSHOT_BYTEORDER) {
+        PyErr_SetString(error_type, "snapshot was written with another byte order");
+        return -1;
+    }
+    if (header.nvars < 0 || header.nconss < 0 || header.nnz < 0 ||
+        header.nvars > INT_MAX - solv->vars.size || header.nconss > INT_MAX - solv->conss.size ||
+        header.nnz > INT_MAX) {
+        PyErr_SetString(error_type, "snapshot is corrupt");
+        return -1;
+    }
+
+    // Counts are bounded above, so none of this can overflow
+    expected = (int64_t) sizeof(header) + header.nvars * (3 * sizeof(double) + sizeof(uint8_t)) +
+        (header.nconss + 1) * sizeof(int64_t) + header.nnz * (sizeof(int64_t) + sizeof(double)) +
+        header.nconss * 2 * sizeof(double);
+    if (expected != size) {
+        PyErr_SetString(error_type, "snapshot is truncated or corrupt");
+        return -1;
+    }
+
+    lower   = buf + sizeof(header);
+    upper   = lower + header.nvars * sizeof(double);
+    obj     = upper + header.nvars * sizeof(double);
+    indptr  = obj + header.nvars * sizeof(double);
+    indices = indptr + (header.nconss + 1) * sizeof(int64_t);
+    data    = indices + header.nnz * sizeof(int64_t);
+    lhs     = data + header.nnz * sizeof(double);
+    rhs     = lhs + header.nconss * sizeof(double);
+    vartype = (const uint8_t *) (rhs + header.nconss * sizeof(double));
+
+    // Check everything before SCIP sees any of it
+    maxlen = 0;
+    if (_snapshot_index(indptr, 0) != 0 || _snapshot_index(indptr, header.nconss) != header.nnz) {
+        PyErr_SetString(error_type, "snapshot is corrupt");
+        return -1;
+    }
+    for (i = 0; i < header.nconss; i++) {
+        beg = _snapshot_index(indptr, i);
+        end = _snapshot_index(indptr, i+1);
+        if (end < beg || end > header.nnz || _snapshot_real(rhs, i) < _snapshot_real(lhs, i)) {
+            PyErr_SetString(error_type, "snapshot is corrupt");
+            return -1;
+        }
+        if (end - beg > maxlen)
+            maxlen = end - beg;
+    }
+    for (k = 0; k < header.nnz; k++) {
+        j = _snapshot_index(indices, k);
+        if (j < 0 || j >= header.nvars) {
+            PyErr_SetString(error_type, "snapshot is corrupt");
+            return -1;
+        }
+    }
+    for (i = 0; i < header.nvars; i++) {
+        if (vartype[i] > SCIP_VARTYPE_CONTINUOUS || _snapshot_real(upper, i) < _snapshot_real(lower, i)) {
+            PyErr_SetString(error_type, "snapshot is corrupt");
+            return -1;
+        }
+    }
+
+    // Room for everything up front, so nothing below needs Python
+    PY_SCIP_CALL(error_type, -1, SCIPfreeTransform(solv->scip));
+    if (PyScipRegistryReserve(error_type, &solv->vars, (int) header.nvars) ||
+        PyScipRegistryReserve(error_type, &solv->conss, (int) header.nconss))
+        return -1;
+
+    row_coef = (SCIP_Real *) PyScipScratchGet(error_type, &solv->scratch,
+        maxlen * (sizeof(SCIP_Real) + sizeof(SCIP_VAR *)));
+    if (row_coef == NULL)
+        return -1;
+    row_vars = (SCIP_VAR **) (row_coef + maxlen);
+
+    start = solv->vars.size;
+    inf = SCIPinfinity(solv->scip);
+
+    PyScipControlBusy(solv->control, solv->scip);
+    solv->solving = true;
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < header.nvars && retcode == SCIP_OKAY; i++) {
+        SCIP_VAR *var;
+
+        lb = _snapshot_real(lower, i);
+        ub = _snapshot_real(upper, i);
+        if (lb < -inf) lb = -inf;
+        if (ub > inf)  ub = inf;
+
+        // See variable_init in varsmodule.c for SCIPcreateVar arguments
+        retcode = SCIPcreateVar(solv->scip, &var, NULL, lb, ub, _snapshot_real(obj, i),
+            (SCIP_VARTYPE) vartype[i], TRUE, FALSE, NULL, NULL, NULL, NULL, NULL);
+        if (retcode != SCIP_OKAY)
+            break;
+
+        PyScipRegistryAdd(error_type, &solv->vars, var, NULL);
+        retcode = SCIPaddVar(solv->scip, var);
+    }
+
+    vars = (SCIP_VAR **) solv->vars.handles + start;
+    for (i = 0; i < header.nconss && retcode == SCIP_OKAY; i++) {
+        SCIP_CONS *cons;
+
+        beg = _snapshot_index(indptr, i);
+        end = _snapshot_index(indptr, i+1);
+        for (k = beg; k < end; k++) {
+            row_vars[k-beg] = vars[_snapshot_index(indices, k)];
+            row_coef[k-beg] = _snapshot_real(data, k);
+        }
+
+        lb = _snapshot_real(lhs, i);
+        ub = _snapshot_real(rhs, i);
+        if (lb < -inf) lb = -inf;
+        if (ub > inf)  ub = inf;
+
+        // Same flags as constraint blocks
+        retcode = SCIPcreateConsLinear(solv->scip, &cons, "", (int) (end - beg), row_vars, row_coef,
+            lb, ub, TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE);
+        if (retcode != SCIP_OKAY)
+            break;
+
+        PyScipRegistryAdd(error_type, &solv->conss, cons, NULL);
+        retcode = SCIPaddCons(solv->scip, cons);
+    }
+    PyScipControlStop(solv->control);
+    Py_END_ALLOW_THREADS
+    solv->solving = false;
+
+    PY_SCIP_CALL(error_type, -1, retcode);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PYTHON_ZIBOPT_THREADS_H
+#define PYTHON_ZIBOPT_THREADS_H
+
+// Header file for running SCIP on native threads.  Thread bodies must not
+// touch Python objects.  Each thread holds a lock while it runs, so joining
+// is just acquiring that lock again.  These can be called with or without
+// the GIL.
+
+typedef struct {
+    PyThread_type_lock done; // held while the thread runs
+    void (*run)(void *);     // thread body
+    void *arg;
+} py_scip_thread;
+
+static void _py_scip_thread_main(void *arg) {
+    py_scip_thread *t = (py_scip_thread *) arg;
+    t->run(t->arg);
+    PyThread_release_lock(t->done);
+}
+
+// Allocates the thread's lock.  Returns 0 on success.
+static int PyScipThreadInit(PyObject *error_type, py_scip_thread *t) {
+    t->done = PyThread_allocate_lock();
+    if (t->done == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return -1;
+    }
+    return 0;
+}
+
+// Starts run(arg) on a new thread.  Returns -1 if the thread can't be
+// started, in which case run was not called.  Joining it is still safe.
+static int PyScipThreadStart(py_scip_thread *t, void (*run)(void *), void *arg) {
+    t->run = run;
+    t->arg = arg;
+    PyThread_acquire_lock(t->done, WAIT_LOCK);
+    if (PyThread_start_new_thread(_py_scip_thread_main, t) == -1) {
+        PyThread_release_lock(t->done);
+        return -1;
+    }
+    return 0;
+}
+
+// Waits for a started thread to finish.  Release the GIL first.
+static void PyScipThreadJoin(py_scip_thread *t) {
+    PyThread_acquire_lock(t->done, WAIT_LOCK);
+    PyThread_release_lock(t->done);
+}
+
+static void PyScipThreadFree(py_scip_thread *t) {
+    if (t->done != NULL) PyThread_free_lock(t->done);
+    t->done = NULL;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef PYTHON_ZIBOPT_TYPES_H
+#define PYTHON_ZIBOPT_TYPES_H
+
+// Header file for sharing type objects between extension modules.  _scip
+// exports a table of them in a capsule.  Each module fills in the types
+// it defines when it loads, so checks are pointer comparisons instead of
+// comparing type names.
+
+#define PY_SCIP_TYPES_MODULE "zibopt._scip"
+#define PY_SCIP_TYPES_CAPSULE "zibopt._scip._types"
+
+static py_scip_types *py_scip_types_table = NULL;
+
+// Loads the type table from _scip.  Returns 0 on success.
+static int PyScipImportTypes(void) {
+    PyObject *m;
+
+    // Older Pythons don't import submodules in PyCapsule_Import
+    m = PyImport_ImportModule(PY_SCIP_TYPES_MODULE);
+    if (m == NULL)
+        return -1;
+    Py_DECREF(m);
+
+    py_scip_types_table = (py_scip_types *) PyCapsule_Import(PY_SCIP_TYPES_CAPSULE, 0);
+    return py_scip_types_table == NULL ? -1 : 0;
+}
+
+// A type that hasn't been loaded yet can't have any instances
+#define PY_SCIP_TYPE_CHECK(obj, type_field) \
+    (py_scip_types_table->type_field != NULL && PyObject_TypeCheck((obj), py_scip_types_table->type_field))
+
+#define PyScipSolver_Check(obj)          PY_SCIP_TYPE_CHECK(obj, solver)
+#define PyScipVariable_Check(obj)        PY_SCIP_TYPE_CHECK(obj, variable)
+#define PyScipVariableBlock_Check(obj)   PY_SCIP_TYPE_CHECK(obj, variable_block)
+#define PyScipConstraint_Check(obj)      PY_SCIP_TYPE_CHECK(obj, constraint)
+#define PyScipConstraintBlock_Check(obj) PY_SCIP_TYPE_CHECK(obj, constraint_block)
+#define PyScipLinearExpr_Check(obj)      PY_SCIP_TYPE_CHECK(obj, linear_expr)
+
+#endif
@@ -12,6 +12,40 @@
         } \
     } while (FALSE);
 
+// SCIP solver: refuses to touch a solver while another thread is inside
+// SCIPsolve on it.  The flag is only read and written with the GIL held.
+#define PY_SCIP_CHECK_IDLE(error_type, fail_code, solv) \
+    do { \
+        if ((solv)->solving) { \
+            PyErr_SetString(error_type, "solver is busy in another thread"); \
+            return fail_code; \
+        } \
+    } while (FALSE);
+
+// SCIP solver: whether status and bounds come from a portfolio winner.  Its
+// workers solve copies, so the source problem stays merely transformed.
+#define PY_SCIP_PORTFOLIO_OUTCOME(solv) \
+    ((solv)->portfolio.valid && SCIPgetStage((solv)->scip) == SCIP_STAGE_TRANSFORMED)
+
+// SCIP variables and constraints: refuses to use wrappers that outlived
+// their solver, whose handles are gone.  The solver clears scip on them.
+#define PY_SCIP_CHECK_ASSOCIATED(error_type, fail_code, obj, what) \
+    do { \
+        if ((obj)->scip == NULL) { \
+            PyErr_SetString(error_type, what " not associated with solver"); \
+            return fail_code; \
+        } \
+    } while (FALSE);
+
+// SCIP callbacks run while the GIL is released by SCIPsolve.  Any callback
+// that needs to touch Python objects has to be wrapped in these.
+#define PY_SCIP_ENTER_PYTHON() \
+    { \
+        PyGILState_STATE _gilstate_ = PyGILState_Ensure();
+
+#define PY_SCIP_LEAVE_PYTHON() \
+        PyGILState_Release(_gilstate_); \
+    }
 
 // SCIP solver: utility to load setting names
 #define PY_SCIP_SETTING_NAMES(function_name, setting_count, setting) \
@@ -33,6 +67,33 @@ static PyObject *function_name(solver *self) { \
     return rules; \
 }
 
+// SCIP settings modules: refuses to touch settings once their solver is
+// gone, and the pointers into its SCIP instance with it
+#define PY_SCIP_CHECK_SETTINGS_ALIVE(error_type, fail_code) \
+    do { \
+        PyObject *_solver_ = PyWeakref_GetObject(self->solver_ref); \
+        if (_solver_ == NULL) \
+            return fail_code; \
+        if (_solver_ == Py_None) { \
+            PyErr_SetString(error_type, "setting not associated with solver"); \
+            return fail_code; \
+        } \
+    } while (FALSE);
+
+// SCIP settings modules: also refuses to change them while the solver is busy
+#define PY_SCIP_CHECK_SETTINGS_IDLE(error_type, fail_code) \
+    do { \
+        PY_SCIP_CHECK_SETTINGS_ALIVE(error_type, fail_code); \
+        PY_SCIP_CHECK_IDLE(error_type, fail_code, (solver *) PyWeakref_GET_OBJECT(self->solver_ref)); \
+    } while (FALSE);
+
+// SCIP settings modules: generic attribute getting function
+#define PY_SCIP_GET(name, format, getter) \
+        if (PyUnicode_CompareWithASCIIString(attr_name, name) == 0) { \
+            PY_SCIP_CHECK_SETTINGS_ALIVE(error, NULL); \
+            return Py_BuildValue(format, getter); \
+        }
+
 // SCIP settings modules: generic attribute setting functions
 #define PY_SCIP_SET_DBL_MIN(name, attribute, minimum) \
         if (PyUnicode_CompareWithASCIIString(attr_name, name) == 0) { \
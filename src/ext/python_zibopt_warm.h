@@ -0,0 +1,193 @@
+#ifndef PYTHON_ZIBOPT_WARM_H
+#define PYTHON_ZIBOPT_WARM_H
+
+// Header file for warm starts.  SCIP drops its solutions whenever the
+// transformed problem is freed, which happens on nearly every model edit.
+// A solver keeps one start, by original variable index: either what the
+// user handed it or the last incumbent.  NaN entries, and variables added
+// after the start was taken, are unknown.  Complete starts are tried as
+// they are; partial ones are first completed by a small sub-SCIP with the
+// known values fixed.
+//
+// SCIP 2.0 has no way to hand an LP basis to a freshly transformed
+// problem, so only primal values are carried across solves.
+
+#define PY_SCIP_WARM_NODES 500 // default node limit for completing starts
+
+// Makes room for n values.  The old values are lost.
+static int _warm_reserve(PyObject *error_type, py_scip_warm *w, int n) {
+    SCIP_Real *vals;
+
+    if (n <= w->capacity && w->vals != NULL)
+        return 0;
+
+    vals = malloc((n > 0 ? n : 1) * sizeof(SCIP_Real));
+    if (vals == NULL) {
+        PyErr_SetString(error_type, "ran out of memory");
+        return -1;
+    }
+
+    if (w->vals != NULL) free(w->vals);
+    w->vals = vals;
+    w->capacity = n;
+    return 0;
+}
+
+// Replaces the start with n values.  NaN marks unknown values.
+static int PyScipWarmSet(PyObject *error_type, py_scip_warm *w, const SCIP_Real *vals, int n) {
+    if (_warm_reserve(error_type, w, n))
+        return -1;
+    if (n > 0)
+        memcpy(w->vals, vals, n * sizeof(SCIP_Real));
+    w->n = n;
+    return 0;
+}
+
+static void PyScipWarmClear(py_scip_warm *w) {
+    w->n = 0;
+}
+
+// Replaces the start with the best solution SCIP has, if any
+static int PyScipWarmSave(PyObject *error_type, py_scip_warm *w, SCIP *scip, SCIP_VAR **vars, int nvars) {
+    SCIP_SOL *best = SCIPgetBestSol(scip);
+
+    if (best == NULL || nvars == 0)
+        return 0;
+    if (_warm_reserve(error_type, w, nvars))
+        return -1;
+
+    // The values are there even if the call fails, so drop them first
+    w->n = 0;
+    PY_SCIP_CALL(error_type, -1, SCIPgetSolVals(scip, best, nvars, vars, w->vals));
+    w->n = nvars;
+    return 0;
+}
+
+static void PyScipWarmFree(py_scip_warm *w) {
+    if (w->vals != NULL) free(w->vals);
+    w->vals = NULL;
+    w->capacity = 0;
+    w->n = 0;
+}
+
+// Hands n values to SCIP, which keeps them only if they are feasible
+static SCIP_RETCODE _warm_try(SCIP *scip, SCIP_VAR **vars, SCIP_Real *vals, int n) {
+    SCIP_SOL *sol;
+    SCIP_Bool stored;
+    SCIP_RETCODE retcode;
+
+    SCIP_CALL( SCIPcreateSol(scip, &sol, NULL) );
+    if ((retcode = SCIPsetSolVals(scip, sol, n, vars, vals)) != SCIP_OKAY) {
+        SCIPfreeSol(scip, &sol);
+        return retcode;
+    }
+
+    // Unlike seeded primals, starts aren't checked beforehand
+    return SCIPtrySolFree(scip, &sol, FALSE, TRUE, TRUE, TRUE, &stored);
+}
+
+// Fills in the unknown values of a start by solving a copy of the problem
+// with the known ones fixed.  Running out of nodes, or finding the copy
+// infeasible, just means there is no start.
+static SCIP_RETCODE _warm_complete(py_scip_warm *w, SCIP *scip, SCIP_VAR **vars, int n) {
+    SCIP *sub = NULL;
+    SCIP_HASHMAP *varmap = NULL;
+    SCIP_VAR **tvars, **subvars;
+    SCIP_VAR *t, *s;
+    SCIP_Real *vals;
+    SCIP_Real v, lb, ub;
+    SCIP_Bool valid;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    int ntvars, i;
+
+    ntvars = SCIPgetNVars(scip);
+    tvars = SCIPgetVars(scip);
+    subvars = malloc((ntvars > 0 ? ntvars : 1) * sizeof(SCIP_VAR *));
+    vals = malloc((ntvars > 0 ? ntvars : 1) * sizeof(SCIP_Real));
+    if (subvars == NULL || vals == NULL) {
+        retcode = SCIP_NOMEMORY;
+        goto cleanup;
+    }
+
+    if ((retcode = SCIPcreate(&sub)) != SCIP_OKAY)
+        goto cleanup;
+    if ((retcode = SCIPhashmapCreate(&varmap, SCIPblkmem(sub), SCIPcalcHashtableSize(2 * ntvars))) != SCIP_OKAY)
+        goto cleanup;
+
+    // Plugins without copy callbacks, like ours, stay behind.  That's fine:
+    // whatever comes back is checked against the full problem anyway.
+    if ((retcode = SCIPcopy(scip, sub, varmap, NULL, "warmstart", TRUE, &valid)) != SCIP_OKAY)
+        goto cleanup;
+    for (i = 0; i < ntvars; i++) {
+        if ((subvars[i] = (SCIP_VAR *) SCIPhashmapGetImage(varmap, tvars[i])) == NULL)
+            goto cleanup;
+    }
+
+    sub->set->misc_catchctrlc = FALSE;
+    if ((retcode = SCIPsetIntParam(sub, "display/verblevel", 0)) != SCIP_OKAY ||
+        (retcode = SCIPsetLongintParam(sub, "limits/nodes", w->nodes)) != SCIP_OKAY ||
+        (retcode = SCIPsetIntParam(sub, "limits/solutions", 1)) != SCIP_OKAY)
+        goto cleanup;
+
+    for (i = 0; i < n; i++) {
+        v = w->vals[i];
+        if (Py_IS_NAN(v))
+            continue;
+        if ((retcode = SCIPgetTransformedVar(scip, vars[i], &t)) != SCIP_OKAY)
+            goto cleanup;
+        if (t == NULL || (s = (SCIP_VAR *) SCIPhashmapGetImage(varmap, t)) == NULL)
+            continue;
+
+        // Values just outside the bounds are clipped, not trusted to widen them
+        lb = SCIPvarGetLbGlobal(s);
+        ub = SCIPvarGetUbGlobal(s);
+        if (SCIPisFeasLT(sub, v, lb) || SCIPisFeasGT(sub, v, ub))
+            goto cleanup;
+        if (SCIPvarGetType(s) != SCIP_VARTYPE_CONTINUOUS)
+            v = floor(v + 0.5);
+        v = v < lb ? lb : (v > ub ? ub : v);
+
+        if ((retcode = SCIPchgVarLb(sub, s, v)) != SCIP_OKAY ||
+            (retcode = SCIPchgVarUb(sub, s, v)) != SCIP_OKAY)
+            goto cleanup;
+    }
+
+    if ((retcode = SCIPsolve(sub)) != SCIP_OKAY)
+        goto cleanup;
+    if (SCIPgetNSols(sub) > 0) {
+        if ((retcode = SCIPgetSolVals(sub, SCIPgetBestSol(sub), ntvars, subvars, vals)) != SCIP_OKAY)
+            goto cleanup;
+        retcode = _warm_try(scip, tvars, vals, ntvars);
+    }
+
+cleanup:
+    if (varmap != NULL) SCIPhashmapFree(&varmap);
+    if (sub != NULL) SCIPfree(&sub);
+    if (subvars != NULL) free(subvars);
+    if (vals != NULL) free(vals);
+    return retcode;
+}
+
+// Gives SCIP the start for the nvars variables of the original problem.
+// Doesn't need the interpreter, so it can run alongside SCIPsolve.
+static SCIP_RETCODE PyScipWarmSubmit(py_scip_warm *w, SCIP *scip, SCIP_VAR **vars, int nvars) {
+    bool partial;
+    int n, i;
+
+    n = w->n < nvars ? w->n : nvars;
+    if (n == 0)
+        return SCIP_OKAY;
+
+    partial = n < nvars;
+    for (i = 0; i < n && !partial; i++)
+        partial = Py_IS_NAN(w->vals[i]);
+    if (partial && w->nodes <= 0)
+        return SCIP_OKAY;
+
+    SCIP_CALL( SCIPtransformProb(scip) );
+    if (partial)
+        return _warm_complete(w, scip, vars, n);
+    return _warm_try(scip, vars, w->vals, n);
+}
+
+#endif
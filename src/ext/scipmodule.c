@@ -1,251 +1,1842 @@
 #include "python_zibopt.h"
+#include "python_zibopt_buffer.h"
+#include "python_zibopt_control.h"
 #include "python_zibopt_error.h"
+#include "python_zibopt_events.h"
+#include "python_zibopt_lazy.h"
+#include "python_zibopt_params.h"
+#include "python_zibopt_registry.h"
+#include "python_zibopt_scratch.h"
+#include "python_zibopt_snapshot.h"
+#include "python_zibopt_threads.h"
+#include "python_zibopt_types.h"
+#include "python_zibopt_warm.h"
 
 static PyObject *error;
+static py_scip_types scip_types; // filled in as each module loads
 
 /*****************************************************************************/
 /* PYTHON TYPE METHODS                                                       */
 /*****************************************************************************/
+static PyTypeObject solver_pool_type;
+
+static SCIP_RETCODE _solver_create_scip(SCIP **scip) {
+    // Initialize SCIP
+    SCIP_CALL( SCIPcreate(scip) );
+
+    // Default plugins, heuristics, etc
+    SCIP_CALL( SCIPincludeDefaultPlugins(*scip) );
+
+    // SCIPcreateProb Arguments:
+    // scip         SCIP data structure
+    // name         name of problem
+    // probdelorig  callback to free original problem data
+    // probtrans    callback to create transformed problem
+    // probdeltrans callback to free that transformed problem
+    // probinitsol  callback to create initial solution
+    // probexitsol  callback to free initial solution
+    // probcopy     callback to copy data to a subscip
+    // probdata     initial problem data (vars & constraints)
+    SCIP_CALL( SCIPcreateProb(*scip, "python-zibobt", NULL, NULL, NULL, NULL, NULL, NULL, NULL) );
+
+    // Keep SCIP from catching keyboard interrupts.  These go to python.
+    (*scip)->set->misc_catchctrlc = FALSE;
+    return SCIP_OKAY;
+}
+
+static int _pool_take(solver_pool *pool, SCIP **scip);
+static bool _pool_give(solver_pool *pool, SCIP *scip);
+static PyTypeObject preset_type;
+
 static PyObject *solver_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
     solver *self;
+    PyObject *pool = NULL;
+    SCIP_RETCODE retcode;
+
+    // Solvers from a pool start with a SCIP instance it already set up
+    if (kwds != NULL)
+        pool = PyDict_GetItemString(kwds, "pool");
+    if (pool == Py_None)
+        pool = NULL;
+    if (pool != NULL && !PyObject_TypeCheck(pool, &solver_pool_type)) {
+        PyErr_SetString(error, "invalid solver pool type");
+        return NULL;
+    }
+
     self = (solver *) type->tp_alloc(type, 0);
     if (self != NULL) {
-        // Initialize SCIP
-        PY_SCIP_CALL(error, NULL, SCIPcreate(&self->scip));
+        if (pool != NULL) {
+            if (_pool_take((solver_pool *) pool, &self->scip)) {
+                Py_DECREF(self);
+                return NULL;
+            }
+            Py_INCREF(pool);
+            self->pool = (solver_pool *) pool;
+        } else if ((retcode = _solver_create_scip(&self->scip)) != SCIP_OKAY) {
+            PyScipSetError(error, retcode);
+            Py_DECREF(self);
+            return NULL;
+        }
+        self->warm.nodes = PY_SCIP_WARM_NODES;
+        self->reuse_incumbent = true;
+
+        // The handler has to go in while the problem is still empty
+        if ((self->control = PyScipControlNew(error)) == NULL ||
+            PyScipControlAttach(error, self->scip, self->control)) {
+            Py_DECREF(self);
+            return NULL;
+        }
+    }
+
+    return (PyObject *) self;
+}
+
+static int solver_init(solver *self, PyObject *args, PyObject *kwds) {
+    static char *argnames[] = {"quiet", "pool", NULL};
+    bool quiet;
+    PyObject *pool; // handled by solver_new
+    
+    quiet = true;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|bO", argnames, &quiet, &pool))
+        return -1;
+
+    // Turn on/off solver chatter
+    if (quiet) {
+        PY_SCIP_CALL(error, -1, SCIPsetMessagehdlr(NULL));
+    } else {
+        PY_SCIP_CALL(error, -1, SCIPsetDefaultMessagehdlr());
+    }
+
+    return 0;
+}
+
+static int solver_traverse(solver *self, visitproc visit, void *arg) {
+    int result;
+    if ((result = PyScipRegistryTraverse(&self->vars, visit, arg)) != 0)
+        return result;
+    if ((result = PyScipRegistryTraverse(&self->conss, visit, arg)) != 0)
+        return result;
+    if (self->events != NULL)
+        Py_VISIT(self->events->callback);
+    if (self->lazy != NULL)
+        Py_VISIT(self->lazy->callback);
+    return 0;
+}
+
+static void _solver_orphan_wrappers(solver *self) {
+    // Python objects that outlive the solver must not pass for objects of
+    // whatever solver gets this SCIP instance next
+    variable *v;
+    constraint *c;
+    int i;
+    for (i = 0; self->vars.nwrappers > 0 && i < self->vars.size; i++) {
+        if ((v = (variable *) self->vars.wrappers[i]) != NULL) {
+            v->scip = NULL;
+            v->solv = NULL;
+            v->flyweight = NULL;
+        }
+    }
+    for (i = 0; self->conss.nwrappers > 0 && i < self->conss.size; i++) {
+        if ((c = (constraint *) self->conss.wrappers[i]) != NULL) {
+            c->scip = NULL;
+            c->solv = NULL;
+            c->flyweight = NULL;
+        }
+    }
+}
+
+static int solver_clear(solver *self) {
+    _solver_orphan_wrappers(self);
+    PyScipRegistryClearWrappers(&self->vars);
+    PyScipRegistryClearWrappers(&self->conss);
+    if (self->events != NULL) {
+        self->events->active = false;
+        Py_CLEAR(self->events->callback);
+    }
+    if (self->lazy != NULL)
+        Py_CLEAR(self->lazy->callback);
+    return 0;
+}
+
+static void solver_dealloc(solver *self) {
+    int i;
+
+    PyObject_GC_UnTrack(self);
+    if (self->weakreflist != NULL)
+        PyObject_ClearWeakRefs((PyObject *) self);
+    _solver_orphan_wrappers(self);
+
+    if (self->scip) {
+        // Free all variables
+        for (i = 0; i < self->vars.size; i++)
+            SCIPreleaseVar(self->scip, (SCIP_VAR **) &self->vars.handles[i]);
         
-        // Default plugins, heuristics, etc
-        PY_SCIP_CALL(error, NULL, SCIPincludeDefaultPlugins(self->scip));
+        // Free constraints
+        for (i = 0; i < self->conss.size; i++)
+            SCIPreleaseCons(self->scip, (SCIP_CONS **) &self->conss.handles[i]);
         
-        // SCIPcreateProb Arguments:
-        // scip         SCIP data structure
-        // name         name of problem
-        // probdelorig  callback to free original problem data
-        // probtrans    callback to create transformed problem
-        // probdeltrans callback to free that transformed problem
-        // probinitsol  callback to create initial solution
-        // probexitsol  callback to free initial solution
-        // probcopy     callback to copy data to a subscip
-        // probdata     initial problem data (vars & constraints)
-        PY_SCIP_CALL(error, NULL, 
-            SCIPcreateProb(self->scip, "python-zibobt", NULL, NULL, NULL, NULL, NULL, NULL, NULL)
-        );
-
-        // Keep SCIP from catching keyboard interrupts.  These go to python.
-        self->scip->set->misc_catchctrlc = FALSE;
+        // Plugin handlers outlive us in pooled instances
+        if (self->events != NULL)
+            PyScipEventsAttach(error, self->scip, NULL);
+        if (self->lazy != NULL)
+            PyScipLazyDetach(self->scip, self->lazy);
+        if (self->control != NULL)
+            PyScipControlAttach(error, self->scip, NULL);
+
+        // Free the solver itself, unless its pool can reuse it
+        if (self->pool == NULL || !_pool_give(self->pool, self->scip))
+            SCIPfree(&self->scip);
+        self->scip = NULL;
+    }
+    Py_CLEAR(self->pool);
+    if (self->events != NULL)
+        PyScipEventsFree(self->events);
+    if (self->lazy != NULL)
+        PyScipLazyFree(self->lazy);
+    if (self->control != NULL)
+        PyScipControlFree(self->control);
+
+    PyScipRegistryFree(&self->vars);
+    PyScipRegistryFree(&self->conss);
+    PyScipScratchFree(&self->scratch);
+    PyScipWarmFree(&self->warm);
+
+    ((PyObject *) self)->ob_type->tp_free(self);
+}
+
+static bool _constraint_active(PyObject *c) {
+    return ((constraint *) c)->active;
+}
+
+static PyObject* solver_getattr(solver *self, PyObject *attr_name) {
+    // Check and make sure we have a string as attribute name...
+    if (PyUnicode_Check(attr_name)) {
+        if (PyUnicode_CompareWithASCIIString(attr_name, "nvars") == 0)
+            return Py_BuildValue("i", SCIPgetNOrigVars(self->scip));
+        if (PyUnicode_CompareWithASCIIString(attr_name, "nsols") == 0)
+            return Py_BuildValue("i", SCIPgetNSols(self->scip));
+
+        // Python objects for variables and constraints in the problem
+        if (PyUnicode_CompareWithASCIIString(attr_name, "variables") == 0)
+            return PyScipRegistryWrappers(&self->vars, NULL);
+        if (PyUnicode_CompareWithASCIIString(attr_name, "constraints") == 0)
+            return PyScipRegistryWrappers(&self->conss, _constraint_active);
+    }
+    return PyObject_GenericGetAttr((PyObject *) self, attr_name);
+}
+
+/*****************************************************************************/
+/* ADDITONAL METHODS                                                         */
+/*****************************************************************************/
+static int _seed_primal(solver *self, PyObject *solution) {
+    // Extracts data for a primal solution and hands it to SCIP.  Variables
+    // missing from the dict are zero.
+    PyObject *key, *value;
+    Py_ssize_t pos;
+    double d;
+    SCIP_Bool feasible, stored;
+    SCIP_SOL *sol = NULL;
+    SCIP_RETCODE retcode;
+
+    if (solution == NULL || PyObject_Length(solution) == 0)
+        return 0;
+
+    PY_SCIP_CALL(error, -1, SCIPtransformProb(self->scip));
+    PY_SCIP_CALL(error, -1, SCIPcreateSol(self->scip, &sol, NULL));
+
+    // Check each entry and add it to the solution in the same pass
+    pos = 0;
+    while (PyDict_Next(solution, &pos, &key, &value)) {
+        // Check and make sure we have a real variable type
+        if (!PyScipVariable_Check(key)) {
+            PyErr_SetString(error, "invalid variable type");
+            goto cleanup;
+        }
+        
+        // Verify that the variable is associated with this solver
+        if (((variable *) key)->scip != self->scip) {
+            PyErr_SetString(error, "variable not associated with solver");
+            goto cleanup;
+        }
+    
+        // Check and make sure we have a number as the value
+        if (PyFloat_Check(value))
+            d = PyFloat_AsDouble(value);
+        else if (PyLong_Check(value))
+            d = (double) PyLong_AsLong(value);
+        else {
+            PyErr_SetString(error, "solution values must be numeric");
+            goto cleanup;
+        }
+        
+        // Only set nonzero values
+        if (d && (retcode = SCIPsetSolVal(self->scip, sol, ((variable *) key)->variable, d)) != SCIP_OKAY) {
+            PyScipSetError(error, retcode);
+            goto cleanup;
+        }
+    }
+
+    if ((retcode = SCIPcheckSolOrig(self->scip, sol, &feasible, TRUE, FALSE)) != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+    if (!feasible) {
+        PyErr_SetString(error, "infeasible primal solution");
+        goto cleanup;
+    }
+    
+    // SCIPtrySolFree Arguments:
+    // scip 	        SCIP data structure
+    // sol           	pointer to primal CIP solution; is cleared in function call
+    // printreason      should all reasons of violations be printed
+    // checkbounds 	    should the bounds of the variables be checked?
+    // checkintegrality has integrality to be checked?
+    // checklprows 	    have current LP rows to be checked?
+    // stored           stores whether solution was feasible and good enough to keep 
+    //
+    // The solution was already checked, so stored is only false when it
+    // isn't good enough to keep.  That isn't an error.
+    PY_SCIP_CALL(error, -1, SCIPtrySolFree(self->scip, &sol, FALSE, FALSE, FALSE, FALSE, &stored));
+    return 0;
+
+cleanup:
+    SCIPfreeSol(self->scip, &sol);
+    return -1;
+}
+
+static void _set_limits(solver *self, double time, double gap, double absgap, int nsol, double memory) {
+    // Set timeout & gap values, etc.  Past memory/savefac of the memory
+    // limit SCIP switches node selection to memory saving mode.
+    SCIPclockReset(self->scip->stat->solvingtime);
+    self->scip->set->limit_time   = time;
+    self->scip->set->limit_gap    = gap;
+    self->scip->set->limit_absgap = absgap;
+    self->scip->set->limit_solutions = nsol;
+    self->scip->set->limit_memory = memory;
+}
+
+static int _optimize(solver *self, PyObject *args, PyObject *kwds) {
+    // Runs components of max/min that are the same
+    static char *argnames[] = {"solution", "time", "gap", "absgap", "nsol", "offset", "memory", NULL};
+    PyObject *solution;
+    double time   = SCIP_DEFAULT_LIMIT_TIME;
+    double gap    = SCIP_DEFAULT_LIMIT_GAP;
+    double absgap = SCIP_DEFAULT_LIMIT_GAP;
+    int nsol      = SCIP_DEFAULT_LIMIT_SOLUTIONS;
+    double offset = 0;
+    double memory = SCIP_DEFAULT_LIMIT_MEMORY;
+    
+    bool fresh;
+    SCIP_RETCODE retcode;
+    
+    // See if we were given a primal solution dict
+    solution = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O!dddidd", argnames, &PyDict_Type, &solution, &time, &gap, &absgap, &nsol, &offset, &memory))
+        return 0;
+    self->portfolio.valid = false;
+
+    // The transformed problem is kept between solves when the objective
+    // doesn't change, so a solve stopped by a limit or an interrupt goes
+    // on from where it was.  A finished one would just hand back the old
+    // result, even if parameters or the warm start changed since, so it
+    // starts over.  So does seeding a primal or changing the offset.
+    if ((solution && PyObject_Length(solution) > 0) || self->scip->origprob->objoffset != offset ||
+        SCIPgetStage(self->scip) == SCIP_STAGE_SOLVED)
+        PY_SCIP_CALL(error, 0, SCIPfreeTransform(self->scip));
+
+    // A fresh transformed problem has lost every solution SCIP found
+    // before, so that's when the warm start goes in
+    fresh = SCIPgetStage(self->scip) == SCIP_STAGE_PROBLEM;
+
+    if (_seed_primal(self, solution))
+        return 0;
+
+    _set_limits(self, time, gap, absgap, nsol, memory);
+    self->scip->origprob->objoffset = offset;
+    
+    if (PyScipEventsStart(error, self->events))
+        return 0;
+    PyScipControlStart(self->control, self->scip);
+
+    // This calls the actual optimization routine.  SCIP doesn't need the
+    // interpreter, so let other Python threads (and solvers) run meanwhile.
+    self->solving = true;
+    Py_BEGIN_ALLOW_THREADS
+    retcode = SCIP_OKAY;
+    if (fresh)
+        retcode = PyScipWarmSubmit(&self->warm, self->scip, SCIPgetOrigVars(self->scip), SCIPgetNOrigVars(self->scip));
+    if (retcode == SCIP_OKAY)
+        retcode = SCIPsolve(self->scip);
+    PyScipControlStop(self->control);
+    PyScipEventsStop(self->events);
+    Py_END_ALLOW_THREADS
+    self->solving = false;
+
+    // Both run, so neither error lingers into the next solve
+    if (PyScipEventsFinish(self->events) | PyScipLazyFinish(self->lazy))
+        return 0;
+    PY_SCIP_CALL(error, 0, retcode);
+
+    if (self->reuse_incumbent)
+        PyScipWarmSave(error, &self->warm, self->scip, SCIPgetOrigVars(self->scip), SCIPgetNOrigVars(self->scip));
+    
+    return 0;
+}
+
+static int _set_objsense(solver *self, SCIP_OBJSENSE sense) {
+    // SCIP only allows changing the objective sense on the original
+    // problem, so only restart if we actually have to change it.
+    if (SCIPgetObjsense(self->scip) != sense) {
+        PY_SCIP_CALL(error, -1, SCIPfreeTransform(self->scip));
+        PY_SCIP_CALL(error, -1, SCIPsetObjsense(self->scip, sense));
+    }
+    return 0;
+}
+
+static PyObject *solver_maximize(solver *self, PyObject *args, PyObject *kwds) {
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (_set_objsense(self, SCIP_OBJSENSE_MAXIMIZE))
+        return NULL;
+    _optimize(self, args, kwds);
+    if (PyErr_Occurred())
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_minimize(solver *self, PyObject *args, PyObject *kwds) {
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (_set_objsense(self, SCIP_OBJSENSE_MINIMIZE))
+        return NULL;
+    _optimize(self, args, kwds);
+    if (PyErr_Occurred())
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_restart(solver *self) {
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    PY_SCIP_CALL(error, NULL, SCIPfreeTransform(self->scip));
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_set_callback(solver *self, PyObject *args, PyObject *kwds) {
+    // Streams incumbents, and every nth solved node, to callback.  It gets
+    // lists of at most about batch snapshots.  None turns it off.
+    static char *argnames[] = {"callback", "batch", "nodes", NULL};
+    PyObject *callback, *old;
+    int batch = 1;
+    int nodes = 0;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ii", argnames, &callback, &batch, &nodes))
+        return NULL;
+
+    if (callback != Py_None && !PyCallable_Check(callback)) {
+        PyErr_SetString(error, "callback must be callable");
+        return NULL;
+    }
+
+    if (self->events == NULL) {
+        if (callback == Py_None)
+            Py_RETURN_NONE;
+        if ((self->events = PyScipEventsNew(error)) == NULL)
+            return NULL;
+    }
+
+    if (PyScipEventsAttach(error, self->scip, self->events))
+        return NULL;
+
+    old = self->events->callback;
+    if (callback == Py_None) {
+        self->events->callback = NULL;
+    } else {
+        Py_INCREF(callback);
+        self->events->callback = callback;
+    }
+    Py_XDECREF(old);
+
+    self->events->active = self->events->callback != NULL;
+    self->events->batch = batch > 0 ? batch : 1;
+    self->events->nodes = nodes;
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_set_lazy(solver *self, PyObject *args, PyObject *kwds) {
+    // Has callback generate rows at integral LP solutions, and at
+    // fractional ones too if asked.  None turns it off.
+    static char *argnames[] = {"callback", "fractional", NULL};
+    PyObject *callback, *old;
+    bool fractional = false;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|b", argnames, &callback, &fractional))
+        return NULL;
+
+    if (callback != Py_None && !PyCallable_Check(callback)) {
+        PyErr_SetString(error, "callback must be callable");
+        return NULL;
+    }
+
+    if (self->lazy == NULL) {
+        if (callback == Py_None)
+            Py_RETURN_NONE;
+        if ((self->lazy = PyScipLazyNew(error)) == NULL)
+            return NULL;
+    }
+
+    old = self->lazy->callback;
+    if (callback == Py_None) {
+        self->lazy->callback = NULL;
+    } else {
+        Py_INCREF(callback);
+        self->lazy->callback = callback;
+    }
+    self->lazy->fractional = fractional;
+
+    if (PyScipLazyUpdate(error, self->scip, self->lazy)) {
+        self->lazy->callback = old;
+        Py_XDECREF(callback == Py_None ? NULL : callback);
+        return NULL;
+    }
+    Py_XDECREF(old);
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_set_objective(solver *self, PyObject *terms) {
+    // Sets linear objective coefficients from a dict of expression terms,
+    // like {(x,): 2.0, (y,): 3.0}, or from a linear expression.  Variables
+    // that don't appear get zero coefficients.  Only coefficients that
+    // actually change are sent to SCIP.  Any change at all frees the
+    // transformed problem, since SCIP only changes the original one.
+    PyObject *key, *value;
+    Py_ssize_t pos;
+    SCIP_VAR **vars;
+    SCIP_Real *obj = NULL;  // new objective, by variable index
+    int *changed = NULL;    // indices of variables whose coefficient changes
+    int i, nvars, nchanged;
+    SCIP_RETCODE retcode;
+
+    linear_expr *e = NULL;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+
+    if (PyScipLinearExpr_Check(terms)) {
+        e = (linear_expr *) terms;
+        if (e->solv != self) {
+            PyErr_SetString(error, "variable not associated with solver");
+            return NULL;
+        }
+    } else if (!PyDict_Check(terms)) {
+        PyErr_SetString(error, "objective terms must be a dict");
+        return NULL;
+    }
+
+    vars = SCIPgetOrigVars(self->scip);
+    nvars = SCIPgetNOrigVars(self->scip);
+
+    obj = calloc(nvars > 0 ? nvars : 1, sizeof(SCIP_Real));
+    changed = malloc((nvars > 0 ? nvars : 1) * sizeof(int));
+    if (obj == NULL || changed == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto error;
+    }
+
+    // Registry indices are problem indices, and the constant is the offset
+    for (i = 0; e != NULL && i < e->nterms; i++) {
+        if (e->indices[i] < 0 || e->indices[i] >= nvars) {
+            PyErr_SetString(error, "variable index out of range");
+            goto error;
+        }
+        obj[e->indices[i]] += e->coefs[i];
+    }
+
+    pos = 0;
+    while (e == NULL && PyDict_Next(terms, &pos, &key, &value)) {
+        PyObject *v;
+
+        // Skip the constant, which is handled as the objective offset
+        if (!PyTuple_Check(key) || PyTuple_GET_SIZE(key) > 1) {
+            PyErr_SetString(error, "objective functions must be linear");
+            goto error;
+        }
+        if (PyTuple_GET_SIZE(key) == 0)
+            continue;
+
+        // Check and make sure we have a real variable type
+        v = PyTuple_GET_ITEM(key, 0);
+        if (!PyScipVariable_Check(v)) {
+            PyErr_SetString(error, "invalid variable type");
+            goto error;
+        }
+
+        // Verify that the variable is associated with this solver
+        if (((variable *) v)->scip != self->scip) {
+            PyErr_SetString(error, "variable not associated with solver");
+            goto error;
+        }
+
+        if (!(PyFloat_Check(value) || PyLong_Check(value))) {
+            PyErr_SetString(error, "invalid objective coefficient");
+            goto error;
+        }
+
+        obj[SCIPvarGetProbindex(((variable *) v)->variable)] += PyFloat_AsDouble(value);
+    }
+
+    // Sparse diff against what SCIP already has
+    nchanged = 0;
+    for (i = 0; i < nvars; i++) {
+        if (obj[i] != SCIPvarGetObj(vars[i]))
+            changed[nchanged++] = i;
+    }
+
+    if (nchanged > 0) {
+        // Objective coefficients can only be changed on the original problem
+        retcode = SCIPfreeTransform(self->scip);
+        for (i = 0; retcode == SCIP_OKAY && i < nchanged; i++)
+            retcode = SCIPchgVarObj(self->scip, vars[changed[i]], obj[changed[i]]);
+        if (retcode != SCIP_OKAY) {
+            PyScipSetError(error, retcode);
+            goto error;
+        }
+    }
+
+    free(obj);
+    free(changed);
+    return Py_BuildValue("i", nchanged);
+
+error:
+    if (obj != NULL) free(obj);
+    if (changed != NULL) free(changed);
+    return NULL;
+}
+
+static PyObject *solver_wrapper(solver *self, PyObject *arg) {
+    // Returns the Python variable at a registry index, or None if there
+    // isn't one yet
+    PyObject *v;
+    long i;
+
+    if (!PyLong_Check(arg)) {
+        PyErr_SetString(error, "variable index must be an integer");
+        return NULL;
+    }
+
+    i = PyLong_AsLong(arg);
+    if (i < 0 || i >= self->vars.size) {
+        PyErr_SetString(PyExc_IndexError, "variable index out of range");
+        return NULL;
+    }
+
+    v = self->vars.wrappers[i];
+    if (v == NULL)
+        Py_RETURN_NONE;
+
+    Py_INCREF(v);
+    return v;
+}
+
+static PyObject *solver_read(solver *self, PyObject *args) {
+    // Reads a problem file into an empty solver and registers what it
+    // brings in.  Returns (nvars, nconss).  format is a SCIP reader's file
+    // extension, or None to go by the file name.
+    const char *path, *format = NULL;
+    SCIP_VAR **vars;
+    SCIP_CONS **conss;
+    SCIP_RETCODE retcode;
+    int i, nvars, nconss;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "s|z", &path, &format))
+        return NULL;
+
+    // SCIPreadProb replaces the problem, and with it everything we hold
+    if (self->vars.size > 0 || self->conss.size > 0 || (self->lazy != NULL && self->lazy->cons != NULL)) {
+        PyErr_SetString(error, "problems can only be read into an empty solver");
+        return NULL;
+    }
+
+    // Readers don't need the interpreter, and big files take a while
+    PyScipControlBusy(self->control, self->scip);
+    self->solving = true;
+    Py_BEGIN_ALLOW_THREADS
+    retcode = SCIPreadProb(self->scip, path, format);
+    PyScipControlStop(self->control);
+    Py_END_ALLOW_THREADS
+    self->solving = false;
+    PY_SCIP_CALL(error, NULL, retcode);
+
+    nvars = SCIPgetNOrigVars(self->scip);
+    nconss = SCIPgetNOrigConss(self->scip);
+    if (PyScipRegistryReserve(error, &self->vars, nvars) ||
+        PyScipRegistryReserve(error, &self->conss, nconss))
+        return NULL;
+
+    // Room was reserved above, so adding can't fail.  Python wrappers are
+    // only built for entries that are looked at.
+    vars = SCIPgetOrigVars(self->scip);
+    for (i = 0; i < nvars; i++) {
+        PY_SCIP_CALL(error, NULL, SCIPcaptureVar(self->scip, vars[i]));
+        PyScipRegistryAdd(error, &self->vars, vars[i], NULL);
+    }
+
+    conss = SCIPgetOrigConss(self->scip);
+    for (i = 0; i < nconss; i++) {
+        PY_SCIP_CALL(error, NULL, SCIPcaptureCons(self->scip, conss[i]));
+        PyScipRegistryAdd(error, &self->conss, conss[i], NULL);
+    }
+
+    return Py_BuildValue("(ii)", nvars, nconss);
+}
+
+static PyObject *solver_write(solver *self, PyObject *args) {
+    // Writes the problem as given, not as presolved.  format picks the
+    // writer as in solver_read.  generic replaces names with x1, c1, ...
+    const char *path, *format = NULL;
+    bool generic = false;
+    SCIP_RETCODE retcode;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "s|zb", &path, &format, &generic))
+        return NULL;
+
+    PyScipControlBusy(self->control, self->scip);
+    self->solving = true;
+    Py_BEGIN_ALLOW_THREADS
+    retcode = SCIPwriteOrigProblem(self->scip, path, format, generic);
+    PyScipControlStop(self->control);
+    Py_END_ALLOW_THREADS
+    self->solving = false;
+    PY_SCIP_CALL(error, NULL, retcode);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_save_snapshot(solver *self, PyObject *args) {
+    const char *path;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "s", &path))
+        return NULL;
+
+    if (PyScipSnapshotSave(error, self->scip, path))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_interrupt(solver *self) {
+    // Stops a running maximize or minimize early.  Meant to be called from
+    // other threads, so it doesn't check whether the solver is busy.
+    if (PyScipControlInterrupt(self->control, self->scip))
+        Py_RETURN_TRUE;
+    Py_RETURN_FALSE;
+}
+
+static PyObject *solver_memory_usage(solver *self) {
+    // Returns bytes of SCIP block memory in use.  Like interrupt, this is
+    // meant to work from other threads while a solve is running.
+    return PyLong_FromLongLong(PyScipControlMemory(self->control, self->scip));
+}
+
+static int _limit_arg(PyObject *obj, double *d) {
+    // None keeps a limit.  Returns 1 if obj holds a new one, or -1.
+    if (obj == NULL || obj == Py_None)
+        return 0;
+    *d = PyFloat_AsDouble(obj);
+    if (*d == -1 && PyErr_Occurred()) {
+        PyErr_Clear();
+        PyErr_SetString(error, "limits must be numeric");
+        return -1;
+    }
+    return 1;
+}
+
+static PyObject *solver_load_snapshot(solver *self, PyObject *arg) {
+    // Adds the model in a snapshot buffer, like a memory-mapped file.
+    // Returns (var start, nvars, constraint start, nconss).
+    Py_buffer view;
+    int vstart, cstart, rc;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (PyObject_GetBuffer(arg, &view, PyBUF_SIMPLE) < 0) {
+        PyErr_Clear();
+        PyErr_SetString(error, "snapshot must be a buffer");
+        return NULL;
+    }
+
+    vstart = self->vars.size;
+    cstart = self->conss.size;
+    rc = PyScipSnapshotLoad(error, self, (const char *) view.buf, view.len);
+    PyBuffer_Release(&view);
+    if (rc)
+        return NULL;
+
+    return Py_BuildValue("(iiii)", vstart, self->vars.size - vstart, cstart, self->conss.size - cstart);
+}
+
+static PyObject *solver_set_limits(solver *self, PyObject *args, PyObject *kwds) {
+    // Changes limits of a running maximize or minimize from another thread.
+    // They take effect after SCIP's next LP solve or node.
+    static char *argnames[] = {"time", "gap", "absgap", "nsol", "memory", NULL};
+    PyObject *t = NULL, *g = NULL, *a = NULL, *n = NULL, *m = NULL;
+    double time, gap, absgap, memory, d;
+    int nsol, ht, hg, ha, hn, hm;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OOOOO", argnames, &t, &g, &a, &n, &m))
+        return NULL;
+    if ((ht = _limit_arg(t, &time)) < 0 || (hg = _limit_arg(g, &gap)) < 0 ||
+        (ha = _limit_arg(a, &absgap)) < 0 || (hn = _limit_arg(n, &d)) < 0 ||
+        (hm = _limit_arg(m, &memory)) < 0)
+        return NULL;
+    if (hn) {
+        if (!(d >= INT_MIN && d <= INT_MAX)) {
+            PyErr_SetString(error, "nsol is out of range");
+            return NULL;
+        }
+        nsol = (int) d;
+    }
+
+    if (PyScipControlLimits(self->control, ht ? &time : NULL, hg ? &gap : NULL, ha ? &absgap : NULL,
+        hn ? &nsol : NULL, hm ? &memory : NULL))
+        Py_RETURN_TRUE;
+    Py_RETURN_FALSE;
+}
+
+static PyObject *solver_set_start(solver *self, PyObject *args, PyObject *kwds) {
+    // Sets the start for the next solve from an array of doubles, one per
+    // variable.  NaN entries, and variables past the end, get filled in by
+    // a sub-SCIP with at most nodes nodes.  None drops the start.
+    static char *argnames[] = {"values", "nodes", NULL};
+    PyObject *obj;
+    py_scip_array values;
+    PY_LONG_LONG nodes = PY_SCIP_WARM_NODES;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|L", argnames, &obj, &nodes))
+        return NULL;
+
+    // SCIP only takes solutions for the transformed problem it has, and
+    // that one may already be solved
+    PY_SCIP_CALL(error, NULL, SCIPfreeTransform(self->scip));
+    self->warm.nodes = nodes;
+
+    if (obj == Py_None) {
+        PyScipWarmClear(&self->warm);
+        Py_RETURN_NONE;
+    }
+
+    if (PyScipArrayGet(error, obj, &values, "values", false, false))
+        return NULL;
+    if (PyScipArrayReals(&values) == NULL || values.size > SCIPgetNOrigVars(self->scip)) {
+        PyScipArrayRelease(&values);
+        PyErr_Format(error, "values must be an array of at most %d doubles", SCIPgetNOrigVars(self->scip));
+        return NULL;
+    }
+
+    if (PyScipWarmSet(error, &self->warm, PyScipArrayReals(&values), (int) values.size)) {
+        PyScipArrayRelease(&values);
+        return NULL;
+    }
+
+    PyScipArrayRelease(&values);
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_solutions_into(solver *self, PyObject *args) {
+    // Writes the best k stored solutions into a k by nvars row-major array
+    // of doubles, and their objective values into an array of k doubles.
+    // Returns how many rows were written, since SCIP may have fewer.
+    PyObject *o, *obj;
+    py_scip_array out, objectives;
+    SCIP_SOL **sols;
+    SCIP_Real *values;
+    SCIP_RETCODE retcode;
+    Py_ssize_t k;
+    int i, nsols, nvars;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "OO", &o, &obj))
+        return NULL;
+
+    if (PyScipArrayGet(error, obj, &objectives, "objectives", false, true))
+        return NULL;
+    if (PyScipArrayReals(&objectives) == NULL) {
+        PyScipArrayRelease(&objectives);
+        PyErr_SetString(error, "objectives must be an array of doubles");
+        return NULL;
+    }
+
+    k = objectives.size;
+    nvars = SCIPgetNOrigVars(self->scip);
+    if (PyScipArrayGet(error, o, &out, "out", false, true)) {
+        PyScipArrayRelease(&objectives);
+        return NULL;
+    }
+    if (PyScipArrayReals(&out) == NULL || out.size != k * nvars) {
+        PyScipArrayRelease(&objectives);
+        PyScipArrayRelease(&out);
+        PyErr_Format(error, "out must be an array of %zd doubles", k * nvars);
+        return NULL;
+    }
+
+    // SCIP keeps its solutions sorted best first
+    sols = SCIPgetSols(self->scip);
+    nsols = SCIPgetNSols(self->scip);
+    if (nsols > k)
+        nsols = (int) k;
+
+    values = PyScipArrayReals(&out);
+    for (i = 0; i < nsols; i++) {
+        retcode = SCIPgetSolVals(self->scip, sols[i], nvars, SCIPgetOrigVars(self->scip), values + (Py_ssize_t) i * nvars);
+        if (retcode != SCIP_OKAY) {
+            PyScipArrayRelease(&objectives);
+            PyScipArrayRelease(&out);
+            PyScipSetError(error, retcode);
+            return NULL;
+        }
+        PyScipArrayReals(&objectives)[i] = SCIPgetSolOrigObj(self->scip, sols[i]) + self->scip->origprob->objoffset;
+    }
+
+    PyScipArrayRelease(&objectives);
+    PyScipArrayRelease(&out);
+    return Py_BuildValue("i", nsols);
+}
+
+// Adds one entry per plugin of a type to stats[key], as name: (calls,
+// time, found).  What counts as found depends on the type of plugin.
+#define PY_SCIP_PLUGIN_STATS(key, count, plugins, ncalls, gettime, nfound) \
+    do { \
+        PyObject *_d_ = PyDict_New(); \
+        if (_d_ == NULL || PyDict_SetItemString(stats, key, _d_)) { \
+            Py_XDECREF(_d_); \
+            goto cleanup; \
+        } \
+        Py_DECREF(_d_); \
+        for (i = 0; i < set->count; i++) { \
+            o = Py_BuildValue("(LdL)", (PY_LONG_LONG) (ncalls), (double) gettime(set->plugins[i]), (PY_LONG_LONG) (nfound)); \
+            if (o == NULL || PyDict_SetItemString(_d_, set->plugins[i]->name, o)) \
+                goto cleanup; \
+            Py_CLEAR(o); \
+        } \
+    } while (FALSE)
+
+static PyObject *solver_statistics(solver *self) {
+    // Copies counters and clocks out of SCIP in one go.  Nothing here
+    // changes SCIP's state, so it's cheap to call after every solve.
+    SCIP_SET *set = self->scip->set;
+    SCIP_STAT *stat = self->scip->stat;
+    PyObject *stats, *o = NULL;
+    int i;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+
+    stats = Py_BuildValue(
+        "{s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:d,"
+        "s:L,s:L,s:L,s:L,s:L,s:L,s:i,s:i}",
+        "solving_time",          SCIPclockGetTime(stat->solvingtime),
+        "presolving_time",       SCIPclockGetTime(stat->presolvingtime),
+        "lp_time",               SCIPclockGetTime(stat->lpsoltime),
+        "primal_lp_time",        SCIPclockGetTime(stat->primallptime),
+        "dual_lp_time",          SCIPclockGetTime(stat->duallptime),
+        "diving_lp_time",        SCIPclockGetTime(stat->divinglptime),
+        "strong_branching_time", SCIPclockGetTime(stat->strongbranchtime),
+        "conflict_lp_time",      SCIPclockGetTime(stat->conflictlptime),
+        "pseudo_solution_time",  SCIPclockGetTime(stat->pseudosoltime),
+        "node_activation_time",  SCIPclockGetTime(stat->nodeactivationtime),
+        "nodes",                 (PY_LONG_LONG) stat->nnodes,
+        "total_nodes",           (PY_LONG_LONG) stat->ntotalnodes,
+        "lps",                   (PY_LONG_LONG) stat->nlps,
+        "lp_iterations",         (PY_LONG_LONG) stat->nlpiterations,
+        "primal_lp_iterations",  (PY_LONG_LONG) stat->nprimallpiterations,
+        "dual_lp_iterations",    (PY_LONG_LONG) stat->nduallpiterations,
+        "runs",                  stat->nruns,
+        "max_depth",             stat->maxdepth
+    );
+    if (stats == NULL)
+        return NULL;
+
+    // SCIP aborts on bounds of a problem it hasn't transformed yet
+    if (PY_SCIP_PORTFOLIO_OUTCOME(self))
+        o = Py_BuildValue("(ddd)", self->portfolio.primal, self->portfolio.dual, self->portfolio.gap);
+    else if (SCIPgetStage(self->scip) >= SCIP_STAGE_TRANSFORMED)
+        o = Py_BuildValue("(ddd)", SCIPgetPrimalbound(self->scip), SCIPgetDualbound(self->scip), SCIPgetGap(self->scip));
+    else
+        o = Py_BuildValue("(OOO)", Py_None, Py_None, Py_None);
+    if (o == NULL ||
+        PyDict_SetItemString(stats, "primal_bound", PyTuple_GET_ITEM(o, 0)) ||
+        PyDict_SetItemString(stats, "dual_bound", PyTuple_GET_ITEM(o, 1)) ||
+        PyDict_SetItemString(stats, "gap", PyTuple_GET_ITEM(o, 2)))
+        goto cleanup;
+    Py_CLEAR(o);
+
+    PY_SCIP_PLUGIN_STATS("branching", nbranchrules, branchrules,
+        SCIPbranchruleGetNLPCalls(set->branchrules[i]) + SCIPbranchruleGetNExternCalls(set->branchrules[i]) +
+            SCIPbranchruleGetNPseudoCalls(set->branchrules[i]),
+        SCIPbranchruleGetTime, SCIPbranchruleGetNChildren(set->branchrules[i]));
+    PY_SCIP_PLUGIN_STATS("heuristics", nheurs, heurs,
+        SCIPheurGetNCalls(set->heurs[i]), SCIPheurGetTime, SCIPheurGetNSolsFound(set->heurs[i]));
+    PY_SCIP_PLUGIN_STATS("presolvers", npresols, presols,
+        SCIPpresolGetNCalls(set->presols[i]), SCIPpresolGetTime, SCIPpresolGetNFixedVars(set->presols[i]));
+    PY_SCIP_PLUGIN_STATS("propagators", nprops, props,
+        SCIPpropGetNCalls(set->props[i]), SCIPpropGetTime, SCIPpropGetNDomredsFound(set->props[i]));
+    PY_SCIP_PLUGIN_STATS("separators", nsepas, sepas,
+        SCIPsepaGetNCalls(set->sepas[i]), SCIPsepaGetTime, SCIPsepaGetNCutsFound(set->sepas[i]));
+
+    // SCIP doesn't keep a bound history, so the control handler does
+    if ((o = PyScipControlHistory(self->control)) == NULL || PyDict_SetItemString(stats, "history", o))
+        goto cleanup;
+    Py_CLEAR(o);
+
+    return stats;
+
+cleanup:
+    Py_XDECREF(o);
+    Py_DECREF(stats);
+    return NULL;
+}
+
+#undef PY_SCIP_PLUGIN_STATS
+
+static PyObject *solver_unconstrain(solver *self, PyObject *c) {
+    // Removes a constraint from the solver
+    constraint *cons; // constraint C object
+
+    // Check constraint type
+    if (!PyScipConstraint_Check(c)) {
+        PyErr_SetString(error, "invalid constraint type");
+        return NULL;
+    }
+    
+    cons = (constraint *) c;
+    if (cons->scip != self->scip) {
+        PyErr_SetString(error, "constraint not associated with solver");
+        return NULL;
+    }
+
+    // Nothing to do if the constraint isn't part of the problem.  It stays
+    // in the registry either way, so it can be added back later.
+    if (!cons->active)
+        Py_RETURN_NONE;
+
+    // Restart solver prior to removing the constraint so state is ok
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    PY_SCIP_CALL(error, NULL, SCIPfreeTransform(self->scip));
+    PY_SCIP_CALL(error, NULL, SCIPdelCons(self->scip, cons->constraint));
+    cons->active = false;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_change_constraints(solver *self, PyObject *args) {
+    // Removes and then adds sequences of constraints, with at most one
+    // reset of the transformed problem for all of them.  Constraints that
+    // are already where they should be cost nothing, and if all of them
+    // are, the transformed problem is kept.  Returns the number changed.
+    //
+    // SCIPenableCons/SCIPdisableCons only act on transformed constraints
+    // while solving, and presolving may already have used a constraint, so
+    // they can't stand in for the reset between solves.
+    PyObject *add_obj, *remove_obj, *add = NULL, *remove = NULL;
+    PyObject **items;
+    constraint *cons;
+    Py_ssize_t i, n;
+    int pass, nchanged = 0;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    PyObject *result = NULL;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    if (!PyArg_ParseTuple(args, "OO", &add_obj, &remove_obj))
+        return NULL;
+
+    if ((add = PySequence_Fast(add_obj, "constraints to add must be a sequence")) == NULL ||
+        (remove = PySequence_Fast(remove_obj, "constraints to remove must be a sequence")) == NULL)
+        goto cleanup;
+
+    // Check everything before changing anything
+    for (pass = 0; pass < 2; pass++) {
+        n = PySequence_Fast_GET_SIZE(pass ? add : remove);
+        items = PySequence_Fast_ITEMS(pass ? add : remove);
+        for (i = 0; i < n; i++) {
+            if (!PyScipConstraint_Check(items[i])) {
+                PyErr_SetString(error, "invalid constraint type");
+                goto cleanup;
+            }
+            cons = (constraint *) items[i];
+            if (cons->scip != self->scip) {
+                PyErr_SetString(error, "constraint not associated with solver");
+                goto cleanup;
+            }
+            if (cons->active != (pass == 1))
+                nchanged++;
+        }
+    }
+
+    if (nchanged == 0)
+        goto done;
+
+    // Removals first, so a constraint in both ends up added
+    retcode = SCIPfreeTransform(self->scip);
+    nchanged = 0;
+    for (pass = 0; pass < 2 && retcode == SCIP_OKAY; pass++) {
+        n = PySequence_Fast_GET_SIZE(pass ? add : remove);
+        items = PySequence_Fast_ITEMS(pass ? add : remove);
+        for (i = 0; i < n && retcode == SCIP_OKAY; i++) {
+            cons = (constraint *) items[i];
+            if (cons->active == (pass == 1))
+                continue;
+
+            if (pass == 0)
+                retcode = SCIPdelCons(self->scip, cons->constraint);
+            else
+                retcode = SCIPaddCons(self->scip, cons->constraint);
+            if (retcode == SCIP_OKAY) {
+                cons->active = pass == 1;
+                nchanged++;
+            }
+        }
+    }
+
+    if (retcode != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+
+done:
+    result = Py_BuildValue("i", nchanged);
+
+cleanup:
+    Py_XDECREF(add);
+    Py_XDECREF(remove);
+    return result;
+}
+
+// Functions for pulling out lists of setting names by type
+PY_SCIP_SETTING_NAMES(branching_names, nbranchrules, branchrules);
+PY_SCIP_SETTING_NAMES(conflict_names, nconflicthdlrs, conflicthdlrs);
+PY_SCIP_SETTING_NAMES(display_names, ndisps, disps);
+PY_SCIP_SETTING_NAMES(heuristic_names, nheurs, heurs);
+PY_SCIP_SETTING_NAMES(presolver_names, npresols, presols);
+PY_SCIP_SETTING_NAMES(propagator_names, nprops, props);
+PY_SCIP_SETTING_NAMES(selector_names, nnodesels, nodesels);
+PY_SCIP_SETTING_NAMES(separator_names, nsepas, sepas);
+
+/*****************************************************************************/
+/* PARAMETER PRESETS                                                         */
+/*****************************************************************************/
+// A preset is a profile of parameters compiled once into a table of types
+// and converted values.  Applying it is a loop of SCIPsetXxxParam calls,
+// without name conversions or Python objects, so pools and portfolio
+// workers can re-apply whole profiles for every solve.
+
+static bool _params_check(PyObject *params) {
+    // Sets an error unless params is a dict of parameters or a preset
+    if (PyDict_Check(params) || PyObject_TypeCheck(params, &preset_type))
+        return true;
+    PyErr_SetString(error, "SCIP parameters must be a dict or a preset");
+    return false;
+}
+
+static int _params_apply(SCIP *scip, PyObject *params) {
+    // Sets the parameters of a preset or a dict.  Returns 0 on success.
+    param_preset *preset;
+
+    if (PyObject_TypeCheck(params, &preset_type)) {
+        preset = (param_preset *) params;
+        PY_SCIP_CALL(error, -1, PyScipParamsApply(scip, preset->params, preset->nparams));
+        return 0;
+    }
+    return PyScipSetParams(error, scip, params);
+}
+
+static SCIP_RETCODE _preset_scratch(SCIP **scip) {
+    // Creates an instance with every parameter at its default.  Solvers
+    // turn off catching ctrl-c, which would otherwise end up in presets.
+    SCIP_CALL( _solver_create_scip(scip) );
+    (*scip)->set->misc_catchctrlc = TRUE;
+    return SCIP_OKAY;
+}
+
+static int preset_init(param_preset *self, PyObject *args, PyObject *kwds) {
+    // Settings go onto a scratch instance in order: the file, emphasis,
+    // heuristics, presolving and separating, then params.  Every parameter
+    // that ends up changed from its default is compiled, along with any
+    // named in params.
+    static char *argnames[] = {"params", "file", "emphasis", "heuristics", "presolving", "separating", NULL};
+    PyObject *params = NULL;
+    const char *file = NULL;
+    int emphasis = -1, heuristics = -1, presolving = -1, separating = -1;
+    py_scip_param *table = NULL;
+    SCIP *scip = NULL;
+    SCIP_RETCODE retcode;
+    int n = -1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oziiii", argnames, &params, &file, &emphasis, &heuristics, &presolving, &separating))
+        return -1;
+
+    if (params == Py_None)
+        params = NULL;
+    if (params != NULL && !PyDict_Check(params)) {
+        PyErr_SetString(error, "SCIP parameters must be a dict");
+        return -1;
+    }
+    if (emphasis > SCIP_PARAMEMPHASIS_COUNTER || heuristics > SCIP_PARAMSETTING_OFF ||
+        presolving > SCIP_PARAMSETTING_OFF || separating > SCIP_PARAMSETTING_OFF) {
+        PyErr_SetString(error, "unknown emphasis or setting");
+        return -1;
+    }
+
+    if ((retcode = _preset_scratch(&scip)) == SCIP_OKAY && file != NULL)
+        retcode = SCIPreadParams(scip, file);
+    if (retcode == SCIP_OKAY && emphasis >= 0)
+        retcode = SCIPsetEmphasis(scip, (SCIP_PARAMEMPHASIS) emphasis, TRUE);
+    if (retcode == SCIP_OKAY && heuristics >= 0)
+        retcode = SCIPsetHeuristics(scip, (SCIP_PARAMSETTING) heuristics, TRUE);
+    if (retcode == SCIP_OKAY && presolving >= 0)
+        retcode = SCIPsetPresolving(scip, (SCIP_PARAMSETTING) presolving, TRUE);
+    if (retcode == SCIP_OKAY && separating >= 0)
+        retcode = SCIPsetSeparating(scip, (SCIP_PARAMSETTING) separating, TRUE);
+    if (retcode != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+
+    if (params != NULL && PyScipSetParams(error, scip, params))
+        goto cleanup;
+    if ((n = PyScipParamsCompile(error, scip, params, &table)) < 0)
+        goto cleanup;
+
+    PyScipParamsFree(self->params, self->nparams);
+    self->params = table;
+    self->nparams = n;
+
+cleanup:
+    if (scip != NULL) SCIPfree(&scip);
+    return n < 0 ? -1 : 0;
+}
+
+static void preset_dealloc(param_preset *self) {
+    PyScipParamsFree(self->params, self->nparams);
+    ((PyObject *) self)->ob_type->tp_free(self);
+}
+
+static Py_ssize_t preset_length(param_preset *self) {
+    return self->nparams;
+}
+
+static PyObject *preset_getattr(param_preset *self, PyObject *attr_name) {
+    // Compiled parameters come back as a new dict of names to values
+    PyObject *params, *value;
+    int i;
+
+    if (PyUnicode_Check(attr_name) && PyUnicode_CompareWithASCIIString(attr_name, "params") == 0) {
+        if ((params = PyDict_New()) == NULL)
+            return NULL;
+        for (i = 0; i < self->nparams; i++) {
+            value = PyScipParamValue(&self->params[i]);
+            if (value == NULL || PyDict_SetItemString(params, self->params[i].name, value)) {
+                Py_XDECREF(value);
+                Py_DECREF(params);
+                return NULL;
+            }
+            Py_DECREF(value);
+        }
+        return params;
+    }
+    return PyObject_GenericGetAttr((PyObject *) self, attr_name);
+}
+
+static PyObject *preset_write(param_preset *self, PyObject *args) {
+    // Writes a .set file with the parameters that differ from defaults
+    const char *path;
+    SCIP *scip = NULL;
+    SCIP_RETCODE retcode;
+
+    if (!PyArg_ParseTuple(args, "s", &path))
+        return NULL;
+
+    if ((retcode = _preset_scratch(&scip)) == SCIP_OKAY &&
+        (retcode = PyScipParamsApply(scip, self->params, self->nparams)) == SCIP_OKAY)
+        retcode = SCIPwriteParams(scip, path, TRUE, TRUE);
+    if (scip != NULL) SCIPfree(&scip);
+
+    PY_SCIP_CALL(error, NULL, retcode);
+    Py_RETURN_NONE;
+}
+
+static PyObject *solver_set_params(solver *self, PyObject *args) {
+    // Sets a preset or a dict of parameters, after going back to the
+    // defaults if reset is true
+    PyObject *params;
+    bool reset = false;
+
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+
+    if (!PyArg_ParseTuple(args, "O|b", &params, &reset))
+        return NULL;
+    if (!_params_check(params))
+        return NULL;
+
+    if (reset)
+        PY_SCIP_CALL(error, NULL, SCIPresetParams(self->scip));
+    if (_params_apply(self->scip, params))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+/*****************************************************************************/
+/* PORTFOLIO SOLVING                                                         */
+/*****************************************************************************/
+// A portfolio races copies of the transformed problem against each other,
+// one per native thread, each with its own parameter settings.  Workers
+// publish new incumbents to a shared pool and pull in better ones found by
+// the others each time they finish a node.  The first worker to settle
+// the problem, or to reach a limit or interrupt of the whole solve,
+// decides the outcome and the rest are interrupted at their next node.
+// Workers that fail, or stop on a limit from their own profile, just drop
+// out.  If they all do, the one with the best bounds decides.
+// Interrupts and limits from other threads go through the solver's control
+// to every worker.
+
+#define PY_SCIP_PORTFOLIO_EVENTS (SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED)
+
+typedef struct {
+    PyThread_type_lock lock; // guards everything below
+    int nvars;               // number of variables in the source problem
+    SCIP_Real *best;         // best incumbent so far, by source index
+    SCIP_Real bestobj;       // its objective.  Copies always minimize.
+    int version;             // bumped every time best changes
+    int winner;              // first worker to settle the solve, or -1
+    SCIP **scips;            // each worker's instance, for the control
+    py_scip_control *control; // interrupts and limits from other threads
+} py_scip_portfolio;
+
+typedef struct {
+    SCIP *scip;              // copy of the source problem
+    SCIP_VAR **vars;         // variables of the copy, by source index
+    SCIP_Real *vals;         // incumbent values on their way to the pool
+    int version;             // last pool version this worker has seen
+    int limits;              // last control limits version applied
+    int index;               // position among the workers
+    SCIP_RETCODE retcode;    // what SCIPsolve returned
+    py_scip_thread thread;
+    py_scip_portfolio *pool;
+} py_scip_worker;
+
+static SCIP_DECL_EVENTINITSOL(_portfolio_initsol) {
+    SCIP_CALL( SCIPcatchEvent(scip, PY_SCIP_PORTFOLIO_EVENTS, eventhdlr, NULL, NULL) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXITSOL(_portfolio_exitsol) {
+    SCIP_CALL( SCIPdropEvent(scip, PY_SCIP_PORTFOLIO_EVENTS, eventhdlr, NULL, -1) );
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_EVENTEXEC(_portfolio_exec) {
+    // Runs on the worker's own thread, without the GIL
+    py_scip_worker *w = (py_scip_worker *) SCIPeventhdlrGetData(eventhdlr);
+    py_scip_portfolio *pool = w->pool;
+    SCIP_SOL *sol;
+    SCIP_Real obj;
+    SCIP_Bool stop, import, stored;
+
+    SCIP_CALL( PyScipControlWorker(pool->control, scip, &w->limits) );
+
+    if (SCIPeventGetType(event) == SCIP_EVENTTYPE_BESTSOLFOUND) {
+        // Publish our new incumbent, unless someone already has better
+        sol = SCIPgetBestSol(scip);
+        obj = SCIPgetSolOrigObj(scip, sol);
+        SCIP_CALL( SCIPgetSolVals(scip, sol, pool->nvars, w->vars, w->vals) );
+
+        PyThread_acquire_lock(pool->lock, WAIT_LOCK);
+        if (pool->version == 0 || obj < pool->bestobj) {
+            memcpy(pool->best, w->vals, pool->nvars * sizeof(SCIP_Real));
+            pool->bestobj = obj;
+            w->version = ++pool->version;
+        }
+        PyThread_release_lock(pool->lock);
+        return SCIP_OKAY;
+    }
+
+    // Node solved: either stop or check the pool for a better incumbent
+    import = FALSE;
+    PyThread_acquire_lock(pool->lock, WAIT_LOCK);
+    stop = pool->winner >= 0;
+    if (!stop && pool->version != w->version) {
+        w->version = pool->version;
+        if (pool->bestobj < SCIPgetPrimalbound(scip)) {
+            memcpy(w->vals, pool->best, pool->nvars * sizeof(SCIP_Real));
+            import = TRUE;
+        }
+    }
+    PyThread_release_lock(pool->lock);
+
+    if (stop) {
+        SCIP_CALL( SCIPinterruptSolve(scip) );
+    } else if (import) {
+        SCIP_CALL( SCIPcreateSol(scip, &sol, NULL) );
+        SCIP_CALL( SCIPsetSolVals(scip, sol, pool->nvars, w->vars, w->vals) );
+        SCIP_CALL( SCIPtrySolFree(scip, &sol, FALSE, TRUE, TRUE, TRUE, &stored) );
+    }
+
+    return SCIP_OKAY;
+}
+
+static bool _portfolio_settled(py_scip_worker *w) {
+    // Whether what stopped the worker holds for the whole portfolio
+    if (w->retcode != SCIP_OKAY)
+        return false;
+
+    switch (SCIPgetStatus(w->scip)) {
+    case SCIP_STATUS_OPTIMAL:
+    case SCIP_STATUS_INFEASIBLE:
+    case SCIP_STATUS_UNBOUNDED:
+    case SCIP_STATUS_INFORUNBD:
+    case SCIP_STATUS_GAPLIMIT:
+    case SCIP_STATUS_USERINTERRUPT:
+        return true;
+    default:
+        return PyScipControlShared(w->pool->control, w->scip);
+    }
+}
+
+static void _portfolio_finish(py_scip_worker *w) {
+    bool settled = _portfolio_settled(w);
+
+    PyThread_acquire_lock(w->pool->lock, WAIT_LOCK);
+    if (settled && w->pool->winner < 0)
+        w->pool->winner = w->index;
+    PyThread_release_lock(w->pool->lock);
+}
+
+static int _portfolio_fallback(py_scip_worker *workers, int nworkers) {
+    // Picks the worker with the best bounds once none settled the solve,
+    // or returns -1 if every one of them failed.  Copies always minimize.
+    SCIP_Real primal, dual, bestprimal = 0, bestdual = 0;
+    int i, best = -1;
+
+    for (i = 0; i < nworkers; i++) {
+        if (workers[i].retcode != SCIP_OKAY)
+            continue;
+
+        primal = SCIPgetPrimalbound(workers[i].scip);
+        dual = SCIPgetDualbound(workers[i].scip);
+        if (best < 0 || primal < bestprimal || (primal == bestprimal && dual > bestdual)) {
+            best = i;
+            bestprimal = primal;
+            bestdual = dual;
+        }
     }
+    return best;
+}
 
-    return (PyObject *) self;
+static void _portfolio_run(void *arg) {
+    // Thread body.  Never touches Python.
+    py_scip_worker *w = (py_scip_worker *) arg;
+    w->retcode = SCIPsolve(w->scip);
+    _portfolio_finish(w);
 }
 
-static int solver_init(solver *self, PyObject *args, PyObject *kwds) {
-    static char *argnames[] = {"quiet", NULL};
-    bool quiet;
-    
-    quiet = true;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|b", argnames, &quiet))
+static int _portfolio_worker_init(solver *self, py_scip_worker *w, py_scip_portfolio *pool, int index, PyObject *profile) {
+    // Copies the transformed problem into a new SCIP instance for a worker
+    SCIP_HASHMAP *varmap;
+    SCIP_VAR **vars;
+    SCIP_Bool valid;
+    SCIP_RETCODE retcode;
+    int i;
+
+    w->index = index;
+    w->pool = pool;
+    w->vars = malloc((pool->nvars > 0 ? pool->nvars : 1) * sizeof(SCIP_VAR *));
+    w->vals = malloc((pool->nvars > 0 ? pool->nvars : 1) * sizeof(SCIP_Real));
+    if (w->vars == NULL || w->vals == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        return -1;
+    }
+    if (PyScipThreadInit(error, &w->thread))
         return -1;
 
-    // Turn on/off solver chatter
-    if (quiet) {
-        PY_SCIP_CALL(error, -1, SCIPsetMessagehdlr(NULL));
-    } else {
-        PY_SCIP_CALL(error, -1, SCIPsetDefaultMessagehdlr());
+    PY_SCIP_CALL(error, -1, SCIPcreate(&w->scip));
+
+    // SCIPcopy brings along plugins and parameters, limits included
+    PY_SCIP_CALL(error, -1, 
+        SCIPhashmapCreate(&varmap, SCIPblkmem(w->scip), SCIPcalcHashtableSize(2 * pool->nvars))
+    );
+    retcode = SCIPcopy(self->scip, w->scip, varmap, NULL, "portfolio", TRUE, &valid);
+    if (retcode == SCIP_OKAY) {
+        vars = SCIPgetVars(self->scip);
+        for (i = 0; i < pool->nvars; i++)
+            w->vars[i] = (SCIP_VAR *) SCIPhashmapGetImage(varmap, vars[i]);
+    }
+    SCIPhashmapFree(&varmap);
+    PY_SCIP_CALL(error, -1, retcode);
+
+    // Without every constraint the copy could return the wrong answer
+    if (!valid) {
+        PyErr_SetString(error, "problem could not be copied for portfolio solving");
+        return -1;
     }
 
+    w->scip->set->misc_catchctrlc = FALSE;
+    if (_params_apply(w->scip, profile))
+        return -1;
+
+    // SCIPincludeEventhdlr Arguments:
+    // scip          SCIP data structure
+    // name          name of event handler
+    // desc          description of event handler
+    // eventcopy     copies the handler to sub-SCIPs; workers don't need that
+    // eventfree     frees handler data, which the portfolio owns
+    // eventinit     called after the problem was transformed
+    // eventexit     called before the transformed problem is freed
+    // eventinitsol  called when branch and bound starts
+    // eventexitsol  called when branch and bound stops
+    // eventdelete   frees event data
+    // eventexec     processes an event
+    // eventhdlrdata event handler data
+    PY_SCIP_CALL(error, -1,
+        SCIPincludeEventhdlr(w->scip, "python-zibopt-portfolio", "shares incumbents between portfolio workers",
+            NULL, NULL, NULL, NULL, _portfolio_initsol, _portfolio_exitsol, NULL, _portfolio_exec,
+            (SCIP_EVENTHDLRDATA *) w)
+    );
+
     return 0;
 }
 
-static void solver_dealloc(solver *self) {
-    if (self->scip) {
-        // Free all variables
-        while (self->first_var != NULL) {
-            SCIPreleaseVar(self->scip, &self->first_var->variable);
-            self->first_var = (variable *) self->first_var->next;
-        }
-        self->first_var = NULL;
-        
-        // Free constraints
-        while (self->first_cons != NULL) {
-            SCIPreleaseCons(self->scip, &self->first_cons->constraint);
-            self->first_cons = (constraint *) self->first_cons->next;
-        }
-        self->first_cons = NULL;
-        
-        // Free the solver itself
-        SCIPfree(&self->scip);
-        self->scip = NULL;
-    }
-
-    ((PyObject *) self)->ob_type->tp_free(self);
+static void _portfolio_worker_free(py_scip_worker *w) {
+    if (w->scip != NULL) SCIPfree(&w->scip);
+    if (w->vars != NULL) free(w->vars);
+    if (w->vals != NULL) free(w->vals);
+    PyScipThreadFree(&w->thread);
 }
 
-/*****************************************************************************/
-/* ADDITONAL METHODS                                                         */
-/*****************************************************************************/
-static int _seed_primal(solver *self, PyObject *solution) {
-    // Extracts data for a primal solution and hands it to SCIP
-    PyObject *key, *value;
-    Py_ssize_t pos;
-    double d;
-    SCIP_Bool feasible, stored;
-    SCIP_SOL *sol = NULL;
+static SCIP_Real _portfolio_gap(SCIP *scip, SCIP_Real primal, SCIP_Real dual) {
+    // Relative gap between bounds, the way SCIPgetGap works it out
+    if (SCIPisEQ(scip, primal, dual))
+        return 0.0;
+    if (SCIPisZero(scip, primal) || SCIPisZero(scip, dual) || primal * dual < 0.0 ||
+        SCIPisInfinity(scip, REALABS(primal)) || SCIPisInfinity(scip, REALABS(dual)))
+        return SCIPinfinity(scip);
+    return REALABS((primal - dual) / MIN(REALABS(primal), REALABS(dual)));
+}
 
-    if (solution && PyObject_Length(solution) > 0) {
-        // We were given a primal solution.  Feed it to the solver. But first,
-        // check and make sure we got a dictionary of variables and numbers.
-        pos = 0;
-        while (PyDict_Next(solution, &pos, &key, &value)) {
-            // Check and make sure we have a real variable type
-            if (strcmp(key->ob_type->tp_name, VARIABLE_TYPE_NAME)) {
-                PyErr_SetString(error, "invalid variable type");
-                return 0;
-            }
-            
-            // Verify that the variable is associated with this solver
-            if (((variable *) key)->scip != self->scip) {
-                PyErr_SetString(error, "variable not associated with solver");
-                return 0;
-            }
-        
-            // Check and make sure we have a number as the value
-            if (!(PyFloat_Check(value) || PyLong_Check(value))) {
-                PyErr_SetString(error, "solution values must be numeric");
-                return 0;
-            }
-        }
+static int _portfolio_collect(solver *self, py_scip_worker *workers, int nworkers, py_scip_portfolio *pool) {
+    // Workers only publish incumbents once branch and bound starts, so look
+    // at each one's best solution too.  Then hand the best of them back
+    // to the source problem.
+    SCIP *winner;
+    SCIP_SOL *sol;
+    SCIP_Real obj;
+    SCIP_Bool stored;
+    int i;
 
-        // Passed validation.  Now we can create the SCIP solution.
-        SCIPtransformProb(self->scip);
-        SCIPcreateSol(self->scip, &sol, NULL);
+    for (i = 0; i < nworkers; i++) {
+        if (workers[i].retcode != SCIP_OKAY || SCIPgetNSols(workers[i].scip) == 0)
+            continue;
 
-        // Add all the variables to it            
-        pos = 0;
-        while (PyDict_Next(solution, &pos, &key, &value)) {
-            // Convert the value to a C double
-            if (PyFloat_Check(value))
-                d = PyFloat_AsDouble(value);
-            else
-                d = (double) PyLong_AsLong(value);
-            
-            // Only set nonzero values
-            if (d)
-                SCIPsetSolVal(self->scip, sol, ((variable *) key)->variable, d); 
+        sol = SCIPgetBestSol(workers[i].scip);
+        obj = SCIPgetSolOrigObj(workers[i].scip, sol);
+        if (pool->version == 0 || obj < pool->bestobj) {
+            PY_SCIP_CALL(error, -1, 
+                SCIPgetSolVals(workers[i].scip, sol, pool->nvars, workers[i].vars, pool->best)
+            );
+            pool->bestobj = obj;
+            pool->version++;
         }
+    }
 
-        PY_SCIP_CALL(error, 0, SCIPcheckSolOrig(self->scip, sol, &feasible, TRUE, FALSE));
-        if (!feasible)
-            PyErr_SetString(error, "infeasible primal solution");
-        
-        // SCIPtrySolFree Arguments:
-        // scip 	        SCIP data structure
-        // sol           	pointer to primal CIP solution; is cleared in function call
-        // printreason      should all reasons of violations be printed
-        // checkbounds 	    should the bounds of the variables be checked?
-        // checkintegrality has integrality to be checked?
-        // checklprows 	    have current LP rows to be checked?
-        // stored           stores whether solution was feasible and good enough to keep 
-        SCIPtrySolFree(self->scip, &sol, FALSE, FALSE, FALSE, FALSE, &stored);
-        
-        // We don't actually do anything with the value of stored for the
-        // time being.  Other programs do an assert(stored) but we have
-        // already tested it for feasibility and don't want to raise an
-        // error if the primal objective value is too poor to use.
+    if (pool->version > 0) {
+        PY_SCIP_CALL(error, -1, SCIPcreateSol(self->scip, &sol, NULL));
+        PY_SCIP_CALL(error, -1, SCIPsetSolVals(self->scip, sol, pool->nvars, SCIPgetVars(self->scip), pool->best));
+        PY_SCIP_CALL(error, -1, SCIPtrySolFree(self->scip, &sol, FALSE, TRUE, TRUE, TRUE, &stored));
     }
-    
+
+    // The winner's copy is exact, so what it proved holds for the source
+    // too.  Its bounds are on the source's transformed problem.
+    winner = workers[pool->winner].scip;
+    self->portfolio.status = SCIPgetStatus(winner);
+    self->portfolio.primal = SCIPretransformObj(self->scip, SCIPgetPrimalbound(winner));
+    self->portfolio.dual = SCIPretransformObj(self->scip, SCIPgetDualbound(winner));
+    self->portfolio.gap = _portfolio_gap(self->scip, self->portfolio.primal, self->portfolio.dual);
+    self->portfolio.valid = true;
     return 0;
 }
 
-static int _optimize(solver *self, PyObject *args, PyObject *kwds) {
-    // Runs components of max/min that are the same
-    static char *argnames[] = {"solution", "time", "gap", "absgap", "nsol", "offset", NULL};
-    PyObject *solution;
+static PyObject *solver_portfolio_solve(solver *self, PyObject *args, PyObject *kwds) {
+    // Races one copy of the problem per thread, each with the settings
+    // profile of the same index.  Returns the index of the winning worker.
+    static char *argnames[] = {"profiles", "threads", "maximize", "time", "gap", "absgap", "nsol", "offset", "memory", NULL};
+    PyObject *profiles, *seq;
+    int threads   = 0;
+    bool maximize = false;
     double time   = SCIP_DEFAULT_LIMIT_TIME;
     double gap    = SCIP_DEFAULT_LIMIT_GAP;
     double absgap = SCIP_DEFAULT_LIMIT_GAP;
     int nsol      = SCIP_DEFAULT_LIMIT_SOLUTIONS;
     double offset = 0;
-    
-    // See if we were given a primal solution dict
-    solution = NULL;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O!dddid", argnames, &PyDict_Type, &solution, &time, &gap, &absgap, &nsol, &offset))
-        return 0;
+    double memory = SCIP_DEFAULT_LIMIT_MEMORY;
 
-    _seed_primal(self, solution);
-    if (PyErr_Occurred())
-        return 0;
+    py_scip_portfolio pool;
+    py_scip_worker *workers = NULL;
+    PyObject *result = NULL;
+    SCIP_RETCODE retcode;
+    int i, nprofiles;
 
-    // Set timeout & gap values, etc
-    SCIPclockReset(self->scip->stat->solvingtime);
-    self->scip->set->limit_time   = time;
-    self->scip->set->limit_gap    = gap;
-    self->scip->set->limit_absgap = absgap;
-    self->scip->set->limit_solutions = nsol;
-    self->scip->origprob->objoffset = offset;
-    
-    // This calls the actual optimization routine
-    PY_SCIP_CALL(error, 0, SCIPsolve(self->scip));
-    
-    return 0;
-}
+    PY_SCIP_CHECK_IDLE(error, NULL, self);
+    self->portfolio.valid = false;
 
-static PyObject *solver_maximize(solver *self, PyObject *args, PyObject *kwds) {
-    PY_SCIP_CALL(error, NULL, SCIPsetObjsense(self->scip, SCIP_OBJSENSE_MAXIMIZE));
-    _optimize(self, args, kwds);
-    if (PyErr_Occurred())
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ibddddidd", argnames, &profiles, &threads, &maximize, &time, &gap, &absgap, &nsol, &offset, &memory))
         return NULL;
-    Py_RETURN_NONE;
-}
 
-static PyObject *solver_minimize(solver *self, PyObject *args, PyObject *kwds) {
-    PY_SCIP_CALL(error, NULL, SCIPsetObjsense(self->scip, SCIP_OBJSENSE_MINIMIZE));
-    _optimize(self, args, kwds);
-    if (PyErr_Occurred())
+    seq = PySequence_Fast(profiles, "profiles must be a sequence");
+    if (seq == NULL)
         return NULL;
-    Py_RETURN_NONE;
+
+    memset(&pool, 0, sizeof(py_scip_portfolio));
+    pool.winner = -1;
+
+    nprofiles = (int) PySequence_Fast_GET_SIZE(seq);
+    if (nprofiles == 0) {
+        PyErr_SetString(error, "at least one profile is required");
+        goto cleanup;
+    }
+    for (i = 0; i < nprofiles; i++) {
+        if (!_params_check(PySequence_Fast_GET_ITEM(seq, i)))
+            goto cleanup;
+    }
+    if (threads <= 0)
+        threads = nprofiles;
+
+    // SCIP 2.0 has no random seed to vary, so copies with the same profile
+    // would only repeat each other's work
+    if (threads > nprofiles) {
+        PyErr_SetString(error, "more threads than profiles");
+        goto cleanup;
+    }
+
+    // Objective sense and offset go on the original problem, then every
+    // worker copies the same transformed problem
+    if (_set_objsense(self, maximize ? SCIP_OBJSENSE_MAXIMIZE : SCIP_OBJSENSE_MINIMIZE))
+        goto cleanup;
+    if (self->scip->origprob->objoffset != offset) {
+        if ((retcode = SCIPfreeTransform(self->scip)) != SCIP_OKAY) {
+            PyScipSetError(error, retcode);
+            goto cleanup;
+        }
+        self->scip->origprob->objoffset = offset;
+    }
+    _set_limits(self, time, gap, absgap, nsol, memory);
+
+    if ((retcode = SCIPtransformProb(self->scip)) != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        goto cleanup;
+    }
+
+    pool.nvars = SCIPgetNVars(self->scip);
+    pool.best = malloc((pool.nvars > 0 ? pool.nvars : 1) * sizeof(SCIP_Real));
+    pool.lock = PyThread_allocate_lock();
+    pool.scips = malloc(threads * sizeof(SCIP *));
+    pool.control = self->control;
+    workers = calloc(threads, sizeof(py_scip_worker));
+    if (pool.best == NULL || pool.lock == NULL || pool.scips == NULL || workers == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+
+    for (i = 0; i < threads; i++) {
+        if (_portfolio_worker_init(self, &workers[i], &pool, i, PySequence_Fast_GET_ITEM(seq, i)))
+            goto cleanup;
+        pool.scips[i] = workers[i].scip;
+    }
+
+    // A worker that can't get a thread counts as failing, and drops out
+    PyScipControlStart(self->control, self->scip);
+    PyScipControlShare(self->control, pool.scips, threads);
+    self->solving = true;
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < threads; i++) {
+        if (PyScipThreadStart(&workers[i].thread, _portfolio_run, &workers[i])) {
+            workers[i].retcode = SCIP_ERROR;
+            _portfolio_finish(&workers[i]);
+        }
+    }
+    for (i = 0; i < threads; i++)
+        PyScipThreadJoin(&workers[i].thread);
+    PyScipControlStop(self->control);
+    Py_END_ALLOW_THREADS
+    self->solving = false;
+
+    if (pool.winner < 0 && (pool.winner = _portfolio_fallback(workers, threads)) < 0) {
+        PyScipSetError(error, workers[0].retcode);
+        goto cleanup;
+    }
+
+    if (_portfolio_collect(self, workers, threads, &pool))
+        goto cleanup;
+
+    result = Py_BuildValue("i", pool.winner);
+
+cleanup:
+    for (i = 0; workers != NULL && i < threads; i++)
+        _portfolio_worker_free(&workers[i]);
+    if (workers != NULL) free(workers);
+    if (pool.best != NULL) free(pool.best);
+    if (pool.scips != NULL) free(pool.scips);
+    if (pool.lock != NULL) PyThread_free_lock(pool.lock);
+    Py_DECREF(seq);
+    return result;
 }
 
-static PyObject *solver_restart(solver *self) {
-    PY_SCIP_CALL(error, NULL, SCIPfreeTransform(self->scip));
-    Py_RETURN_NONE;
+/*****************************************************************************/
+/* SOLVER POOLS                                                              */
+/*****************************************************************************/
+// Creating a SCIP instance and including the default plugins costs far
+// more than solving a small model.  A pool keeps instances around with
+// empty problems and default parameters.  Solvers created with pool=...
+// take one, and give it back when they are deallocated.
+
+static int _pool_take(solver_pool *pool, SCIP **scip) {
+    // Hands out an idle instance, or a new one if there is none, with the
+    // pool's parameters applied
+    SCIP_RETCODE retcode;
+
+    if (pool->nidle > 0) {
+        *scip = pool->idle[--pool->nidle];
+    } else if ((retcode = _solver_create_scip(scip)) != SCIP_OKAY) {
+        PyScipSetError(error, retcode);
+        if (*scip != NULL) SCIPfree(scip);
+        return -1;
+    }
+
+    if (pool->params != NULL && _params_apply(*scip, pool->params)) {
+        SCIPfree(scip);
+        return -1;
+    }
+
+    return 0;
 }
 
-static PyObject *solver_unconstrain(solver *self, PyObject *c) {
-    // Removes a constraint from the solver
-    constraint *cons; // constraint C object
+static bool _pool_give(solver_pool *pool, SCIP *scip) {
+    // Empties the problem and resets parameters, then keeps the instance.
+    // Returns false if it can't be reused, in which case it's not taken.
+    // This runs from solver_dealloc, so it must not raise.
+    SCIP **idle;
+    int capacity;
 
-    // Check solver type in the best way we seem to have available
-    if (strcmp(c->ob_type->tp_name, CONSTRAINT_TYPE_NAME)) {
-        PyErr_SetString(error, "invalid constraint type");
-        return NULL;
+    if (pool->nidle == pool->capacity) {
+        capacity = pool->capacity > 0 ? pool->capacity * 2 : 8;
+        idle = realloc(pool->idle, capacity * sizeof(SCIP *));
+        if (idle == NULL)
+            return false;
+        pool->idle = idle;
+        pool->capacity = capacity;
     }
-    
-    cons = (constraint *) c;
 
-    // Restart solver prior to removing the constraint so state is ok
-    solver_restart(self);
-    PY_SCIP_CALL(error, NULL, SCIPdelCons(self->scip, cons->constraint));
+    // See _solver_create_scip for SCIPcreateProb arguments
+    if (SCIPfreeProb(scip) != SCIP_OKAY || SCIPresetParams(scip) != SCIP_OKAY ||
+        SCIPcreateProb(scip, "python-zibobt", NULL, NULL, NULL, NULL, NULL, NULL, NULL) != SCIP_OKAY)
+        return false;
 
-    Py_RETURN_NONE;
+    scip->set->misc_catchctrlc = FALSE;
+    pool->idle[pool->nidle++] = scip;
+    return true;
 }
 
-// Functions for pulling out lists of setting names by type
-PY_SCIP_SETTING_NAMES(branching_names, nbranchrules, branchrules);
-PY_SCIP_SETTING_NAMES(conflict_names, nconflicthdlrs, conflicthdlrs);
-PY_SCIP_SETTING_NAMES(display_names, ndisps, disps);
-PY_SCIP_SETTING_NAMES(heuristic_names, nheurs, heurs);
-PY_SCIP_SETTING_NAMES(presolver_names, npresols, presols);
-PY_SCIP_SETTING_NAMES(propagator_names, nprops, props);
-PY_SCIP_SETTING_NAMES(selector_names, nnodesels, nodesels);
-PY_SCIP_SETTING_NAMES(separator_names, nsepas, sepas);
+static int solver_pool_init(solver_pool *self, PyObject *args, PyObject *kwds) {
+    static char *argnames[] = {"size", "params", NULL};
+    PyObject *params = NULL, *old;
+    SCIP *scip;
+    SCIP_RETCODE retcode;
+    int size = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iO", argnames, &size, &params))
+        return -1;
+
+    if (params == Py_None)
+        params = NULL;
+    if (params != NULL && !_params_check(params))
+        return -1;
+    old = self->params;
+    Py_XINCREF(params);
+    self->params = params;
+    Py_XDECREF(old);
+
+    // Pay for setup now instead of when solvers are wanted
+    for (; size > 0; size--) {
+        scip = NULL;
+        if ((retcode = _solver_create_scip(&scip)) != SCIP_OKAY) {
+            PyScipSetError(error, retcode);
+            if (scip != NULL) SCIPfree(&scip);
+            return -1;
+        }
+        if (!_pool_give(self, scip)) {
+            SCIPfree(&scip);
+            PyErr_SetString(error, "ran out of memory");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void solver_pool_dealloc(solver_pool *self) {
+    int i;
+    for (i = 0; i < self->nidle; i++)
+        SCIPfree(&self->idle[i]);
+    if (self->idle != NULL) free(self->idle);
+    Py_XDECREF(self->params);
+    ((PyObject *) self)->ob_type->tp_free(self);
+}
+
+static PyObject *solver_pool_preset(solver_pool *self, PyObject *params) {
+    // Replaces the parameters applied to instances as they're handed out.
+    // Idle instances already have defaults, so nothing else changes.
+    PyObject *old;
+
+    if (params == Py_None) {
+        Py_CLEAR(self->params);
+        Py_RETURN_NONE;
+    }
+    if (!_params_check(params))
+        return NULL;
+
+    old = self->params;
+    Py_INCREF(params);
+    self->params = params;
+    Py_XDECREF(old);
+    Py_RETURN_NONE;
+}
 
 /*****************************************************************************/
 /* MODULE INITIALIZATION                                                     */
 /*****************************************************************************/
+static PyMemberDef solver_members[] = {
+    {"reuse_incumbent", T_BOOL, offsetof(solver, reuse_incumbent), 0, "warm start fresh solves from the last incumbent"},
+    {NULL} /* Sentinel */
+};
+
 static PyMethodDef solver_methods[] = {
+    {"change_constraints", (PyCFunction) solver_change_constraints, METH_VARARGS, "removes and adds constraints with at most one restart"},
+    {"interrupt", (PyCFunction) solver_interrupt, METH_NOARGS, "stop a running solve from another thread"},
+    {"load_snapshot", (PyCFunction) solver_load_snapshot, METH_O, "adds the model in a snapshot buffer"},
     {"maximize", (PyCFunction) solver_maximize, METH_VARARGS | METH_KEYWORDS, "maximize the objective value"},
+    {"memory_usage", (PyCFunction) solver_memory_usage, METH_NOARGS, "returns bytes of block memory in use"},
     {"minimize", (PyCFunction) solver_minimize, METH_VARARGS | METH_KEYWORDS, "minimize the objective value"},
+    {"portfolio_solve", (PyCFunction) solver_portfolio_solve, METH_VARARGS | METH_KEYWORDS, "race copies of the problem with different settings"},
+    {"read", (PyCFunction) solver_read, METH_VARARGS, "reads a problem file into an empty solver"},
     {"restart",  (PyCFunction) solver_restart,  METH_NOARGS,   "restart the solver"},
+    {"save_snapshot", (PyCFunction) solver_save_snapshot, METH_VARARGS, "writes the model to a binary snapshot"},
+    {"set_callback", (PyCFunction) solver_set_callback, METH_VARARGS | METH_KEYWORDS, "stream incumbents and node progress to a function"},
+    {"set_lazy", (PyCFunction) solver_set_lazy, METH_VARARGS | METH_KEYWORDS, "generate rows from a function during the search"},
+    {"set_limits", (PyCFunction) solver_set_limits, METH_VARARGS | METH_KEYWORDS, "change limits of a running solve from another thread"},
+    {"set_params", (PyCFunction) solver_set_params, METH_VARARGS, "sets a preset or a dict of SCIP parameters"},
+    {"set_objective", (PyCFunction) solver_set_objective, METH_O, "update linear objective coefficients from expression terms"},
+    {"set_start", (PyCFunction) solver_set_start, METH_VARARGS | METH_KEYWORDS, "warm start the next solve from an array of values"},
+    {"solutions_into", (PyCFunction) solver_solutions_into, METH_VARARGS, "writes the best stored solutions into arrays"},
+    {"statistics", (PyCFunction) solver_statistics, METH_NOARGS, "returns counters and clocks from the last solve"},
     {"unconstrain",  (PyCFunction) solver_unconstrain,  METH_O,   "remove a constraint"},
+    {"wrapper",  (PyCFunction) solver_wrapper,  METH_O,   "returns the Python variable at an index, if there is one"},
+    {"write", (PyCFunction) solver_write, METH_VARARGS, "writes the problem to a file"},
     {"branching_names",  (PyCFunction) branching_names,  METH_NOARGS, "returns a list of branching rule names"},
     {"conflict_names",   (PyCFunction) conflict_names,   METH_NOARGS, "returns a list of conflict handler names"},
     {"display_names",    (PyCFunction) display_names,    METH_NOARGS, "returns a list of display column names"},
@@ -274,18 +1865,120 @@ static PyTypeObject solver_type = {
     0,                           /* tp_hash */
     0,                           /* tp_call */
     0,                           /* tp_str */
+    (getattrofunc) solver_getattr, /* tp_getattro */
+    0,                           /* tp_setattro */
+    0,                           /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC, /* tp_flags */
+    "SCIP solver objects",       /* tp_doc */
+    (traverseproc) solver_traverse, /* tp_traverse */
+    (inquiry) solver_clear,      /* tp_clear */
+    0,                           /* tp_richcompare */
+    offsetof(solver, weakreflist), /* tp_weaklistoffset */
+    0,                           /* tp_iter */
+    0,                           /* tp_iternext */
+    solver_methods,              /* tp_methods */
+    solver_members,              /* tp_members */
+    0,                           /* tp_getset */
+    0,                           /* tp_base */
+    0,                           /* tp_dict */
+    0,                           /* tp_descr_get */
+    0,                           /* tp_descr_set */
+    0,                           /* tp_dictoffset */
+    (initproc) solver_init,      /* tp_init */
+    0,                           /* tp_alloc */
+    solver_new,                  /* tp_new */
+};
+
+static PyMemberDef solver_pool_members[] = {
+    {"idle", T_INT, offsetof(solver_pool, nidle), READONLY, "number of idle SCIP instances"},
+    {"params", T_OBJECT, offsetof(solver_pool, params), READONLY, "parameters for instances handed out"},
+    {NULL} /* Sentinel */
+};
+
+static PyMethodDef solver_pool_methods[] = {
+    {"preset", (PyCFunction) solver_pool_preset, METH_O, "sets parameters for instances handed out"},
+    {NULL} /* Sentinel */
+};
+
+static PyTypeObject solver_pool_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_scip.pool",                /* tp_name */
+    sizeof(solver_pool),         /* tp_basicsize */
+    0,                           /* tp_itemsize */
+    (destructor) solver_pool_dealloc, /* tp_dealloc */
+    0,                           /* tp_print */
+    0,                           /* tp_getattr */
+    0,                           /* tp_setattr */
+    0,                           /* tp_compare */
+    0,                           /* tp_repr */
+    0,                           /* tp_as_number */
+    0,                           /* tp_as_sequence */
+    0,                           /* tp_as_mapping */
+    0,                           /* tp_hash */
+    0,                           /* tp_call */
+    0,                           /* tp_str */
     0,                           /* tp_getattro */
     0,                           /* tp_setattro */
     0,                           /* tp_as_buffer */
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /* tp_flags */
-    "SCIP solver objects",       /* tp_doc */
+    "SCIP solver pools",         /* tp_doc */
     0,                           /* tp_traverse */
     0,                           /* tp_clear */
     0,                           /* tp_richcompare */
     0,                           /* tp_weaklistoffset */
     0,                           /* tp_iter */
     0,                           /* tp_iternext */
-    solver_methods,              /* tp_methods */
+    solver_pool_methods,         /* tp_methods */
+    solver_pool_members,         /* tp_members */
+    0,                           /* tp_getset */
+    0,                           /* tp_base */
+    0,                           /* tp_dict */
+    0,                           /* tp_descr_get */
+    0,                           /* tp_descr_set */
+    0,                           /* tp_dictoffset */
+    (initproc) solver_pool_init, /* tp_init */
+    0,                           /* tp_alloc */
+    0,                           /* tp_new */
+};
+
+static PyMethodDef preset_methods[] = {
+    {"write", (PyCFunction) preset_write, METH_VARARGS, "writes the parameters to a .set file"},
+    {NULL} /* Sentinel */
+};
+
+static PySequenceMethods preset_sequence = {
+    (lenfunc) preset_length,     /* sq_length */
+};
+
+static PyTypeObject preset_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_scip.preset",              /* tp_name */
+    sizeof(param_preset),        /* tp_basicsize */
+    0,                           /* tp_itemsize */
+    (destructor) preset_dealloc, /* tp_dealloc */
+    0,                           /* tp_print */
+    0,                           /* tp_getattr */
+    0,                           /* tp_setattr */
+    0,                           /* tp_compare */
+    0,                           /* tp_repr */
+    0,                           /* tp_as_number */
+    &preset_sequence,            /* tp_as_sequence */
+    0,                           /* tp_as_mapping */
+    0,                           /* tp_hash */
+    0,                           /* tp_call */
+    0,                           /* tp_str */
+    (getattrofunc) preset_getattr, /* tp_getattro */
+    0,                           /* tp_setattro */
+    0,                           /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /* tp_flags */
+    "compiled SCIP parameter presets", /* tp_doc */
+    0,                           /* tp_traverse */
+    0,                           /* tp_clear */
+    0,                           /* tp_richcompare */
+    0,                           /* tp_weaklistoffset */
+    0,                           /* tp_iter */
+    0,                           /* tp_iternext */
+    preset_methods,              /* tp_methods */
     0,                           /* tp_members */
     0,                           /* tp_getset */
     0,                           /* tp_base */
@@ -293,9 +1986,9 @@ static PyTypeObject solver_type = {
     0,                           /* tp_descr_get */
     0,                           /* tp_descr_set */
     0,                           /* tp_dictoffset */
-    (initproc) solver_init,      /* tp_init */
+    (initproc) preset_init,      /* tp_init */
     0,                           /* tp_alloc */
-    solver_new,                  /* tp_new */
+    0,                           /* tp_new */
 };
 
 #if PY_MAJOR_VERSION >= 3
@@ -321,21 +2014,67 @@ PyMODINIT_FUNC PyInit__scip(void) {
         return;
 #endif
 
+    solver_pool_type.tp_new = PyType_GenericNew;
+    if (PyType_Ready(&solver_pool_type) < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
+    preset_type.tp_new = PyType_GenericNew;
+    if (PyType_Ready(&preset_type) < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
+    // Callbacks get back into Python via PyGILState_Ensure, which needs
+    // threads initialized on older interpreters.
+#if PY_VERSION_HEX < 0x03070000
+    PyEval_InitThreads();
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&scip_module); 
 #else
     m = Py_InitModule3("_scip", NULL, "SCIP Solver");
 #endif
 
+    // Other modules find their shared type objects through this
+    scip_types.solver = &solver_type;
+    py_scip_types_table = &scip_types;
+    PyModule_AddObject(m, "_types", PyCapsule_New(&scip_types, PY_SCIP_TYPES_CAPSULE, NULL));
+
     // Constants on scip module
     PyModule_AddIntConstant(m, "BINARY", SCIP_VARTYPE_BINARY);
     PyModule_AddIntConstant(m, "INTEGER", SCIP_VARTYPE_INTEGER);
     PyModule_AddIntConstant(m, "IMPLINT", SCIP_VARTYPE_IMPLINT);
     PyModule_AddIntConstant(m, "CONTINUOUS", SCIP_VARTYPE_CONTINUOUS);
 
+    // Emphases and settings for presets
+    PyModule_AddIntConstant(m, "EMPHASIS_DEFAULT", SCIP_PARAMEMPHASIS_DEFAULT);
+    PyModule_AddIntConstant(m, "EMPHASIS_CPSOLVER", SCIP_PARAMEMPHASIS_CPSOLVER);
+    PyModule_AddIntConstant(m, "EMPHASIS_EASYCIP", SCIP_PARAMEMPHASIS_EASYCIP);
+    PyModule_AddIntConstant(m, "EMPHASIS_FEASIBILITY", SCIP_PARAMEMPHASIS_FEASIBILITY);
+    PyModule_AddIntConstant(m, "EMPHASIS_HARDLP", SCIP_PARAMEMPHASIS_HARDLP);
+    PyModule_AddIntConstant(m, "EMPHASIS_OPTIMALITY", SCIP_PARAMEMPHASIS_OPTIMALITY);
+    PyModule_AddIntConstant(m, "EMPHASIS_COUNTER", SCIP_PARAMEMPHASIS_COUNTER);
+    PyModule_AddIntConstant(m, "SETTING_DEFAULT", SCIP_PARAMSETTING_DEFAULT);
+    PyModule_AddIntConstant(m, "SETTING_AGGRESSIVE", SCIP_PARAMSETTING_AGGRESSIVE);
+    PyModule_AddIntConstant(m, "SETTING_FAST", SCIP_PARAMSETTING_FAST);
+    PyModule_AddIntConstant(m, "SETTING_OFF", SCIP_PARAMSETTING_OFF);
+
     Py_INCREF(&solver_type);
     PyModule_AddObject(m, "solver", (PyObject *) &solver_type);
 
+    Py_INCREF(&solver_pool_type);
+    PyModule_AddObject(m, "pool", (PyObject *) &solver_pool_type);
+
+    Py_INCREF(&preset_type);
+    PyModule_AddObject(m, "preset", (PyObject *) &preset_type);
+
     // Initialize exception type
     error = PyErr_NewException("_scip.error", NULL, NULL);
     Py_INCREF(error);
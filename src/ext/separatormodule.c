@@ -1,4 +1,5 @@
 #include "python_zibopt.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -14,14 +15,18 @@ static int separator_init(separator *self, PyObject *args, PyObject *kwds) {
     if (!PyArg_ParseTuple(args, "Os", &s, &name))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_XDECREF(self->solver_ref);
+    self->solver_ref = PyWeakref_NewRef(s, NULL);
+    if (self->solver_ref == NULL)
+        return -1;
     
     // Load the separator from SCIP
     r = SCIPfindSepa(self->scip, name);
@@ -35,18 +40,16 @@ static int separator_init(separator *self, PyObject *args, PyObject *kwds) {
 }
 
 static void separator_dealloc(separator *self) {
+    Py_XDECREF(self->solver_ref);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* separator_getattr(separator *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "frequency") == 0)
-            return Py_BuildValue("i", SCIPsepaGetFreq(self->sepa));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "maxbounddist") == 0)
-            return Py_BuildValue("d", SCIPsepaGetMaxbounddist(self->sepa));
-        if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0)
-            return Py_BuildValue("i", SCIPsepaGetPriority(self->sepa));
+        PY_SCIP_GET("frequency", "i", SCIPsepaGetFreq(self->sepa));
+        PY_SCIP_GET("maxbounddist", "d", SCIPsepaGetMaxbounddist(self->sepa));
+        PY_SCIP_GET("priority", "i", SCIPsepaGetPriority(self->sepa));
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -57,6 +60,7 @@ static int separator_setattr(separator *self, PyObject *attr_name, PyObject *val
     
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
+        PY_SCIP_CHECK_SETTINGS_IDLE(error, -1);
         PY_SCIP_SET_INT_MIN("frequency", self->sepa->freq, -1); 
         PY_SCIP_SET_DBL_MIN("maxbounddist", self->sepa->maxbounddist, -1); 
         PY_SCIP_SET_PRIORITY(SCIPsepaSetPriority, self->sepa);
@@ -144,6 +148,14 @@ PyMODINIT_FUNC PyInit__sepa(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&sepa_module); 
 #else
@@ -1,4 +1,8 @@
 #include "python_zibopt.h"
+#include "python_zibopt_buffer.h"
+#include "python_zibopt_control.h"
+#include "python_zibopt_error.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
@@ -8,26 +12,34 @@ static PyObject *error;
 static int solution_init(solution *self, PyObject *args, PyObject *kwds) {
     PyObject *s;   // solver Python object
     solver *solv;  // solver C object
+    SCIP_STATUS status;
 
     if (!PyArg_ParseTuple(args, "O", &s))
         return -1;
     
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
     self->scip = solv->scip;
+    Py_INCREF(solv);
+    Py_XDECREF(self->solv);
+    self->solv = solv;
     
     // Detect infeasibility
     self->solution = SCIPgetBestSol(self->scip);
     
-    self->optimal    = self->scip->stat->status == SCIP_STATUS_OPTIMAL;
-    self->infeasible = self->scip->stat->status == SCIP_STATUS_INFEASIBLE;
-    self->unbounded  = self->scip->stat->status == SCIP_STATUS_UNBOUNDED;
-    self->inforunbd  = self->scip->stat->status == SCIP_STATUS_INFORUNBD;
+    // Portfolio workers solve copies, so the winner's status stands in
+    status = PY_SCIP_PORTFOLIO_OUTCOME(solv) ? solv->portfolio.status : self->scip->stat->status;
+    self->optimal    = status == SCIP_STATUS_OPTIMAL;
+    self->infeasible = status == SCIP_STATUS_INFEASIBLE;
+    self->unbounded  = status == SCIP_STATUS_UNBOUNDED;
+    self->inforunbd  = status == SCIP_STATUS_INFORUNBD;
+    self->interrupted = status == SCIP_STATUS_USERINTERRUPT;
+    self->memlimit   = status == SCIP_STATUS_MEMLIMIT;
 
     // Extract objective value into Python float
     self->objective = SCIPgetSolOrigObj(self->scip, self->solution);
@@ -39,6 +51,7 @@ static int solution_init(solution *self, PyObject *args, PyObject *kwds) {
 }
 
 static void solution_dealloc(solution *self) {
+    Py_XDECREF(self->solv);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
@@ -49,7 +62,7 @@ static PyObject *solution_value(solution *self, PyObject *v) {
     variable *var;
 
     // Check and make sure we have a real variable type
-    if (strcmp(v->ob_type->tp_name, VARIABLE_TYPE_NAME)) {
+    if (!PyScipVariable_Check(v)) {
         PyErr_SetString(error, "invalid variable type");
         return NULL;
     }
@@ -64,6 +77,182 @@ static PyObject *solution_value(solution *self, PyObject *v) {
     return Py_BuildValue("d", SCIPgetSolVal(self->scip, self->solution, var->variable));
 }
 
+static int _solution_variables(solution *self, PyObject *v, SCIP_VAR ***vars, int *nvars) {
+    // Resolves a variable block, or None for every variable in the model
+    variable_block *block;
+
+    if (v == Py_None) {
+        *vars = SCIPgetOrigVars(self->scip);
+        *nvars = SCIPgetNOrigVars(self->scip);
+        return 0;
+    }
+
+    if (!PyScipVariableBlock_Check(v)) {
+        PyErr_SetString(error, "invalid variable block type");
+        return -1;
+    }
+    block = (variable_block *) v;
+
+    if (block->scip != self->scip) {
+        PyErr_SetString(error, "variables not associated with solver");
+        return -1;
+    }
+
+    // Block members are contiguous in the solver's registry
+    *vars = block->nvars > 0 ? (SCIP_VAR **) block->solv->vars.handles + block->start : NULL;
+    *nvars = block->nvars;
+    return 0;
+}
+
+static int _solution_output(py_scip_array *out, PyObject *o, Py_ssize_t size) {
+    // Output arrays have to hold doubles so we can write into them directly
+    if (PyScipArrayGet(error, o, out, "out", false, true))
+        return -1;
+
+    if (PyScipArrayReals(out) == NULL || out->size != size) {
+        PyScipArrayRelease(out);
+        PyErr_Format(error, "out must be an array of %zd doubles", size);
+        return -1;
+    }
+
+    return 0;
+}
+
+static PyObject *solution_values_into(solution *self, PyObject *args) {
+    // Writes values for a block of variables into an array of doubles
+    PyObject *v, *o;
+    py_scip_array out;
+    SCIP_VAR **vars;
+    int nvars;
+
+    if (!PyArg_ParseTuple(args, "OO", &v, &o))
+        return NULL;
+
+    if (_solution_variables(self, v, &vars, &nvars) || _solution_output(&out, o, nvars))
+        return NULL;
+
+    if (self->solution == NULL) {
+        PyScipArrayRelease(&out);
+        PyErr_SetString(error, "no solution available");
+        return NULL;
+    }
+
+    if (nvars > 0) {
+        SCIP_RETCODE retcode = SCIPgetSolVals(self->scip, self->solution, nvars, vars, PyScipArrayReals(&out));
+        if (retcode != SCIP_OKAY) {
+            PyScipArrayRelease(&out);
+            PyScipSetError(error, retcode);
+            return NULL;
+        }
+    }
+
+    PyScipArrayRelease(&out);
+    Py_RETURN_NONE;
+}
+
+static PyObject *solution_reduced_costs_into(solution *self, PyObject *args) {
+    // Writes root LP reduced costs for a block of variables into an array.
+    // SCIP only has them while solving, so the solver's control handler
+    // copies them as the root node is finished.
+    PyObject *v, *o;
+    py_scip_array out;
+    SCIP_VAR **vars;
+    int nvars, start;
+    bool found;
+
+    if (!PyArg_ParseTuple(args, "OO", &v, &o))
+        return NULL;
+
+    if (_solution_variables(self, v, &vars, &nvars) || _solution_output(&out, o, nvars))
+        return NULL;
+
+    start = v == Py_None ? 0 : ((variable_block *) v)->start;
+    found = PyScipControlRedcosts(self->solv->control, start, nvars, PyScipArrayReals(&out));
+    PyScipArrayRelease(&out);
+
+    if (!found) {
+        PyErr_SetString(error, "no LP reduced costs available");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *solution_duals_into(solution *self, PyObject *args) {
+    // Writes dual values for a constraint block or list of constraints.
+    // These come from the last LP solved, wherever it was in the tree.
+    PyObject *c, *o;
+    py_scip_array out;
+    SCIP_CONS *cons, *transformed;
+    SCIP_Real *values;
+    SCIP_OBJSENSE sense;
+    Py_ssize_t i, nconss;
+    bool is_block;
+
+    if (!PyArg_ParseTuple(args, "OO", &c, &o))
+        return NULL;
+
+    is_block = PyScipConstraintBlock_Check(c);
+    if (is_block) {
+        if (((constraint_block *) c)->scip != self->scip) {
+            PyErr_SetString(error, "constraints not associated with solver");
+            return NULL;
+        }
+        nconss = ((constraint_block *) c)->nconss;
+    } else if (PyList_CheckExact(c)) {
+        nconss = PyList_GET_SIZE(c);
+    } else {
+        PyErr_SetString(error, "constraint block or list required");
+        return NULL;
+    }
+
+    if (_solution_output(&out, o, nconss))
+        return NULL;
+
+    values = PyScipArrayReals(&out);
+    sense = SCIPgetObjsense(self->scip);
+    for (i = 0; i < nconss; i++) {
+        SCIP_RETCODE retcode;
+
+        if (is_block) {
+            constraint_block *block = (constraint_block *) c;
+            cons = block->solv->conss.handles[block->start + i];
+        } else {
+            PyObject *item = PyList_GET_ITEM(c, i);
+            if (!PyScipConstraint_Check(item) || ((constraint *) item)->scip != self->scip) {
+                PyScipArrayRelease(&out);
+                PyErr_SetString(error, "invalid constraint type");
+                return NULL;
+            }
+            cons = ((constraint *) item)->constraint;
+        }
+
+        // Only linear constraints have dual values
+        if (strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "linear")) {
+            PyScipArrayRelease(&out);
+            PyErr_SetString(error, "dual values require linear constraints");
+            return NULL;
+        }
+
+        // We have to get dual values off of the transformed problem
+        retcode = SCIPgetTransformedCons(self->scip, cons, &transformed);
+        if (retcode != SCIP_OKAY) {
+            PyScipArrayRelease(&out);
+            PyScipSetError(error, retcode);
+            return NULL;
+        }
+
+        // Presolving deletes rows it finds redundant, and upgrades others
+        // to more specific constraint types.  Those have no dual value.
+        if (transformed == NULL || SCIPconsIsDeleted(transformed))
+            values[i] = Py_NAN;
+        else
+            values[i] = sense * SCIPgetDualsolLinear(self->scip, transformed);
+    }
+
+    PyScipArrayRelease(&out);
+    Py_RETURN_NONE;
+}
+
 /*****************************************************************************/
 /* MODULE INITIALIZATION                                                     */
 /*****************************************************************************/
@@ -73,11 +262,16 @@ static PyMemberDef solution_members[] = {
     {"infeasible", T_BOOL, offsetof(solution, infeasible), READONLY, "solution is infeasible"},
     {"unbounded", T_BOOL, offsetof(solution, unbounded), READONLY, "solution is unbounded"},
     {"inforunbd", T_BOOL, offsetof(solution, inforunbd), READONLY, "solution is infeasible or unbounded"},
+    {"interrupted", T_BOOL, offsetof(solution, interrupted), READONLY, "solve was interrupted"},
+    {"memlimit", T_BOOL, offsetof(solution, memlimit), READONLY, "solve hit the memory limit"},
     {NULL} /* Sentinel */
 };
 
 static PyMethodDef solution_methods[] = {
     {"value", (PyCFunction) solution_value, METH_O, "get variable value in a solution"},
+    {"values_into", (PyCFunction) solution_values_into, METH_VARARGS, "write values for a variable block into an array"},
+    {"reduced_costs_into", (PyCFunction) solution_reduced_costs_into, METH_VARARGS, "write reduced costs for a variable block into an array"},
+    {"duals_into", (PyCFunction) solution_duals_into, METH_VARARGS, "write dual values for constraints into an array"},
     {NULL} /* Sentinel */
 };
 
@@ -146,6 +340,14 @@ PyMODINIT_FUNC PyInit__soln(void) {
         return;
 #endif
 
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&soln_module); 
 #else
@@ -1,11 +1,52 @@
 #include "python_zibopt.h"
+#include "python_zibopt_buffer.h"
 #include "python_zibopt_error.h"
+#include "python_zibopt_registry.h"
+#include "python_zibopt_types.h"
 
 static PyObject *error;
 
 /*****************************************************************************/
 /* PYTHON TYPE METHODS                                                       */
 /*****************************************************************************/
+static int _variable_adopt(variable *self, solver *solv, PyObject *kwds, int start, int n) {
+    // Wraps a variable the solver already has instead of creating a new
+    // one.  The index is relative to start, and must be less than n.
+    PyObject *index_obj;
+    long i;
+
+    index_obj = kwds ? PyDict_GetItemString(kwds, "index") : NULL;
+    if (index_obj == NULL || !PyLong_Check(index_obj)) {
+        PyErr_SetString(error, "existing variables require an integer index");
+        return -1;
+    }
+
+    i = PyLong_AsLong(index_obj);
+    if (solv == NULL || i < 0 || i >= n) {
+        PyErr_SetString(error, "variable index out of range");
+        return -1;
+    }
+
+    // Each variable gets at most one wrapper at a time so hashing stays
+    // sane.  The registry only borrows it, and forgets it once it's freed.
+    self->index = start + i;
+    if (solv->vars.wrappers[self->index] != NULL) {
+        PyErr_SetString(error, "variable is already wrapped");
+        return -1;
+    }
+
+    self->scip = solv->scip;
+    self->solv = solv;
+    self->variable = solv->vars.handles[self->index];
+    self->lower = SCIPvarGetLbOriginal(self->variable);
+    self->upper = SCIPvarGetUbOriginal(self->variable);
+
+    self->flyweight = &solv->vars;
+    PyScipRegistrySetWrapper(&solv->vars, self->index, (PyObject *) self);
+
+    return 0;
+}
+
 static int variable_init(variable *self, PyObject *args, PyObject *kwds) {
     static char *argnames[] = {"solver", "vartype", "coefficient", "lower", "upper", "priority", NULL};
     PyObject *s;     // solver Python object
@@ -19,14 +60,24 @@ static int variable_init(variable *self, PyObject *args, PyObject *kwds) {
     if (!PyArg_ParseTuple(args, "O|idddi", &s, &t, &c, &lhs, &rhs, &priority))
         return -1;
 
-    // Check solver type in the best way we seem to have available
-    if (strcmp(s->ob_type->tp_name, SOLVER_TYPE_NAME)) {
+    if (PyScipVariableBlock_Check(s)) {
+        variable_block *block = (variable_block *) s;
+        return _variable_adopt(self, block->solv, kwds, block->start, block->nvars);
+    }
+
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
         PyErr_SetString(error, "invalid solver type");
         return -1;
     }
     
     solv = (solver *) s;
+    if (kwds && PyDict_GetItemString(kwds, "index"))
+        return _variable_adopt(self, solv, kwds, 0, solv->vars.size);
+
+    PY_SCIP_CHECK_IDLE(error, -1, solv);
     self->scip = solv->scip;
+    self->solv = solv;
 
     // Defaults
     t = SCIP_VARTYPE_CONTINUOUS;
@@ -71,27 +122,35 @@ static int variable_init(variable *self, PyObject *args, PyObject *kwds) {
     self->lower = lhs;
     self->upper = rhs;
 
+    // The registry takes over our capture of the variable, and its index
+    // matches the variable's position in the original problem.
+    self->index = PyScipRegistryAdd(error, &solv->vars, self->variable, (PyObject *) self);
+    if (self->index < 0) {
+        SCIPreleaseVar(self->scip, &self->variable);
+        return -1;
+    }
+
     PY_SCIP_CALL(error, -1, SCIPaddVar(self->scip, self->variable));
 
     if (priority != 0)
         PY_SCIP_CALL(error, -1, SCIPchgVarBranchPriority(self->scip, self->variable, priority));
 
-    // Put new variable at head of linked list
-    self->next = (struct variable *) solv->first_var;
-    solv->first_var = self;
-
     return 0;
 }
 
 static void variable_dealloc(variable *self) {
+    if (self->flyweight != NULL)
+        PyScipRegistryDropWrapper(self->flyweight, self->index, (PyObject *) self);
     ((PyObject *) self)->ob_type->tp_free(self);
 }
 
 static PyObject* variable_getattr(variable *self, PyObject *attr_name) {
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
-        if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0)
+        if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0) {
+            PY_SCIP_CHECK_ASSOCIATED(error, NULL, self, "variable");
             return Py_BuildValue("i", SCIPvarGetBranchPriority(self->variable));
+        }
     }
     return PyObject_GenericGetAttr((PyObject *) self, attr_name);
 }
@@ -100,6 +159,8 @@ static int variable_setattr(variable *self, PyObject *attr_name, PyObject *value
     // Check and make sure we have a string as attribute name...
     if (PyUnicode_Check(attr_name)) {
         if (PyUnicode_CompareWithASCIIString(attr_name, "priority") == 0) {
+            PY_SCIP_CHECK_ASSOCIATED(error, -1, self, "variable");
+            PY_SCIP_CHECK_IDLE(error, -1, self->solv);
             if (PyLong_Check(value)) {
                 PY_SCIP_CALL(error, -1, SCIPchgVarBranchPriority(self->scip, self->variable, PyLong_AsLong(value)));
                 return 0;
@@ -116,6 +177,8 @@ static int variable_setattr(variable *self, PyObject *attr_name, PyObject *value
 /* ADDITONAL METHODS                                                         */
 /*****************************************************************************/
 static PyObject *variable_set_coefficient(variable *self, PyObject *arg) {
+    PY_SCIP_CHECK_ASSOCIATED(error, NULL, self, "variable");
+    PY_SCIP_CHECK_IDLE(error, NULL, self->solv);
     if (PyFloat_Check(arg) || PyLong_Check(arg)) {
         // SCIPvarChgObj Arguments:
         // var          variable to change
@@ -139,6 +202,8 @@ static PyObject *variable_set_coefficient(variable *self, PyObject *arg) {
 
 static PyObject *variable_tighten_lower(variable *self, PyObject *arg) {
     double d;
+    PY_SCIP_CHECK_ASSOCIATED(error, NULL, self, "variable");
+    PY_SCIP_CHECK_IDLE(error, NULL, self->solv);
     if (PyFloat_Check(arg) || PyLong_Check(arg)) {
         d = PyFloat_AsDouble(arg);
         if (d > self->lower) {
@@ -157,6 +222,8 @@ static PyObject *variable_tighten_lower(variable *self, PyObject *arg) {
 
 static PyObject *variable_tighten_upper(variable *self, PyObject *arg) {
     double d;
+    PY_SCIP_CHECK_ASSOCIATED(error, NULL, self, "variable");
+    PY_SCIP_CHECK_IDLE(error, NULL, self->solv);
     if (PyFloat_Check(arg) || PyLong_Check(arg)) {
         d = PyFloat_AsDouble(arg);
         if (d < self->upper) {
@@ -173,9 +240,472 @@ static PyObject *variable_tighten_upper(variable *self, PyObject *arg) {
     }
 }
 
+/*****************************************************************************/
+/* VARIABLE BLOCKS                                                           */
+/*****************************************************************************/
+static int _variable_block_adopt(variable_block *self, PyObject *args, PyObject *kwds) {
+    // Wraps n variables the solver already has, from index start on, like
+    // those a problem file brings in
+    static char *argnames[] = {"solver", "n", "start", NULL};
+    PyObject *s;
+    solver *solv;
+    int n, start;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oii", argnames, &s, &n, &start))
+        return -1;
+
+    if (!PyScipSolver_Check(s)) {
+        PyErr_SetString(error, "invalid solver type");
+        return -1;
+    }
+
+    solv = (solver *) s;
+    if (n < 0 || start < 0 || start + n > solv->vars.size) {
+        PyErr_SetString(error, "variable index out of range");
+        return -1;
+    }
+
+    Py_INCREF(solv);
+    Py_XDECREF(self->solv);
+    self->solv = solv;
+    self->scip = solv->scip;
+    self->start = start;
+    self->nvars = n;
+    return 0;
+}
+
+static SCIP_CONS *_variable_block_row(PyObject *rows, Py_ssize_t i) {
+    // Returns constraint i of a constraint block or a list checked by
+    // _variable_block_rows
+    constraint_block *block;
+
+    if (PyScipConstraintBlock_Check(rows)) {
+        block = (constraint_block *) rows;
+        return (SCIP_CONS *) block->solv->conss.handles[block->start + i];
+    }
+    return ((constraint *) PyList_GET_ITEM(rows, i))->constraint;
+}
+
+static Py_ssize_t _variable_block_rows(solver *solv, PyObject *rows) {
+    // Checks that rows is a constraint block, or a list of constraints, of
+    // linear constraints from solv.  Returns how many there are, or -1.
+    SCIP_CONS *cons;
+    PyObject *item;
+    Py_ssize_t i, n;
+
+    if (PyScipConstraintBlock_Check(rows)) {
+        if (((constraint_block *) rows)->solv != solv) {
+            PyErr_SetString(error, "constraint block not associated with solver");
+            return -1;
+        }
+        n = ((constraint_block *) rows)->nconss;
+    } else if (PyList_CheckExact(rows)) {
+        n = PyList_GET_SIZE(rows);
+    } else {
+        PyErr_SetString(error, "constraint block or list required");
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (PyList_CheckExact(rows)) {
+            item = PyList_GET_ITEM(rows, i);
+            if (!PyScipConstraint_Check(item) || ((constraint *) item)->scip != solv->scip) {
+                PyErr_SetString(error, "invalid constraint type");
+                return -1;
+            }
+        }
+
+        cons = _variable_block_row(rows, i);
+        if (strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "linear")) {
+            PyErr_SetString(error, "columns require linear constraints");
+            return -1;
+        }
+    }
+
+    return n;
+}
+
+static int variable_block_init(variable_block *self, PyObject *args, PyObject *kwds) {
+    static char *argnames[] = {"solver", "n", "vartype", "lower", "upper", "obj",
+        "rows", "indptr", "indices", "data", NULL};
+    PyObject *s;     // solver Python object
+    solver *solv;    // solver C object
+    int n;           // number of variables to create
+    int t;           // integer / binary / continuous
+    PyObject *lower_obj = NULL, *upper_obj = NULL, *obj_obj = NULL;
+    PyObject *rows = NULL, *indptr_obj = NULL, *indices_obj = NULL, *data_obj = NULL;
+    py_scip_array lower, upper, obj, indptr, indices, data;
+    SCIP_Real lhs, rhs, inf;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    Py_ssize_t nrows, k, beg, end;
+    int i, result = -1;
+
+    if (kwds && PyDict_GetItemString(kwds, "start"))
+        return _variable_block_adopt(self, args, kwds);
+
+    t = SCIP_VARTYPE_CONTINUOUS;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oi|iOOOOOOO", argnames, &s, &n,
+        &t, &lower_obj, &upper_obj, &obj_obj, &rows, &indptr_obj, &indices_obj, &data_obj))
+        return -1;
+    if (rows == Py_None)
+        rows = NULL;
+
+    // Check solver type
+    if (!PyScipSolver_Check(s)) {
+        PyErr_SetString(error, "invalid solver type");
+        return -1;
+    }
+
+    solv = (solver *) s;
+    PY_SCIP_CHECK_IDLE(error, -1, solv);
+    self->scip = solv->scip;
+    inf = SCIPinfinity(self->scip);
+
+    if (n < 0) {
+        PyErr_SetString(error, "number of variables must be nonnegative");
+        return -1;
+    }
+
+    // Variable type
+    if (t != SCIP_VARTYPE_BINARY && t != SCIP_VARTYPE_INTEGER && t != SCIP_VARTYPE_IMPLINT)
+        t = SCIP_VARTYPE_CONTINUOUS;
+
+    // Bounds and objective coefficients: arrays, single numbers or None
+    memset(&upper, 0, sizeof(py_scip_array));
+    memset(&obj, 0, sizeof(py_scip_array));
+    memset(&indptr, 0, sizeof(py_scip_array));
+    memset(&indices, 0, sizeof(py_scip_array));
+    memset(&data, 0, sizeof(py_scip_array));
+    if (PyScipArrayGetReals(error, lower_obj, &lower, "lower", n, -inf) ||
+        PyScipArrayGetReals(error, upper_obj, &upper, "upper", n, inf) ||
+        PyScipArrayGetReals(error, obj_obj, &obj, "obj", n, 0.0))
+        goto cleanup;
+
+    for (i = 0; i < n; i++) {
+        if (PyScipArrayReal(&upper, i) < PyScipArrayReal(&lower, i)) {
+            PyErr_SetString(error, "invalid variable: upper < lower");
+            goto cleanup;
+        }
+    }
+
+    // Columns in compressed sparse column format, with entries in existing
+    // linear constraints.  These are validated before anything changes.
+    if (rows != NULL) {
+        if ((nrows = _variable_block_rows(solv, rows)) < 0)
+            goto cleanup;
+
+        if (indptr_obj == NULL || indices_obj == NULL || data_obj == NULL) {
+            PyErr_SetString(error, "columns require indptr, indices and data");
+            goto cleanup;
+        }
+        if (PyScipArrayGet(error, indptr_obj, &indptr, "indptr", true, false) ||
+            PyScipArrayGet(error, indices_obj, &indices, "indices", true, false) ||
+            PyScipArrayGet(error, data_obj, &data, "data", false, false))
+            goto cleanup;
+
+        if (indptr.size != n + 1) {
+            PyErr_SetString(error, "indptr must have one more element than there are columns");
+            goto cleanup;
+        }
+        if (indices.size != data.size) {
+            PyErr_SetString(error, "indices and data must be the same length");
+            goto cleanup;
+        }
+
+        for (i = 0; i < n; i++) {
+            beg = PyScipArrayIndex(&indptr, i);
+            end = PyScipArrayIndex(&indptr, i+1);
+            if (beg < 0 || end < beg || end > indices.size) {
+                PyErr_SetString(error, "indptr must be nondecreasing and within indices");
+                goto cleanup;
+            }
+        }
+        for (k = 0; k < indices.size; k++) {
+            if (PyScipArrayIndex(&indices, k) < 0 || PyScipArrayIndex(&indices, k) >= nrows) {
+                PyErr_SetString(error, "row index out of range");
+                goto cleanup;
+            }
+        }
+
+        // Coefficients can only change on the original problem.  One
+        // restart covers every column, and the last incumbent still warm
+        // starts the next solve.
+        if ((retcode = SCIPfreeTransform(self->scip)) != SCIP_OKAY) {
+            PyScipSetError(error, retcode);
+            goto cleanup;
+        }
+    }
+
+    // Block members occupy a contiguous range of the solver's registry
+    if (PyScipRegistryReserve(error, &solv->vars, n))
+        goto cleanup;
+
+    Py_INCREF(solv);
+    Py_XDECREF(self->solv);
+    self->solv = solv;
+    self->start = solv->vars.size;
+
+    for (i = 0; i < n; i++) {
+        SCIP_VAR *var;
+
+        lhs = PyScipArrayReal(&lower, i);
+        rhs = PyScipArrayReal(&upper, i);
+        if (lhs < -inf) lhs = -inf;
+        if (rhs > inf)  rhs = inf;
+        if (t == SCIP_VARTYPE_BINARY) {
+            if (lhs < 0)
+                lhs = 0;
+            if (rhs > 1)
+                rhs = 1;
+        }
+
+        // See variable_init for SCIPcreateVar arguments
+        retcode = SCIPcreateVar(self->scip, &var, NULL, lhs, rhs, PyScipArrayReal(&obj, i),
+            t, TRUE, FALSE, NULL, NULL, NULL, NULL, NULL);
+        if (retcode != SCIP_OKAY)
+            break;
+
+        // Room was reserved above, so this can't fail
+        PyScipRegistryAdd(error, &solv->vars, var, NULL);
+        self->nvars++;
+
+        retcode = SCIPaddVar(self->scip, var);
+        if (retcode != SCIP_OKAY)
+            break;
+
+        if (rows != NULL) {
+            end = PyScipArrayIndex(&indptr, i+1);
+            for (k = PyScipArrayIndex(&indptr, i); retcode == SCIP_OKAY && k < end; k++) {
+                retcode = SCIPaddCoefLinear(self->scip,
+                    _variable_block_row(rows, PyScipArrayIndex(&indices, k)), var, PyScipArrayReal(&data, k));
+            }
+            if (retcode != SCIP_OKAY)
+                break;
+        }
+    }
+
+    if (retcode != SCIP_OKAY)
+        PyScipSetError(error, retcode);
+    else
+        result = 0;
+
+cleanup:
+    PyScipArrayRelease(&lower);
+    PyScipArrayRelease(&upper);
+    PyScipArrayRelease(&obj);
+    PyScipArrayRelease(&indptr);
+    PyScipArrayRelease(&indices);
+    PyScipArrayRelease(&data);
+    return result;
+}
+
+static int variable_block_traverse(variable_block *self, visitproc visit, void *arg) {
+    Py_VISIT(self->solv);
+    return 0;
+}
+
+static int variable_block_clear(variable_block *self) {
+    Py_CLEAR(self->solv);
+    return 0;
+}
+
+static void variable_block_dealloc(variable_block *self) {
+    PyObject_GC_UnTrack(self);
+    Py_CLEAR(self->solv);
+    ((PyObject *) self)->ob_type->tp_free(self);
+}
+
+static Py_ssize_t variable_block_length(variable_block *self) {
+    return self->nvars;
+}
+
+static PyObject *variable_block_wrapper(variable_block *self, PyObject *arg) {
+    // Returns the Python variable for a block member, or None if it
+    // hasn't been materialized yet
+    PyObject *v;
+    long i;
+
+    if (!PyLong_Check(arg)) {
+        PyErr_SetString(error, "variable index must be an integer");
+        return NULL;
+    }
+
+    i = PyLong_AsLong(arg);
+    if (i < 0 || i >= self->nvars || self->solv == NULL) {
+        PyErr_SetString(PyExc_IndexError, "variable index out of range");
+        return NULL;
+    }
+
+    v = self->solv->vars.wrappers[self->start + i];
+    if (v == NULL)
+        Py_RETURN_NONE;
+
+    Py_INCREF(v);
+    return v;
+}
+
+static int _variable_block_bounds(variable_block *self, PyObject *lower_obj,
+    PyObject *upper_obj, PyObject *mask_obj) {
+
+    // Sets bounds on block members from arrays or single numbers.  None
+    // leaves that side alone.  Only bounds that actually change, and only
+    // members selected by mask, cost a call into SCIP.  Returns the number
+    // of variables changed, or -1 on error.
+    SCIP_VAR **vars;
+    py_scip_array lower, upper, mask;
+    unsigned char *changed = NULL; // bit 1: lower changes, bit 2: upper changes
+    SCIP_Real lb, ub, newlb, newub, inf;
+    SCIP_RETCODE retcode = SCIP_OKAY;
+    int i, nchanged = 0, result = -1;
+
+    memset(&lower, 0, sizeof(py_scip_array));
+    memset(&upper, 0, sizeof(py_scip_array));
+    memset(&mask, 0, sizeof(py_scip_array));
+
+    if (self->solv == NULL) {
+        PyErr_SetString(error, "invalid variable block");
+        return -1;
+    }
+    PY_SCIP_CHECK_IDLE(error, -1, self->solv);
+
+    vars = (SCIP_VAR **) self->solv->vars.handles + self->start;
+    inf = SCIPinfinity(self->scip);
+
+    if ((lower_obj != Py_None && PyScipArrayGetReals(error, lower_obj, &lower, "lower", self->nvars, 0.0)) ||
+        (upper_obj != Py_None && PyScipArrayGetReals(error, upper_obj, &upper, "upper", self->nvars, 0.0)))
+        goto cleanup;
+
+    if (mask_obj != NULL && mask_obj != Py_None) {
+        if (PyScipArrayGet(error, mask_obj, &mask, "mask", true, false))
+            goto cleanup;
+        if (mask.size != self->nvars) {
+            PyErr_Format(error, "mask must have %d elements", self->nvars);
+            goto cleanup;
+        }
+    }
+
+    changed = calloc(self->nvars > 0 ? self->nvars : 1, sizeof(unsigned char));
+    if (changed == NULL) {
+        PyErr_SetString(error, "ran out of memory");
+        goto cleanup;
+    }
+
+    // Work out which bounds change before touching anything, so a bad
+    // entry doesn't leave the block half updated
+    for (i = 0; i < self->nvars; i++) {
+        if (mask.view.obj != NULL && !PyScipArrayIndex(&mask, i))
+            continue;
+
+        lb = SCIPvarGetLbOriginal(vars[i]);
+        ub = SCIPvarGetUbOriginal(vars[i]);
+        newlb = lower_obj != Py_None ? PyScipArrayReal(&lower, i) : lb;
+        newub = upper_obj != Py_None ? PyScipArrayReal(&upper, i) : ub;
+        if (newlb < -inf) newlb = -inf;
+        if (newub > inf)  newub = inf;
+
+        if (newub < newlb) {
+            PyErr_Format(error, "invalid bounds for variable %d: upper < lower", i);
+            goto cleanup;
+        }
+
+        changed[i] = (newlb != lb ? 1 : 0) | (newub != ub ? 2 : 0);
+        if (changed[i])
+            nchanged++;
+    }
+
+    if (nchanged > 0) {
+        // Bounds can be loosened as well as tightened, which SCIP only
+        // allows on the original problem.  One restart covers every change.
+        retcode = SCIPfreeTransform(self->scip);
+
+        for (i = 0; retcode == SCIP_OKAY && i < self->nvars; i++) {
+            PyObject *w;
+
+            if (!changed[i])
+                continue;
+
+            newlb = (changed[i] & 1) ? PyScipArrayReal(&lower, i) : SCIPvarGetLbOriginal(vars[i]);
+            newub = (changed[i] & 2) ? PyScipArrayReal(&upper, i) : SCIPvarGetUbOriginal(vars[i]);
+            if (newlb < -inf) newlb = -inf;
+            if (newub > inf)  newub = inf;
+
+            // Order the changes so lower never passes upper along the way
+            if (newlb > SCIPvarGetUbOriginal(vars[i])) {
+                retcode = SCIPchgVarUb(self->scip, vars[i], newub);
+                if (retcode == SCIP_OKAY)
+                    retcode = SCIPchgVarLb(self->scip, vars[i], newlb);
+            } else {
+                if (changed[i] & 1)
+                    retcode = SCIPchgVarLb(self->scip, vars[i], newlb);
+                if (retcode == SCIP_OKAY && (changed[i] & 2))
+                    retcode = SCIPchgVarUb(self->scip, vars[i], newub);
+            }
+
+            // Keep Python variables for block members in sync
+            w = self->solv->vars.wrappers[self->start + i];
+            if (w != NULL) {
+                ((variable *) w)->lower = newlb;
+                ((variable *) w)->upper = newub;
+            }
+        }
+
+        if (retcode != SCIP_OKAY) {
+            PyScipSetError(error, retcode);
+            goto cleanup;
+        }
+    }
+
+    result = nchanged;
+
+cleanup:
+    if (changed != NULL) free(changed);
+    PyScipArrayRelease(&lower);
+    PyScipArrayRelease(&upper);
+    PyScipArrayRelease(&mask);
+    return result;
+}
+
+static PyObject *variable_block_set_bounds(variable_block *self, PyObject *args, PyObject *kwds) {
+    static char *argnames[] = {"lower", "upper", "mask", NULL};
+    PyObject *lower = Py_None, *upper = Py_None, *mask = Py_None;
+    int nchanged;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OOO", argnames, &lower, &upper, &mask))
+        return NULL;
+
+    nchanged = _variable_block_bounds(self, lower, upper, mask);
+    if (nchanged < 0)
+        return NULL;
+    return Py_BuildValue("i", nchanged);
+}
+
+static PyObject *variable_block_fix(variable_block *self, PyObject *args, PyObject *kwds) {
+    static char *argnames[] = {"values", "mask", NULL};
+    PyObject *values, *mask = Py_None;
+    int nchanged;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", argnames, &values, &mask))
+        return NULL;
+
+    if (values == Py_None) {
+        PyErr_SetString(error, "values required to fix variables");
+        return NULL;
+    }
+
+    nchanged = _variable_block_bounds(self, values, values, mask);
+    if (nchanged < 0)
+        return NULL;
+    return Py_BuildValue("i", nchanged);
+}
+
 /*****************************************************************************/
 /* MODULE INITIALIZATION                                                     */
 /*****************************************************************************/
+static PyMemberDef variable_members[] = {
+    {"index", T_INT, offsetof(variable, index), READONLY, "solver index of the variable"},
+    {NULL} /* Sentinel */
+};
+
 static PyMethodDef variable_methods[] = {
     {"set_coefficient", (PyCFunction) variable_set_coefficient, METH_O, "updates objective coefficient for a variable"},
     {"tighten_lower_bound", (PyCFunction) variable_tighten_lower, METH_O, "adds a possible tightened lower bound for a variable"},
@@ -212,7 +742,7 @@ static PyTypeObject variable_type = {
     0,                             /* tp_iter */
     0,                             /* tp_iternext */
     variable_methods,              /* tp_methods */
-    0,                             /* tp_members */
+    variable_members,              /* tp_members */
     0,                             /* tp_getset */
     0,                             /* tp_base */
     0,                             /* tp_dict */
@@ -224,6 +754,63 @@ static PyTypeObject variable_type = {
     0,                             /* tp_new */
 };
 
+static PyMemberDef variable_block_members[] = {
+    {"start", T_INT, offsetof(variable_block, start), READONLY, "solver index of the first variable"},
+    {NULL} /* Sentinel */
+};
+
+static PyMethodDef variable_block_methods[] = {
+    {"fix", (PyCFunction) variable_block_fix, METH_VARARGS | METH_KEYWORDS, "fixes block members to values"},
+    {"set_bounds", (PyCFunction) variable_block_set_bounds, METH_VARARGS | METH_KEYWORDS, "sets bounds on block members"},
+    {"wrapper", (PyCFunction) variable_block_wrapper, METH_O, "returns the Python variable for a block member, if there is one"},
+    {NULL} /* Sentinel */
+};
+
+static PySequenceMethods variable_block_sequence = {
+    (lenfunc) variable_block_length, /* sq_length */
+};
+
+static PyTypeObject variable_block_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_vars.variable_block",        /* tp_name */
+    sizeof(variable_block),        /* tp_basicsize */
+    0,                             /* tp_itemsize */
+    (destructor) variable_block_dealloc, /* tp_dealloc */
+    0,                             /* tp_print */
+    0,                             /* tp_getattr */
+    0,                             /* tp_setattr */
+    0,                             /* tp_compare */
+    0,                             /* tp_repr */
+    0,                             /* tp_as_number */
+    &variable_block_sequence,      /* tp_as_sequence */
+    0,                             /* tp_as_mapping */
+    0,                             /* tp_hash */
+    0,                             /* tp_call */
+    0,                             /* tp_str */
+    0,                             /* tp_getattro */
+    0,                             /* tp_setattro */
+    0,                             /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC, /* tp_flags */
+    "SCIP variable blocks",        /* tp_doc */
+    (traverseproc) variable_block_traverse, /* tp_traverse */
+    (inquiry) variable_block_clear, /* tp_clear */
+    0,                             /* tp_richcompare */
+    0,                             /* tp_weaklistoffset */
+    0,                             /* tp_iter */
+    0,                             /* tp_iternext */
+    variable_block_methods,        /* tp_methods */
+    variable_block_members,        /* tp_members */
+    0,                             /* tp_getset */
+    0,                             /* tp_base */
+    0,                             /* tp_dict */
+    0,                             /* tp_descr_get */
+    0,                             /* tp_descr_set */
+    0,                             /* tp_dictoffset */
+    (initproc) variable_block_init, /* tp_init */
+    0,                             /* tp_alloc */
+    0,                             /* tp_new */
+};
+
 #if PY_MAJOR_VERSION >= 3
 static PyModuleDef vars_module = {
     PyModuleDef_HEAD_INIT,
@@ -248,15 +835,37 @@ PyMODINIT_FUNC PyInit__vars(void) {
         return;
 #endif
 
+    variable_block_type.tp_new = PyType_GenericNew;
+    if (PyType_Ready(&variable_block_type) < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
+    // Shared type objects for argument checks
+    if (PyScipImportTypes() < 0)
+#if PY_MAJOR_VERSION >= 3
+        return NULL;
+#else
+        return;
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     m = PyModule_Create(&vars_module); 
 #else
     m = Py_InitModule3("_vars", NULL, "SCIP Variable");
 #endif
 
+    py_scip_types_table->variable = &variable_type;
+    py_scip_types_table->variable_block = &variable_block_type;
+
     Py_INCREF(&variable_type);
     PyModule_AddObject(m, "variable", (PyObject *) &variable_type);
 
+    Py_INCREF(&variable_block_type);
+    PyModule_AddObject(m, "variable_block", (PyObject *) &variable_block_type);
+
     // Initialize exception type
     error = PyErr_NewException("_vars.error", NULL, NULL);
     Py_INCREF(error);
@@ -0,0 +1,45 @@
+from array import array
+from zibopt import scip
+import unittest
+
+class BatchTest(unittest.TestCase):
+    def knapsack(self, n):
+        # max sum(x) st sum((i+1)*x[i]) <= n, x binary
+        return {
+            'obj':     [1.0] * n,
+            'vartype': scip.BINARY,
+            'indptr':  [0, n],
+            'indices': list(range(n)),
+            'data':    [float(i+1) for i in range(n)],
+            'rhs':     n,
+            'sense':   'max'
+        }
+
+    def testSolveBatch(self):
+        '''Batches should match solving each model on its own'''
+        results = scip.solve_batch([self.knapsack(n) for n in (4, 6, 8, 10)], workers=2)
+        self.assertEqual(len(results), 4)
+
+        # Greedy on smallest weights is optimal for this knapsack
+        for r, expected in zip(results, (2, 3, 3, 4)):
+            self.assertTrue(r.optimal)
+            self.assertAlmostEqual(r.objective, expected)
+            self.assertAlmostEqual(sum(r.values), expected)
+
+    def testBatchStatus(self):
+        '''Infeasible models and models without constraints'''
+        infeasible = {'obj': [1.0], 'indptr': [0, 1], 'indices': [0], 'data': [1.0], 'lhs': 2, 'rhs': 1}
+        self.assertRaises(scip.BatchError, scip.solve_batch, [infeasible])
+
+        infeasible['lhs'], infeasible['rhs'] = 2, 3
+        infeasible['upper'] = 1
+        bounded = {'obj': array('d', [2.0, -1.0]), 'upper': 3, 'sense': 'max'}
+        r1, r2 = scip.solve_batch([infeasible, bounded])
+
+        self.assertFalse(r1)
+        self.assertTrue(r1.infeasible or r1.inforunbd)
+        self.assertAlmostEqual(r2.objective, 6)
+        self.assertEqual(list(r2.values), [3.0, 0.0])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,4 +1,6 @@
+from array import array
 from zibopt import scip
+import math
 import unittest
 
 class ConstraintTest(unittest.TestCase):
@@ -40,6 +42,41 @@ class ConstraintTest(unittest.TestCase):
         self.assertAlmostEqual(c.coefficients[(x1,)], 1.0)
         self.assertAlmostEqual(c.coefficients[(x2,)], 2.0)
 
+    def testExpressionBounds(self):
+        '''Bounds are pulled out of expressions, including x == y'''
+        solver = scip.solver()
+        x = solver.variable(upper=5)
+        y = solver.variable(upper=5)
+
+        c = solver.constraint(x + 1 == y)
+        self.assertAlmostEqual(c.lower, -1.0)
+        self.assertAlmostEqual(c.upper, -1.0)
+        self.assertAlmostEqual(c.coefficients[(x,)], 1.0)
+        self.assertAlmostEqual(c.coefficients[(y,)], -1.0)
+
+        c = solver.constraint(2 <= x + 3 <= 4)
+        self.assertAlmostEqual(c.lower, -1.0)
+        self.assertEqual(list(c.coefficients.keys()), [(x,)])
+
+        c = solver.constraint(x <= 2)
+        self.assertTrue(c.lower is None)
+        self.assertAlmostEqual(c.upper, 2.0)
+
+        self.assertAlmostEqual(solver.maximize(objective=y).objective, 3.0)
+        self.assertRaises(NotImplementedError, solver.constraint, x*x*y <= 1)
+
+    def testCoefficientReadback(self):
+        '''Coefficients are read back from SCIP, including block variables'''
+        solver = scip.solver()
+        x = solver.variables_array(2)
+        c = solver.constraint(3*x[1] + x[1] <= 4)
+        self.assertEqual(list(c.coefficients.keys()), [(x[1],)])
+        self.assertAlmostEqual(c.coefficients[(x[1],)], 4.0)
+
+        q = solver.constraint(2*x[0]*x[1] + x[0] <= 4)
+        self.assertAlmostEqual(q.coefficients[(x[0],)], 1.0)
+        self.assertEqual(sum(q.coefficients.values()), 3.0)
+
 class ConstraintRemovalTest(unittest.TestCase):
     def setUp(self):
         self.solver = scip.solver()
@@ -70,6 +107,41 @@ class ConstraintRemovalTest(unittest.TestCase):
         self.solver += self.c2
         self.assertAlmostEqual(1.0, self.solver.maximize(objective=self.x1+self.x2).objective)
 
+    def testActiveConstraints(self):
+        '''solver.constraints only lists constraints in the problem'''
+        self.assertEqual(self.solver.constraints, (self.c1, self.c2))
+        self.solver -= self.c1
+        self.assertEqual(self.solver.constraints, (self.c2,))
+        self.solver += self.c1
+        self.assertEqual(self.solver.constraints, (self.c1, self.c2))
+        self.assertEqual(self.solver.variables, (self.x1, self.x2))
+
+    def testBatchedChanges(self):
+        '''Constraints change in batches, skipping ones already in place'''
+        objective = self.x1 + self.x2
+        self.assertEqual(self.solver.remove_many([self.c2]), 1)
+        self.assertEqual(self.solver.remove_many([self.c2]), 0)
+        self.assertAlmostEqual(2.0, self.solver.maximize(objective=objective).objective)
+
+        self.assertEqual(self.solver.add_many([self.c1, self.c2]), 1)
+        self.assertAlmostEqual(1.0, self.solver.maximize(objective=objective).objective)
+
+    def testModify(self):
+        '''Changes inside modify() are applied together when it ends'''
+        with self.solver.modify():
+            self.solver -= self.c1
+            self.solver -= self.c2
+            self.solver += self.c1
+            self.assertEqual(self.solver.constraints, (self.c1, self.c2))
+        self.assertEqual(self.solver.constraints, (self.c1,))
+
+        def fail():
+            with self.solver.modify():
+                self.solver -= self.c1
+                raise ValueError
+        self.assertRaises(ValueError, fail)
+        self.assertEqual(self.solver.constraints, (self.c1,))
+
 class ConstraintAttributesTest(unittest.TestCase):
     def setUp(self):
         self.solver = scip.solver()
@@ -85,6 +157,17 @@ class ConstraintAttributesTest(unittest.TestCase):
         self.assertAlmostEqual(self.c2.dual_sol_linear, 0.8)
         self.solver.restart()
 
+    def testDualArray(self):
+        '''Tests LP shadow prices extracted in bulk, NaN off the problem'''
+        c3 = self.solver.constraint(self.x1 <= 10)
+        self.solver -= c3
+        solution = self.solver.maximize(objective=3*self.x1 + 5*self.x2)
+        duals = solution.duals([self.c1, self.c2, c3])
+        self.assertAlmostEqual(duals[0], 1.4)
+        self.assertAlmostEqual(duals[1], 0.8)
+        self.assertTrue(math.isnan(duals[2]))
+        self.solver.restart()
+
     def testMinDualSolLinear(self):
         '''Tests LP shadow prices on a minimization problem'''
         solution = self.solver.minimize(objective=-(3*self.x1 + 5*self.x2))
@@ -92,6 +175,87 @@ class ConstraintAttributesTest(unittest.TestCase):
         self.assertAlmostEqual(self.c2.dual_sol_linear, -0.8)
         self.solver.restart()
 
+class BulkConstraintTest(unittest.TestCase):
+    def setUp(self):
+        self.solver = scip.solver()
+        self.x = [self.solver.variable() for i in range(3)]
+
+    def testAddLinearConstraints(self):
+        '''Adds constraints in CSR format from lists and arrays'''
+        block = self.solver.add_linear_constraints(
+            indptr  = array('i', [0, 2, 4]),
+            indices = array('i', [0, 1, 1, 2]),
+            data    = array('d', [1.0, 2.0, 1.0, 1.0]),
+            upper   = [4, 3]
+        )
+        self.assertEqual(len(block), 2)
+
+        solution = self.solver.maximize(objective=sum(self.x))
+        self.assertAlmostEqual(solution.objective, 7.0)
+        self.assertAlmostEqual(solution[self.x[1]], 0.0)
+
+    def testBlockRows(self):
+        '''Block rows can be indexed, removed and added back like constraints'''
+        block = self.solver.add_linear_constraints(
+            [0, 2, 4, 7], [0, 1, 1, 2, 0, 1, 2], [1, 2, 1, 1, 1, 1, 1], upper=[4, 3, 5]
+        )
+        objective = sum(self.x)
+        row = block[0]
+        self.assertIs(block[-3], row)
+        self.assertEqual(row.terms(), {(0,): 1.0, (1,): 2.0})
+        self.assertAlmostEqual(row.upper, 4.0)
+        self.assertIsNone(row.lower)
+        self.assertRaises(IndexError, block.__getitem__, 3)
+
+        # Rows remember being removed after their wrappers are gone
+        self.solver -= block[2]
+        self.assertAlmostEqual(self.solver.maximize(objective=objective).objective, 7.0)
+        self.assertEqual(self.solver.add_many(block[1:]), 1)
+        self.assertAlmostEqual(self.solver.maximize(objective=objective).objective, 5.0)
+        self.assertEqual(self.solver.remove_many(block), 3)
+
+        with self.solver.modify():
+            for r in block:
+                self.solver += r
+            self.solver -= block[2]
+        self.assertAlmostEqual(self.solver.maximize(objective=objective).objective, 7.0)
+
+    def testScalarBounds(self):
+        '''A single number applies as a bound to every row'''
+        self.solver.add_linear_constraints([0, 1, 2, 3], [0, 1, 2], [1, 1, 1], upper=2)
+        solution = self.solver.maximize(objective=sum(self.x))
+        self.assertAlmostEqual(solution.objective, 6.0)
+
+    def testLinearExpr(self):
+        '''Linear expressions hand their terms straight to SCIP'''
+        x0, x1, x2 = self.x
+        first = self.solver.quicksum([(1, x0), (2, x1)])
+        self.solver += first <= 4
+        self.assertIsNone(first.expr_upper)
+
+        second = self.solver.linear_expr()
+        second += x1
+        second += 2 * x2 - 1
+        second -= x2
+        self.solver += second <= 2
+        self.assertEqual(len(second), 3)
+        self.assertEqual(second.terms(), {x1.index: 1.0, x2.index: 1.0})
+
+        objective = self.solver.quicksum(self.x)
+        objective += 1
+        solution = self.solver.maximize(objective=objective)
+        self.assertAlmostEqual(solution.objective, 8.0)
+        self.assertAlmostEqual(solution[x1], 0.0)
+
+    def testBulkConstraintErrors(self):
+        '''Bad CSR input raises a ConstraintError'''
+        add = self.solver.add_linear_constraints
+        self.assertRaises(scip.ConstraintError, add, [0, 1], [3], [1.0], upper=1)
+        self.assertRaises(scip.ConstraintError, add, [0, 2], [0], [1.0], upper=1)
+        self.assertRaises(scip.ConstraintError, add, [0, 1], [0, 1], [1.0], upper=1)
+        self.assertRaises(scip.ConstraintError, add, [0, 1], [0], [1.0], lower=2, upper=1)
+        self.assertRaises(scip.ConstraintError, add, [0, 1], [0], [1.0])
+
 if __name__ == '__main__':
     unittest.main()
 
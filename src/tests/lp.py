@@ -1,10 +1,71 @@
 from zibopt._lp import lp, MAXIMIZE, MINIMIZE
+from zibopt import lp as direct
 import unittest
 
 class LPInterfaceTest(unittest.TestCase):
     def testSimpleLP(self):
         lp(MAXIMIZE)
 
+    def testInvalidSense(self):
+        '''Objective senses other than MAXIMIZE and MINIMIZE are rejected'''
+        self.assertRaises(direct.LPError, lp, 0)
+
+class DirectLPTest(unittest.TestCase):
+    def setUp(self):
+        # max x0 + x1 subject to x0 + 2*x1 <= 4, 3*x0 + x1 <= 6
+        self.lp = direct.lp(direct.MAXIMIZE)
+        self.assertEqual(self.lp.add_cols(2, obj=[1, 1]), 0)
+        self.assertEqual(self.lp.add_rows([0, 2, 4], [0, 1, 0, 1], [1, 2, 3, 1], upper=[4, 6]), 0)
+
+    def testSolve(self):
+        '''Bulk built LPs solve without the MIP machinery'''
+        self.assertEqual((self.lp.ncols, self.lp.nrows), (2, 2))
+        self.assertTrue(self.lp.solve_primal())
+        self.assertAlmostEqual(self.lp.objective, 2.8)
+
+        x = self.lp.primal()
+        self.assertAlmostEqual(x[0], 1.6)
+        self.assertAlmostEqual(x[1], 1.2)
+        for activity, side in zip(self.lp.activities(), [4, 6]):
+            self.assertAlmostEqual(activity, side)
+
+    def testResolve(self):
+        '''Changed sides, bounds and objectives re-solve from the last basis'''
+        self.lp.solve_primal()
+
+        self.lp.set_sides([0], -float('inf'), 2)
+        self.assertTrue(self.lp.solve_dual())
+        self.assertAlmostEqual(self.lp.objective, 2.0)
+
+        self.lp.set_sides([0], -float('inf'), 4)
+        self.lp.set_bounds([0], 0, 1)
+        self.assertTrue(self.lp.solve_dual())
+        self.assertAlmostEqual(self.lp.objective, 2.5)
+
+        self.lp.set_objective([0, 1], [2, 0])
+        self.assertTrue(self.lp.solve_primal())
+        self.assertAlmostEqual(self.lp.objective, 2.0)
+
+    def testBasis(self):
+        '''Bases carry over to LPs of the same shape'''
+        self.lp.solve_primal()
+        cstat, rstat = self.lp.basis()
+        self.assertEqual(list(cstat), [direct.BASIC, direct.BASIC])
+
+        other = direct.lp(direct.MAXIMIZE)
+        other.add_cols(2, obj=[1, 1])
+        other.add_rows([0, 2, 4], [0, 1, 0, 1], [1, 2, 3, 1], upper=[4, 6])
+        other.set_basis(cstat, rstat)
+        self.assertTrue(other.solve_primal())
+        self.assertAlmostEqual(other.objective, 2.8)
+
+    def testErrors(self):
+        '''Bad indices and bounds raise an LPError'''
+        self.assertRaises(direct.LPError, self.lp.add_rows, [0, 1], [2], [1.0], upper=1)
+        self.assertRaises(direct.LPError, self.lp.add_rows, [0, 1], [0], [1.0])
+        self.assertRaises(direct.LPError, self.lp.add_cols, 1, indptr=[0, 1], indices=[2], data=[1.0])
+        self.assertRaises(direct.LPError, self.lp.set_bounds, [0], 2, 1)
+        self.assertRaises(direct.LPError, self.lp.set_objective, [5], 1)
+
 if __name__ == '__main__':
     unittest.main()
-
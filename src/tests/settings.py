@@ -26,6 +26,21 @@ class SettingsTest(unittest.TestCase):
         self.assertTrue(solver.selector_names())
         self.assertTrue(solver.separator_names())
 
+    def testLazySettings(self):
+        '''Settings objects are only built on lookup, and cached after'''
+        solver = scip.solver()
+        self.assertEqual(list(solver.heuristics), solver.heuristic_names())
+        self.assertEqual(len(solver.separators), len(solver.separator_names()))
+        self.assertFalse(solver.heuristics._cache)
+
+        name = solver.heuristic_names()[0]
+        self.assertIn(name, solver.heuristics)
+        self.assertNotIn('NOSUCHRULE', solver.heuristics)
+        self.assertIs(solver.heuristics[name], solver.heuristics[name])
+        self.assertEqual(list(solver.heuristics._cache), [name])
+        self.assertRaises(KeyError, solver.heuristics.__getitem__, 'NOSUCHRULE')
+        self.assertIsNone(solver.branching.get('NOSUCHRULE'))
+
     def testBranchRuleSettings(self):
         '''Sets branching priority, maxdepth, etc'''
         solver = scip.solver()
@@ -1,5 +1,10 @@
-from zibopt import scip, _vars, _cons
+from array import array
+from zibopt import scip, _scip, _vars, _cons
+import os
+import tempfile
+import threading
 import unittest
+import weakref
 
 class ScipTest(unittest.TestCase):
     def testLoadSolver(self):
@@ -104,6 +109,139 @@ class ScipTest(unittest.TestCase):
         self.assertRaises(scip.ConstraintError, solver2.constraint, v1 <= 1)
         self.assertRaises(scip.SolverError, solver2.maximize, objective=v1<=3)
         
+    def testWarmStart(self):
+        '''Partial and carried-over starts shouldn't change the optimum'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(3)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+        self.assertTrue(solver.reuse_incumbent)
+
+        # Only x[2] is known, so SCIP has to fill in the rest
+        solver.warm_start({x[2]: 4})
+        solution = solver.maximize(objective=2*x[0] + 3*x[1] + 4*x[2])
+        self.assertAlmostEqual(solution.objective, 26)
+
+        # After an edit the old incumbent is infeasible and gets dropped
+        solver += x[0] <= 5
+        solution = solver.maximize(objective=2*x[0] + 3*x[1] + 4*x[2])
+        self.assertAlmostEqual(solution.objective, 23)
+
+        solver.warm_start(array('d', [float('nan'), 0]), nodes=0)
+        solver.reuse_incumbent = False
+        solution = solver.maximize(objective=2*x[0] + 3*x[1] + 4*x[2])
+        self.assertAlmostEqual(solution.objective, 23)
+
+        other = scip.solver()
+        self.assertRaises(scip.SolverError, solver.warm_start, {other.variable(): 1})
+        self.assertRaises(scip.SolverError, solver.warm_start, [0, 0, 0, 0])
+        solver.warm_start(None)
+
+    def testStatistics(self):
+        '''Statistics should cover solving, plugins and model building'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(3)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+        self.assertIsNone(solver.statistics()['primal_bound'])
+
+        # Bounds are only recorded once presolving is done
+        solver.set_params({'presolving/maxrounds': 0})
+        solution = solver.maximize(objective=2*x[0] + 3*x[1] + 4*x[2])
+
+        stats = solver.statistics()
+        self.assertTrue(stats['solving_time'] >= stats['presolving_time'] >= 0)
+        self.assertTrue(stats['nodes'] >= 0)
+        self.assertAlmostEqual(stats['primal_bound'], solution.objective)
+        for name in solver.heuristics.keys():
+            calls, time, found = stats['heuristics'][name]
+            self.assertTrue(calls >= 0 and time >= 0 and found >= 0)
+        self.assertEqual(set(stats['separators']), set(solver.separators.keys()))
+
+        # Each entry improves on the one before, ending at the optimum
+        history = stats['history']
+        self.assertTrue(history)
+        for before, after in zip(history, history[1:]):
+            self.assertTrue(after[0] >= before[0] and after[1] >= before[1])
+            self.assertTrue(after[2] >= before[2] and after[3] <= before[3])
+            self.assertNotEqual(before[2:], after[2:])
+        self.assertAlmostEqual(history[-1][2], solution.objective)
+        self.assertTrue(history[-1][3] >= solution.objective - 1e-6)
+
+        for phase in 'variables', 'constraints', 'objective':
+            self.assertTrue(stats['build'][phase] >= 0)
+        self.assertFalse('load' in stats['build'])
+
+        solver.restart()
+        self.assertIsNone(solver.statistics()['gap'])
+
+    def _market_split(self, solver, m=4, n=36):
+        '''Builds a market split instance, which takes SCIP a long time'''
+        x = [solver.variable(scip.BINARY) for j in range(n)]
+        for i in range(m):
+            a = [(7 * i + 13 * j) % 97 + 1 for j in range(n)]
+            solver += sum(a[j] * x[j] for j in range(n)) == sum(a) // 2
+        return x
+
+    def testInterrupt(self):
+        '''Other threads can stop a solve or tighten its limits'''
+        solver = scip.solver()
+        self.assertFalse(solver.interrupt())
+        self.assertFalse(solver.set_limits(gap=0.1))
+        self.assertRaises(scip.SolverError, solver.set_limits, nsol=1e20)
+        x = self._market_split(solver)
+
+        # Node snapshots are delivered on another thread while the solve
+        # is known to be running
+        def at_first_node(f):
+            running = []
+            def callback(snapshots):
+                if not running:
+                    running.append(f())
+            solver.set_callback(callback, batch=1, nodes=1)
+            return running
+
+        running = at_first_node(solver.interrupt)
+        solution = solver.maximize(objective=sum(x), time=60)
+        self.assertEqual(running, [True])
+        self.assertTrue(solution.interrupted)
+
+        solver.restart()
+        running = at_first_node(lambda: solver.set_limits(time=0))
+        solution = solver.maximize(objective=sum(x), time=60)
+        self.assertEqual(running, [True])
+        self.assertFalse(solution.interrupted)
+        self.assertFalse(solution.optimal)
+        solver.set_callback(None)
+
+    def testMemoryLimit(self):
+        '''Memory use is readable during a solve, and limits stop it'''
+        solver = scip.solver()
+        x = self._market_split(solver)
+        self.assertTrue(solver.memory_usage() > 0)
+
+        used = []
+        timer = threading.Timer(0.5, lambda: used.append(solver.memory_usage()))
+        timer.start()
+        solution = solver.maximize(objective=sum(x), time=2)
+        timer.join()
+        self.assertTrue(used[0] > 0)
+        self.assertFalse(solution.memlimit)
+
+        solver.restart()
+        solution = solver.maximize(objective=sum(x), memory=0)
+        self.assertTrue(solution.memlimit)
+        self.assertFalse(solution.optimal)
+
+    def testImpostorTypes(self):
+        '''Types that only share a name with ours are rejected'''
+        class variable(object):
+            pass
+        class solver(object):
+            pass
+        s = scip.solver()
+        s.variable()
+        self.assertRaises(scip.SolverError, s.maximize, solution={variable(): 1.0})
+        self.assertRaises(scip.VariableError, _vars.variable, solver())
+
     def testConstantInMax(self):
         '''Test a constant in maximization, like maximize(objective=x+4)'''
         solver = scip.solver()
@@ -140,6 +278,419 @@ class ScipTest(unittest.TestCase):
         solution = solver.minimize(objective=x)
         self.assertAlmostEqual(solution.objective, 3)
         
+    def testObjectiveUpdates(self):
+        '''Re-solving should pick up only the objective coefficients given'''
+        solver = scip.solver()
+        x = solver.variable(upper=2)
+        y = solver.variables_array(2, upper=3, obj=1)
+        solver += x + y[0] + y[1] <= 4
+
+        self.assertAlmostEqual(solver.maximize().objective, 4)
+        self.assertAlmostEqual(solver.maximize(objective=2*x).objective, 4)
+        self.assertAlmostEqual(solver.maximize(objective=2*x).objective, 4)
+        self.assertAlmostEqual(solver.minimize(objective=2*x).objective, 0)
+        self.assertAlmostEqual(solver.maximize(objective=x+y[0]).objective, 4)
+        self.assertAlmostEqual(solver.maximize(objective=x+y[0]+1).objective, 5)
+        self.assertFalse(solver.set_objective((x+y[0]).terms))
+        self.assertTrue(solver.set_objective((x+y[1]).terms))
+
+    def testResolveAfterParams(self):
+        '''A finished solve starts over with new parameters, not the old result'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(3)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+        objective = 2*x[0] + 3*x[1] + 4*x[2]
+        self.assertTrue(solver.maximize(objective=objective).optimal)
+
+        # Only a solve that actually runs reaches the callback
+        snapshots = []
+        solver.set_callback(snapshots.extend, nodes=1)
+        solver.set_params({'presolving/maxrounds': 0})
+        solution = solver.maximize(objective=objective)
+        self.assertTrue(solution.optimal)
+        self.assertAlmostEqual(solution.objective, 26.0)
+        self.assertTrue(snapshots)
+
+    def testSolutionArrays(self):
+        '''Extracts solution values in bulk'''
+        solver = scip.solver()
+        y = solver.variable(scip.INTEGER, coefficient=1, upper=5)
+        x = solver.variables_array(3, scip.INTEGER, upper=[1, 2, 3], obj=1)
+        solution = solver.maximize()
+
+        values = solution.to_array(x)
+        self.assertEqual(list(values), [1.0, 2.0, 3.0])
+        self.assertEqual(list(solution.to_array()), [5.0, 1.0, 2.0, 3.0])
+
+        out = array('d', [0.0] * 3)
+        self.assertIs(solution.to_array(x, out=out), out)
+        self.assertEqual(list(out), [1.0, 2.0, 3.0])
+        self.assertRaises(scip.SolutionError, solution.to_array, x, array('d', [0.0]))
+
+    def testReducedCostsAndDuals(self):
+        '''LP reduced costs and duals are extracted in bulk after solving'''
+        # max 3x0 + 5x1 + x2 subject to x0 + 3x1 + x2 <= 4, 2x0 + x1 + x2 <= 6
+        solver = scip.solver()
+        solver.set_params({'presolving/maxrounds': 0})
+        x = solver.variables_array(3, obj=[3, 5, 1])
+        s = x.start
+        rows = solver.add_linear_constraints(
+            [0, 3, 6], [s, s+1, s+2] * 2, [1, 3, 1, 2, 1, 1], upper=[4, 6]
+        )
+        solution = solver.maximize()
+        self.assertAlmostEqual(solution.objective, 10.4)
+
+        duals = solution.duals(rows)
+        self.assertAlmostEqual(duals[0], 1.4)
+        self.assertAlmostEqual(duals[1], 0.8)
+
+        redcosts = solution.reduced_costs(x)
+        self.assertAlmostEqual(redcosts[0], 0.0)
+        self.assertAlmostEqual(redcosts[1], 0.0)
+        self.assertAlmostEqual(redcosts[2], -1.2)
+        self.assertEqual(list(solution.reduced_costs()), list(redcosts))
+
+        self.assertRaises(scip.SolutionError, solution.reduced_costs, x, array('d', [0.0]))
+        self.assertRaises(scip.SolutionError, solution.duals, [x[0]])
+
+    def testThreadedSolvers(self):
+        '''Independent solvers should be able to run in separate threads'''
+        results = {}
+        def knapsack(n):
+            solver = scip.solver()
+            x = [solver.variable(scip.BINARY) for i in range(n)]
+            solver += sum((i+1)*x[i] for i in range(n)) <= n
+            results[n] = solver.maximize(objective=sum(x)).objective
+
+        threads = [threading.Thread(target=knapsack, args=(n,)) for n in (4, 6, 8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        # Greedy on smallest weights is optimal for this knapsack
+        self.assertAlmostEqual(results[4], 2)
+        self.assertAlmostEqual(results[6], 3)
+        self.assertAlmostEqual(results[8], 3)
+
+    def testPortfolioSolve(self):
+        '''Racing settings profiles should agree with a normal solve'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(3)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+        solver += x[0] - x[1] >= 1
+
+        profiles = [{}, {'separating/maxrounds': 0}, {'heuristics/rounding/freq': -1}]
+        solution = solver.portfolio_solve(profiles, objective=2*x[0] + 3*x[1] + 4*x[2])
+        self.assertTrue(solution.optimal)
+        self.assertIn(solution.profile, range(3))
+        self.assertAlmostEqual(solution.objective, 2*solution[x[0]] + 3*solution[x[1]] + 4*solution[x[2]])
+
+        # Status and bounds are the winner's
+        stats = solver.statistics()
+        self.assertAlmostEqual(stats['primal_bound'], solution.objective)
+        self.assertAlmostEqual(stats['dual_bound'], solution.objective)
+        self.assertAlmostEqual(stats['gap'], 0.0)
+
+        solver.restart()
+        self.assertAlmostEqual(solver.maximize().objective, solution.objective)
+
+        # Stopping on a limit of its own profile doesn't decide the race
+        solver.restart()
+        solution = solver.portfolio_solve([{'limits/nodes': 1}, {}], objective=2*x[0] + 3*x[1] + 4*x[2])
+        self.assertTrue(solution.optimal)
+
+        # Unless every worker does
+        solver.restart()
+        solution = solver.portfolio_solve([{'limits/nodes': 1}], objective=2*x[0] + 3*x[1] + 4*x[2])
+        self.assertEqual(solution.profile, 0)
+
+        solver.restart()
+        self.assertRaises(scip.SolverError, solver.portfolio_solve, [{'no/such/param': 1}])
+        self.assertRaises(scip.SolverError, solver.portfolio_solve, [])
+        self.assertRaises(scip.SolverError, solver.portfolio_solve, [{}], threads=2)
+
+    def _while_solving(self, f, solve):
+        '''Runs solve, calling f from another thread until it returns True'''
+        done = threading.Event()
+        called = []
+        def run():
+            while not done.wait(0.01):
+                if f():
+                    called.append(True)
+                    return
+
+        thread = threading.Thread(target=run)
+        thread.start()
+        try:
+            solution = solve()
+        finally:
+            done.set()
+            thread.join()
+        self.assertTrue(called)
+        return solution
+
+    def testPortfolioControl(self):
+        '''Interrupts and limits from other threads reach portfolio workers'''
+        solver = scip.solver()
+        x = self._market_split(solver)
+        race = lambda: solver.portfolio_solve([{}, {}], objective=sum(x), time=60)
+
+        solution = self._while_solving(solver.interrupt, race)
+        self.assertTrue(solution.interrupted)
+
+        solver.restart()
+        solution = self._while_solving(lambda: solver.set_limits(time=0), race)
+        self.assertFalse(solution.interrupted)
+        self.assertFalse(solution.optimal)
+
+    def testSolverPool(self):
+        '''Pooled solvers should start from an empty problem every time'''
+        pool = scip.SolverPool(1, params={'limits/solutions': -1})
+        self.assertEqual(pool.idle, 1)
+
+        for n in (4, 6):
+            solver = pool.solver()
+            self.assertEqual(pool.idle, 0)
+            self.assertEqual(solver.nvars, 0)
+
+            x = [solver.variable(scip.BINARY) for i in range(n)]
+            solver += sum((i+1)*x[i] for i in range(n)) <= n
+            self.assertAlmostEqual(solver.maximize(objective=sum(x)).objective, n // 2)
+
+            # Constraints don't hold their solver, so this needs no collection
+            del solver, x
+            self.assertEqual(pool.idle, 1)
+
+        pool.preset({'no/such/param': 1})
+        self.assertRaises(scip.SolverError, pool.solver)
+
+    def testPresets(self):
+        '''Presets compile once and apply to solvers, pools and portfolios'''
+        limited = scip.preset({'limits/nodes': -1, 'display/verblevel': 0})
+        self.assertEqual(limited.params, {'limits/nodes': -1, 'display/verblevel': 0})
+
+        fast = scip.preset(emphasis='feasibility', presolving='off')
+        self.assertTrue(len(fast) > 0)
+        self.assertNotIn('misc/catchctrlc', fast.params)
+
+        handle, path = tempfile.mkstemp(suffix='.set')
+        os.close(handle)
+        try:
+            fast.write(path)
+            self.assertEqual(scip.preset(file=path).params, fast.params)
+        finally:
+            os.remove(path)
+
+        pool = scip.SolverPool(params=fast)
+        solver = pool.solver()
+        solver.set_params(limited, reset=True)
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(2)]
+        solver += x[0] + 2*x[1] <= 7
+        solution = solver.portfolio_solve([fast, {}], objective=x[0] + x[1])
+        self.assertAlmostEqual(solution.objective, 7.0)
+
+        self.assertRaises(scip.SolverError, scip.preset, emphasis='nosuchemphasis')
+        self.assertRaises(scip.SolverError, scip.preset, {'no/such/param': 1})
+        self.assertRaises(scip.SolverError, solver.set_params, 1)
+
+    def testBusyWrappers(self):
+        '''Variables, constraints and settings can't change during a solve'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(3)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+        c = solver.constraint(x[0] <= 1)
+        solver -= c
+        heuristic = solver.heuristics[solver.heuristic_names()[0]]
+
+        changes = [
+            (scip.VariableError, lambda: x[0].set_coefficient(5)),
+            (scip.VariableError, lambda: x[0].tighten_lower_bound(1)),
+            (scip.VariableError, lambda: x[0].tighten_upper_bound(9)),
+            (scip.VariableError, lambda: setattr(x[0], 'priority', 5)),
+            (scip.ConstraintError, c.register),
+            (scip.HeuristicError, lambda: setattr(heuristic, 'priority', 5)),
+        ]
+        refused = []
+        def change(snapshots):
+            errors = []
+            for error, f in changes:
+                try:
+                    f()
+                except error:
+                    errors.append(error)
+            refused.append(errors)
+
+        solver.set_callback(change, nodes=1)
+        solver.maximize(objective=2*x[0] + 3*x[1] + 4*x[2])
+        self.assertTrue(refused)
+        for errors in refused:
+            self.assertEqual(errors, [error for error, f in changes])
+
+        # Once the solve is over the same changes go through
+        solver.restart()
+        solver.set_callback(None)
+        for error, f in changes:
+            f()
+        self.assertEqual(x[0].priority, 5)
+        self.assertEqual(heuristic.priority, 5)
+
+        del solver
+        self.assertRaises(scip.HeuristicError, setattr, heuristic, 'priority', 1)
+        self.assertRaises(scip.HeuristicError, getattr, heuristic, 'priority')
+
+    def testWeakReference(self):
+        '''The extension type itself takes weak references'''
+        solver = _scip.solver()
+        ref = weakref.ref(solver)
+        self.assertIs(ref(), solver)
+        del solver
+        self.assertIsNone(ref())
+
+    def testProgressCallback(self):
+        '''Incumbents should reach the callback, and its errors should stop solving'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(3)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+
+        snapshots = []
+        solver.set_callback(snapshots.extend, batch=4, nodes=1)
+        solution = solver.maximize(objective=2*x[0] + 3*x[1] + 4*x[2])
+
+        incumbents = [s for s in snapshots if s.kind == 'incumbent']
+        self.assertTrue(incumbents)
+        self.assertAlmostEqual(incumbents[-1].objective, solution.objective)
+        self.assertEqual(len(incumbents[-1].values), 3)
+        for s in snapshots:
+            if s.kind == 'node':
+                self.assertIsNone(s.values)
+
+        def fail(snapshots):
+            raise ValueError('stop')
+
+        solver.restart()
+        solver.set_callback(fail)
+        self.assertRaises(ValueError, solver.maximize)
+
+        solver.restart()
+        solver.set_callback(None)
+        self.assertAlmostEqual(solver.maximize().objective, solution.objective)
+        self.assertRaises(scip.SolverError, solver.set_callback, 42)
+
+    def testLazyRows(self):
+        '''Rows from a lazy callback should cut off solutions during the search'''
+        solver = scip.solver()
+        x = [solver.variable(scip.BINARY) for i in range(3)]
+        self.assertEqual([v.index for v in x], [0, 1, 2])
+
+        calls = []
+        def at_most_one(values, integral):
+            calls.append(integral)
+            if sum(values) <= 1.5:
+                return None
+            return [0, 3], [0, 1, 2], [1.0, 1.0, 1.0], None, [1]
+
+        solver.set_lazy(at_most_one)
+        solution = solver.maximize(objective=x[0] + 2*x[1] + x[2])
+        self.assertTrue(solution.optimal)
+        self.assertAlmostEqual(solution.objective, 2)
+        self.assertAlmostEqual(solution[x[1]], 1)
+        self.assertTrue(calls)
+        self.assertTrue(all(calls))
+
+        def fail(values, integral):
+            raise ValueError('stop')
+
+        solver.set_lazy(fail)
+        self.assertRaises(ValueError, solver.maximize)
+
+        solver.set_lazy(lambda values, integral: ([0, 1], [7], [1.0], None, [0]))
+        self.assertRaises(scip.SolverError, solver.maximize)
+
+        solver.set_lazy(None)
+        self.assertAlmostEqual(solver.maximize().objective, 4)
+
+    def testSolutionPool(self):
+        '''Stored solutions should come back best first, in one matrix'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, upper=10) for i in range(3)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+        solution = solver.maximize(objective=2*x[0] + 3*x[1] + 4*x[2] + 1)
+
+        values, objectives = solver.solutions()
+        self.assertEqual(len(objectives), solver.nsols)
+        self.assertEqual(len(values), solver.nsols * 3)
+        self.assertAlmostEqual(objectives[0], solution.objective)
+        for i in range(len(objectives)):
+            row = values[3*i:3*i+3]
+            self.assertAlmostEqual(objectives[i], 2*row[0] + 3*row[1] + 4*row[2] + 1)
+            if i > 0:
+                self.assertTrue(objectives[i] <= objectives[i-1] + 1e-6)
+
+        values, objectives = solver.solutions(1)
+        self.assertEqual(len(objectives), 1)
+        self.assertEqual(list(values), solution.to_array().tolist())
+        self.assertRaises(scip.SolverError, solver.solutions_into, array('d', [0]), array('d', [0]))
+
+    def testReadWrite(self):
+        '''Problems written to a file should read back as blocks'''
+        solver = scip.solver()
+        x = [solver.variable(scip.INTEGER, coefficient=c, upper=10) for c in (2, 3, 4)]
+        solver += x[0] + 2*x[1] + 3*x[2] <= 14
+        solver += x[0] - x[1] >= 1
+        solution = solver.maximize()
+
+        handle, path = tempfile.mkstemp(suffix='.lp')
+        os.close(handle)
+        try:
+            solver.write(path)
+            self.assertRaises(scip.SolverError, solver.read, path)
+
+            copy = scip.solver()
+            y, rows = copy.read(path)
+            self.assertEqual(len(y), 3)
+            self.assertEqual(len(rows), 2)
+            self.assertEqual(copy.nvars, 3)
+
+            result = copy.maximize()
+            self.assertAlmostEqual(result.objective, solution.objective)
+            self.assertTrue(result[y[0]] - result[y[1]] >= 1 - 1e-6)
+            self.assertEqual(len(result.to_array(y)), 3)
+        finally:
+            os.remove(path)
+
+        self.assertRaises(scip.SolverError, scip.solver().read, path)
+
+    def testSnapshot(self):
+        '''Snapshots should restore a model that solves the same way'''
+        solver = scip.solver()
+        x = solver.variables_array(3, scip.INTEGER, upper=10, obj=[2, 3, 4])
+        y = solver.variable(scip.CONTINUOUS, coefficient=0.5, upper=2)
+        solver += x[0] + 2*x[1] + 3*x[2] + y <= 14
+        solver += x[0] - x[1] >= 1
+        solution = solver.maximize()
+
+        handle, path = tempfile.mkstemp()
+        os.close(handle)
+        try:
+            solver.save_snapshot(path)
+
+            copy = scip.solver()
+            copy.variable()
+            z, rows = copy.load_snapshot(path)
+            self.assertEqual((z.start, len(z), len(rows)), (1, 4, 2))
+            self.assertAlmostEqual(copy.maximize().objective, solution.objective)
+
+            with open(path, 'rb') as f:
+                data = f.read()
+            self.assertRaises(scip.SolverError, scip.solver().load_snapshot, data[:-1])
+            self.assertRaises(scip.SolverError, scip.solver().load_snapshot, b'x' + data[1:])
+        finally:
+            os.remove(path)
+
+        solver += x[0] * x[1] <= 20
+        self.assertRaises(scip.SolverError, solver.save_snapshot, path)
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -1,4 +1,5 @@
 from zibopt import scip
+import gc
 import unittest
 
 class VariableTest(unittest.TestCase):
@@ -19,6 +20,20 @@ class VariableTest(unittest.TestCase):
         x = solver.variable(priority=10)
         self.assertAlmostEqual(x.priority, 10)
 
+    def testOrphanedVariable(self):
+        '''Variables and constraints that outlive their solver raise errors'''
+        solver = scip.solver()
+        x = solver.variable()
+        c = solver.constraint(x <= 1)
+        del solver
+
+        self.assertRaises(scip.VariableError, x.set_coefficient, 1)
+        self.assertRaises(scip.VariableError, x.tighten_lower_bound, 0)
+        self.assertRaises(scip.VariableError, x.tighten_upper_bound, 0)
+        self.assertRaises(scip.VariableError, setattr, x, 'priority', 1)
+        self.assertRaises(scip.ConstraintError, c.terms)
+        self.assertRaises(scip.ConstraintError, c.register)
+
     def testExpressionBounds(self):
         '''Tests that bounds are cleared by constraint construction'''
         solver = scip.solver()
@@ -34,6 +49,104 @@ class VariableTest(unittest.TestCase):
         solution = solver.minimize(objective=x)
         self.assertAlmostEqual(solution.objective, 2)
         
+class VariableBlockTest(unittest.TestCase):
+    def testVariablesArray(self):
+        '''Creates variables in bulk with per-variable bounds and objective'''
+        solver = scip.solver()
+        x = solver.variables_array(3, upper=[1, 2, 3], obj=1)
+        self.assertEqual(len(x), 3)
+        self.assertEqual(x.start, 0)
+
+        solution = solver.maximize()
+        self.assertAlmostEqual(solution.objective, 6.0)
+
+    def testBlockIndexing(self):
+        '''Block members are materialized once and usable in expressions'''
+        solver = scip.solver()
+        y = solver.variable()
+        x = solver.variables_array(4, scip.BINARY)
+        self.assertEqual(x.start, 1)
+        self.assertIs(x[2], x[2])
+        self.assertIs(x[-1], x[3])
+        self.assertRaises(IndexError, lambda: x[4])
+
+        solver += x[0] + x[1] <= 1
+        solution = solver.maximize(objective=x[0] + x[1])
+        self.assertAlmostEqual(solution.objective, 1.0)
+
+    def testBlockFlyweights(self):
+        '''Member wrappers go away with their last reference'''
+        solver = scip.solver()
+        x = solver.variables_array(3, upper=2)
+        v = x[1]
+        self.assertEqual(solver.variables, (v,))
+
+        # Expressions can refer back to their variables, so collect cycles
+        del v
+        gc.collect()
+        self.assertIsNone(x.wrapper(1))
+        self.assertEqual(solver.variables, ())
+
+        # A new wrapper is the same variable underneath
+        solver += x[1] >= 1
+        solution = solver.minimize(objective=x[1])
+        self.assertAlmostEqual(solution.objective, 1.0)
+        self.assertAlmostEqual(solution[x[1]], 1.0)
+
+    def testBlockConstraints(self):
+        '''Block indices feed straight into bulk constraints'''
+        solver = scip.solver()
+        x = solver.variables_array(2, scip.INTEGER, obj=[1, 2])
+        s = x.start
+        solver.add_linear_constraints([0, 2], [s, s+1], [1, 1], upper=3.5)
+        solution = solver.maximize()
+        self.assertAlmostEqual(solution.objective, 6.0)
+
+    def testAddColumns(self):
+        '''Columns go into existing linear constraints in bulk'''
+        solver = scip.solver()
+        x = solver.variables_array(2, obj=1)
+        rows = solver.add_linear_constraints([0, 1, 2], [x.start, x.start+1], [1, 1], upper=[4, 3])
+        self.assertAlmostEqual(solver.maximize().objective, 7.0)
+
+        # max x0 + x1 + 3y subject to x0 + y <= 4, x1 + y <= 3
+        y = solver.add_columns(rows, [0, 2], [0, 1], [1, 1], obj=3, upper=10)
+        self.assertEqual(len(y), 1)
+        solution = solver.maximize()
+        self.assertAlmostEqual(solution.objective, 10.0)
+        self.assertAlmostEqual(solution[y[0]], 3.0)
+
+        c = solver.constraint(x[0] <= 0.5)
+        solver.add_columns([c], [0, 1], [0], [1.0], obj=1)
+        self.assertAlmostEqual(solver.maximize().objective, 9.5)
+
+        q = solver.constraint(x[0]*x[1] <= 1)
+        self.assertRaises(scip.VariableError, solver.add_columns, rows, [0, 1], [2], [1.0])
+        self.assertRaises(scip.VariableError, solver.add_columns, rows, [0, 2], [0], [1.0])
+        self.assertRaises(scip.VariableError, solver.add_columns, [q], [0, 1], [0], [1.0])
+
+    def testBlockBounds(self):
+        '''Bounds on whole blocks change in one call, skipping no-ops'''
+        solver = scip.solver()
+        x = solver.variables_array(3, scip.INTEGER, upper=5, obj=1)
+        self.assertAlmostEqual(solver.maximize().objective, 15.0)
+
+        self.assertEqual(solver.set_bounds(x, upper=[5, 2, 1]), 2)
+        self.assertAlmostEqual(solver.maximize().objective, 8.0)
+
+        self.assertEqual(solver.fix(x, [1, 1, 1], mask=[True, False, True]), 2)
+        self.assertAlmostEqual(solver.maximize().objective, 4.0)
+        self.assertEqual(solver.fix(x, [1, 1, 1], mask=[True, False, True]), 0)
+
+        self.assertRaises(scip.VariableError, solver.set_bounds, x, lower=3, upper=[5, 2, 1])
+        self.assertRaises(scip.SolverError, scip.solver().fix, x, 0)
+
+    def testVariablesArrayErrors(self):
+        '''Mismatched lengths and inverted bounds raise VariableError'''
+        solver = scip.solver()
+        self.assertRaises(scip.VariableError, solver.variables_array, 2, lower=[0, 0, 0])
+        self.assertRaises(scip.VariableError, solver.variables_array, 1, lower=2, upper=1)
+
 if __name__ == '__main__':
     unittest.main()
 
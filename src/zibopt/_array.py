@@ -0,0 +1,23 @@
+'''
+Helpers for the bulk APIs.  These accept anything that supports the
+buffer protocol, like NumPy arrays or array.array instances.  Plain
+sequences are copied into an array.array first as a convenience.
+'''
+
+from array import array
+
+__all__ = 'as_buffer', 'new_array'
+
+def as_buffer(values, typecode='d'):
+    '''Returns values unchanged if it is a buffer, else array(typecode)'''
+    if values is None or isinstance(values, (int, float)):
+        return values
+    try:
+        memoryview(values)
+        return values
+    except TypeError:
+        return array(typecode, values)
+
+def new_array(size, typecode='d'):
+    '''Returns a zeroed array.array of the given size'''
+    return array(typecode, [0]) * size
@@ -0,0 +1,97 @@
+from zibopt import _batch, _scip
+from zibopt._array import as_buffer, new_array
+import multiprocessing
+
+__all__ = 'solve_batch', 'batch_solution', 'BatchError'
+
+BatchError = _batch.error
+
+class batch_solution(object):
+    '''
+    A solution to one model from solve_batch.  Values are read by the
+    model's variable indices, or all at once through the values array::
+
+        x0_value = result[0]
+
+    Like solver solutions, results are false in boolean context when the
+    model is infeasible or unbounded, and have the same status flags.
+    '''
+    def __init__(self, values, objective, optimal, infeasible, unbounded, inforunbd, found):
+        self.values     = values if found else None
+        self.objective  = objective
+        self.optimal    = optimal
+        self.infeasible = infeasible
+        self.unbounded  = unbounded
+        self.inforunbd  = inforunbd
+
+    def __bool__(self):
+        return not (self.infeasible or self.unbounded or self.inforunbd)
+    __nonzero__ = __bool__
+
+    def __getitem__(self, index):
+        if self.values is None:
+            raise BatchError('no solution available')
+        return self.values[index]
+
+def solve_batch(models, workers=None, time=None, gap=0.0, absgap=0.0, quiet=True):
+    '''
+    Solves many independent models on a pool of native threads and returns
+    a list of batch_solution instances in the same order.  Each thread keeps
+    one SCIP instance for all the models it solves, so SCIP setup is paid
+    once per thread instead of once per model.
+
+    Every model is a dict of arrays, single numbers or None.  Variables are
+    referred to by position.  Keys:
+
+        - obj:             objective coefficient per variable (required)
+        - lower=0:         lower bounds on variables
+        - upper=None:      upper bounds on variables (+inf)
+        - vartype=CONTINUOUS: variable types
+        - indptr=None:     constraint matrix in compressed sparse row
+                           format, as in solver.add_linear_constraints
+        - indices=None:    variable indices for each entry
+        - data=None:       coefficients for each entry
+        - lhs=None:        lower bound per constraint (-inf)
+        - rhs=None:        upper bound per constraint (+inf)
+        - sense='min':     'max' or 'min'
+
+    Parameters:
+
+        - models:       sequence of model dicts
+        - workers=None: number of threads, by default one per CPU
+        - time=None:    optional time limit for each model
+        - gap=0.0:      optional gap percentage to stop solving
+        - absgap=0.0:   optional primal/dual gap to stop solving
+        - quiet=True:   turns the SCIP solver output off
+    '''
+    specs = []
+    outs = []
+    for model in models:
+        sense = model.get('sense', 'min')
+        if sense not in ('max', 'min'):
+            raise BatchError("sense must be 'max' or 'min'")
+
+        obj = as_buffer(model['obj'])
+        out = new_array(len(memoryview(obj)))
+        indptr = model.get('indptr')
+        specs.append((
+            obj,
+            as_buffer(model.get('lower', 0)),
+            as_buffer(model.get('upper')),
+            as_buffer(model.get('vartype', _scip.CONTINUOUS), 'b'),
+            None if indptr is None else as_buffer(indptr, 'l'),
+            as_buffer(model.get('indices', ()), 'l'),
+            as_buffer(model.get('data', ())),
+            as_buffer(model.get('lhs')),
+            as_buffer(model.get('rhs')),
+            sense == 'max',
+            out
+        ))
+        outs.append(out)
+
+    kwds = {'gap': gap, 'absgap': absgap, 'quiet': quiet}
+    if time is not None:
+        kwds['time'] = time
+
+    results = _batch.solve(specs, workers or multiprocessing.cpu_count(), **kwds)
+    return [batch_solution(out, *r) for out, r in zip(outs, results)]
@@ -1,8 +1,7 @@
-from algebraic import expression
 from zibopt import _cons
-from zibopt._variable import variable
+import weakref
 
-__all__ = 'constraint', 'ConstraintError'
+__all__ = 'constraint', 'constraint_block', 'ConstraintError'
 
 ConstraintError = _cons.error
 
@@ -15,96 +14,71 @@ class constraint(_cons.constraint):
         solver += 3*x**2 - 4*x >= 5*y
         solver += 3 <= 4*y <= 5
     '''
-    def __init__(self, solver, expr):
-        expr_lower = expr_upper = None
-
-        # Make sure we are in the middle if there are two bounds
-        if expr.expr_lower is None and expr.expr_upper and expr.expr_upper.expr_upper:
-            expr = expr.expr_upper
-        elif expr.expr_upper is None and expr.expr_lower and expr.expr_lower.expr_lower:
-            expr = expr.expr_lower
-
-        # Cancel out terms from lhs/rhs and keep constants
-        if expr.expr_lower and expr.expr_upper is expr.expr_lower:
-            # Special case where x == y.  This keeps from double-counting
-            # one side of the constraint.
-            expr = expr - expr.expr_lower
-            expr_lower = expr_upper = -expr.terms.pop((), 0.0)
-            expr.expr_lower = expr_lower
-            expr.expr_upper = expr_upper
-
-        else:
-            # Logic for constraints constructed via <= and >=
-            if expr.expr_lower:
-                e = expr - expr.expr_lower
-                e.expr_lower = expr.expr_lower
-                e.expr_upper = expr.expr_upper
-                expr = e
-                expr_lower = -expr.terms.pop((), 0.0) # just the constant
-    
-            if expr.expr_upper:
-                e = expr - expr.expr_upper
-                e.expr_lower = expr.expr_lower
-                e.expr_upper = expr.expr_upper
-                expr = e
-                expr_upper = -expr.terms.pop((), 0.0) # just the constant
-
-        # Make sure we have at least one bound
-        if expr_lower is None and expr_upper is None:
-            raise ConstraintError('at least one bound is required')
-
-        # Be polite: only pass in expr_upper and expr_lower bounds if we have them
-        kwds = {}
-        if expr_lower is not None:
-            kwds['lower'] = expr_lower
-        if expr_upper is not None:
-            kwds['upper'] = expr_upper
-
-        # If expr_upper < expr_lower: constraint error
-        if expr_upper is not None and expr_lower is not None and expr_upper < expr_lower:
-            raise ConstraintError('invalid constraint: expr_upper < expr_lower')
-
-        # Separate out variables by term type (linear/bilinear)
-        linear_vars = [] # information for linear terms
-        linear_coef = []
-        bilin_var1  = [] # information for bilinear terms
-        bilin_var2  = []
-        bilin_coef  = []
-
-        for term in expr.terms:
-            coef = expr[term]
-
-            # SCIP supports linear terms (3*x) and bilinear (3*x*y + 4*x**2).
-            # Everything else should raise a NotImplementedError.
-            if len(term) == 1:
-                linear_vars.append(term[0])
-                linear_coef.append(coef)
-
-            elif len(term) == 2:
-                bilin_var1.append(term[0])
-                bilin_var2.append(term[1])
-                bilin_coef.append(coef)
-
-            else:
-                raise NotImplementedError('unsupported term type in constraint')
-
-        super(constraint, self).__init__(
-            solver,
-            linear_vars,
-            linear_coef,
-            bilin_var1,
-            bilin_var2,
-            bilin_coef,
-            **kwds
+    def __init__(self, solver, *args, **kwds):
+        # Bounds are pulled out of the expression and its terms are handed
+        # to SCIP in C.  Coefficients are read back out of SCIP on demand.
+        # Block rows are wrapped as constraint(block, index=i).
+        super(constraint, self).__init__(solver, *args, **kwds)
+        if isinstance(solver, constraint_block):
+            solver = solver.solver
+
+        # The solver's registry owns this wrapper, so a strong reference
+        # back would keep solvers alive until the cycle collector runs.
+        self._solver = weakref.ref(solver)
+
+    @property
+    def solver(self):
+        '''Solver the constraint belongs to'''
+        solver = self._solver()
+        if solver is None:
+            raise ConstraintError('constraint not associated with solver')
+        return solver
+
+    @property
+    def coefficients(self):
+        '''Dictionary of variable tuples to coefficients, like {(x,): 2.0}'''
+        return {
+            tuple(self.solver._variable(i) for i in key): coef
+            for key, coef in self.terms().items()
+        }
+
+
+class constraint_block(_cons.constraint_block):
+    '''
+    Handles for a block of linear constraints created in a single call by
+    solver.add_linear_constraints(...).  Rows are given in CSR format::
+
+        # x0 + 2*x1 <= 4 and 1 <= x1 + x2 <= 3
+        block = solver.add_linear_constraints(
+            indptr  = [0, 2, 4],
+            indices = [0, 1, 1, 2],
+            data    = [1.0, 2.0, 1.0, 1.0],
+            lower   = [-float('inf'), 1],
+            upper   = [4, 3]
         )
 
-        # Clear off expression bounds if necessary.  This is so we can
-        # keep reuse variables without mucking things up, since bounds 
-        # are stored on expression (and thus variable) instances.
-        expr._clear_bounds()
+    Column indices refer to variables in the order they were added to the
+    solver.  The block does not create a Python object per row.  Indexing
+    it builds a constraint for a row when it's needed, which can be
+    removed and added back like any other::
 
-        # Keep this information so we can look it up later
-        self.lower = expr_lower
-        self.upper = expr_upper
-        self.coefficients = expr.terms.copy()
+        solver -= block[0]
+        solver.add_many(block[:2])
 
+    As with variable blocks, the solver doesn't keep these alive, and a
+    row's constraint is rebuilt if it's indexed again after being freed.
+    '''
+    def __init__(self, solver, *args, **kwds):
+        super(constraint_block, self).__init__(solver, *args, **kwds)
+        self.solver = solver
+
+    def __getitem__(self, i):
+        if isinstance(i, slice):
+            return [self[j] for j in range(*i.indices(len(self)))]
+        if i < 0:
+            i += len(self)
+
+        c = self.wrapper(i)
+        if c is None:
+            c = constraint(self, index=i)
+        return c
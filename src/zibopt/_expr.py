@@ -0,0 +1,38 @@
+from zibopt import _expr
+
+__all__ = 'linear_expr', 'ExpressionError'
+
+ExpressionError = _expr.error
+
+class linear_expr(_expr.linear_expr):
+    '''
+    A linear expression stored as flat arrays of variable indices and
+    coefficients, for sums too big to build as python-algebraic
+    expressions.  Terms are only appended, so adding to one is constant
+    time, and repeated variables are left for SCIP to merge::
+
+        e = solver.linear_expr()
+        for i, v in enumerate(x):
+            e.add(v, weights[i])
+        e.add_terms(block, costs)
+        solver += e <= 100
+
+    solver.quicksum builds one from an iterable in a single pass.
+
+    Supported in place operators are +=, -= and *= by a number.  Variables,
+    numbers, other linear expressions and linear python-algebraic
+    expressions can be added.  Comparisons with numbers set bounds on the
+    expression itself, so 1 <= e <= 2 works as in python-algebraic.
+    Constraints take the bounds off the expression once they are built.
+    '''
+    def __init__(self, solver):
+        super(linear_expr, self).__init__(solver)
+
+    @property
+    def coefficients(self):
+        '''Dictionary of variable tuples to coefficients, like {(x,): 2.0}'''
+        return {
+            (self.solver._variable(i),): coef
+            for i, coef in self.terms().items()
+        }
+
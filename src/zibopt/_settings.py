@@ -46,13 +46,30 @@ useful when passing quiet=False on solver instantiation::
 
 See the SCIP documentation for available branching rules, heuristics, 
 any other settings, and what they do.
+
+Whole profiles of SCIP parameters, like an emphasis or a tuned .set
+file, are better compiled once as a preset and applied in one call::
+
+    fast = scip.preset(emphasis='feasibility', heuristics='fast')
+    solver.set_params(fast)
+
+These dictionaries are read-only mappings.  The object for a plugin is
+only created the first time its name is looked up, so solvers that never
+touch their settings don't pay for them.
 '''
 
 from zibopt import (
     _branch, _conflict, _disp, _heur, _nodesel, _presol, _prop, _sepa
 )
+import weakref
+
+try:
+    from collections.abc import Mapping
+except ImportError:
+    from collections import Mapping
 
 __all__ = (
+    'settings',
     'BranchingError', 
     'ConflictError', 
     'DisplayError',
@@ -73,3 +90,48 @@ PropagatorError = _prop.error
 SelectorError   = _nodesel.error
 SeparatorError  = _sepa.error
 
+class settings(Mapping):
+    '''
+    Maps plugin names to settings objects for a solver.  Names are read
+    from SCIP on each iteration and nothing is built until it's needed.
+    Parameters:
+
+        - solver:  solver the plugins belong to
+        - factory: settings type, called as factory(solver, name)
+        - names:   unbound solver method returning plugin names
+        - error:   exception factory raises for unknown names
+    '''
+    def __init__(self, solver, factory, names, error):
+        # A weak reference keeps solvers out of reference cycles, so they
+        # are still freed as soon as they go out of scope.
+        self._solver = weakref.ref(solver)
+        self._factory = factory
+        self._names = names
+        self._error = error
+        self._cache = {}
+
+    def _names_list(self):
+        return self._names(self._solver())
+
+    def __getitem__(self, name):
+        try:
+            return self._cache[name]
+        except KeyError:
+            pass
+
+        try:
+            obj = self._factory(self._solver(), name)
+        except (self._error, TypeError):
+            raise KeyError(name)
+
+        self._cache[name] = obj
+        return obj
+
+    def __contains__(self, name):
+        return name in self._cache or name in self._names_list()
+
+    def __iter__(self):
+        return iter(self._names_list())
+
+    def __len__(self):
+        return len(self._names_list())
@@ -1,4 +1,5 @@
-from zibopt import _soln
+from zibopt import _cons, _soln
+from zibopt._array import new_array
 
 __all__ = 'solution', 'SolutionError'
 
@@ -10,6 +11,11 @@ class solution(_soln.solution):
     be obtained using variable references from the solver::
     
         x1_value = solution[x1]
+
+    Values for many variables at once are best read as arrays, which
+    avoids building a Python float per variable::
+
+        values = solution.to_array(block)
     
     If a solution is infeasible or unbounded, it will be false when evaluated
     in boolean context::
@@ -24,6 +30,8 @@ class solution(_soln.solution):
         - solution.infeasible:  no feasible solution could be found
         - solution.unbounded:   solution is unbounded
         - solution.inforunbd:   solution is either infeasible or unbounded
+        - solution.interrupted: solver.interrupt() stopped the solve early
+        - solution.memlimit:    the solve stopped at its memory limit
     '''
     def __init__(self, solver):
         super(solution, self).__init__(solver)
@@ -48,3 +56,53 @@ class solution(_soln.solution):
             vals[v] = self.value(v)
         return vals
 
+    def to_array(self, variables=None, out=None):
+        '''
+        Returns solution values for a variable block, or for every variable
+        in the model in the order they were added, as an array of doubles.
+        Values are written directly into out if it is given, which can be
+        any writable buffer of doubles, like a NumPy float64 array::
+
+            x = solver.variables_array(1000, scip.BINARY)
+            ...
+            values = solution.to_array(x)
+        '''
+        if out is None:
+            out = new_array(self._size(variables))
+        self.values_into(variables, out)
+        return out
+
+    def reduced_costs(self, variables=None, out=None):
+        '''
+        Returns LP reduced costs for a variable block, or for every variable
+        in the model, as an array of doubles.  See to_array for out.  They
+        come from the last LP solved at the root node, which for a model
+        without integer variables is the final LP.  Raises SolutionError if
+        the solve never finished the root node with an optimal LP, like
+        when presolving solved it or a limit stopped it at the root.
+        '''
+        if out is None:
+            out = new_array(self._size(variables))
+        self.reduced_costs_into(variables, out)
+        return out
+
+    def duals(self, constraints, out=None):
+        '''
+        Returns LP dual values for a constraint block or a list of linear
+        constraints as an array of doubles.  See to_array for out.  They
+        come from the last LP solved, wherever the solve ended up in the
+        tree, so for a model with integer variables they need not match
+        reduced_costs, which come from the root.  Constraints that are not
+        in the problem, or that presolving deleted or upgraded to another
+        constraint type, get NaN.
+        '''
+        if not isinstance(constraints, _cons.constraint_block):
+            constraints = list(constraints)
+        if out is None:
+            out = new_array(len(constraints))
+        self.duals_into(constraints, out)
+        return out
+
+    def _size(self, variables):
+        return self.solver.nvars if variables is None else len(variables)
+
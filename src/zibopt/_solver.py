@@ -3,12 +3,21 @@ from zibopt import _scip
 from zibopt import (
     _branch, _conflict, _disp, _heur, _nodesel, _presol, _prop, _sepa
 )
-from zibopt._constraint import constraint
+from zibopt._array import as_buffer, new_array
+from zibopt._constraint import constraint, constraint_block, ConstraintError
+from zibopt._expr import linear_expr
+from zibopt._settings import settings
 from zibopt._solution import solution
-from zibopt._variable import variable
+from zibopt._variable import variable, variable_block
+from array import array
+from collections import namedtuple
+import contextlib
+import functools
+import mmap
 import sys
+import time
 
-__all__ = 'solver', 'SolverError', 'BINARY', 'INTEGER', 'IMPLINT', 'CONTINUOUS'
+__all__ = 'solver', 'SolverPool', 'preset', 'SolverError', 'BINARY', 'INTEGER', 'IMPLINT', 'CONTINUOUS'
 
 BINARY     = _scip.BINARY
 INTEGER    = _scip.INTEGER
@@ -17,29 +26,68 @@ CONTINUOUS = _scip.CONTINUOUS
 
 SolverError = _scip.error
 
+# What progress callbacks receive.  kind is 'incumbent' or 'node'.  values
+# holds incumbent solution values by solver index, and is None for nodes.
+snapshot = namedtuple('snapshot', 'kind objective bound nodes time values')
+
+_clock = getattr(time, 'perf_counter', time.time)
+
+def _timed(phase):
+    '''
+    Adds the time spent in a model building method to solver.build_times.
+    Calls made from inside another timed method count toward the outer one.
+    '''
+    def decorate(method):
+        @functools.wraps(method)
+        def timed(self, *args, **kwds):
+            if self._timing:
+                return method(self, *args, **kwds)
+            self._timing = True
+            start = _clock()
+            try:
+                return method(self, *args, **kwds)
+            finally:
+                self._timing = False
+                self.build_times[phase] = self.build_times.get(phase, 0.0) + _clock() - start
+        return timed
+    return decorate
+
 class solver(_scip.solver):
     '''
     Instantiates a A SCIP mixed integer programming solver with default 
     settings.  Parameters:
     
         - quiet=True: turns the SCIP solver output off
+        - pool=None:  optional SolverPool to take a SCIP instance from
 
     Normal behavior is to instantiate a solver, define variables and 
     constraints for it, and then maximize or minimize an objective function.
+
+    solver.variables and solver.constraints are tuples of the variables and
+    active constraints, in the order they were created.  Members of
+    variable blocks, and variables read from files, are only included
+    while some Python object refers to them.
     '''
     def __init__(self, *args, **kwds):
         super(solver, self).__init__(*args, **kwds)
-        self.variables = set()
-        self.constraints = set()
-
-        self.branching   = {n:_branch.branching_rule(self, n) for n in self.branching_names()}
-        self.conflict    = {n:_conflict.conflict(self, n) for n in self.conflict_names()}
-        self.display     = {n:_disp.display_column(self, n) for n in self.display_names()}
-        self.heuristics  = {n:_heur.heuristic(self, n) for n in self.heuristic_names()}
-        self.presolvers  = {n:_presol.presolver(self, n) for n in self.presolver_names()}
-        self.propagators = {n:_prop.propagator(self, n) for n in self.propagator_names()}
-        self.selectors   = {n:_nodesel.selector(self, n) for n in self.selector_names()}
-        self.separators  = {n:_sepa.separator(self, n) for n in self.separator_names()}
+
+        # Seconds spent building the model, by phase
+        self.build_times = {}
+        self._timing = False
+
+        # Constraint changes queued by modify(), as constraint: add
+        self._pending = None
+
+        # Plugin settings objects are built on first access
+        cls = _scip.solver
+        self.branching   = settings(self, _branch.branching_rule, cls.branching_names, _branch.error)
+        self.conflict    = settings(self, _conflict.conflict, cls.conflict_names, _conflict.error)
+        self.display     = settings(self, _disp.display_column, cls.display_names, _disp.error)
+        self.heuristics  = settings(self, _heur.heuristic, cls.heuristic_names, _heur.error)
+        self.presolvers  = settings(self, _presol.presolver, cls.presolver_names, _presol.error)
+        self.propagators = settings(self, _prop.propagator, cls.propagator_names, _prop.error)
+        self.selectors   = settings(self, _nodesel.selector, cls.selector_names, _nodesel.error)
+        self.separators  = settings(self, _sepa.separator, cls.separator_names, _sepa.error)
 
     def __iadd__(self, expr):
         '''
@@ -76,12 +124,9 @@ class solver(_scip.solver):
         self.unconstrain(constraint)
         return self
 
+    @_timed('objective')
     def _update_coefficients(self, expr, opt_type):
         '''Allows use of algebraic format for objective functions'''
-        # Clear out old coefficients.  This may require freeing the transformed
-        # problem, thus the restart.
-        self.restart()
-
         # Make sure it's actually an expression.  It could be a constant.
         if isinstance(expr, int) or isinstance(expr, float):
             expr = expression({():expr})
@@ -91,6 +136,11 @@ class solver(_scip.solver):
         if expr.expr_upper is not None or expr.expr_lower is not None:
             raise SolverError('objective functions should not have bounds')
 
+        # Linear expressions go to SCIP as they are, without any term dicts
+        if isinstance(expr, linear_expr):
+            self.set_objective(expr)
+            return
+
         # It appears SCIP only allows linear expression for objective
         # functions, so if we get something with bilinear terms, set 
         # that equal to an unbounded variable, min/max that variable.
@@ -107,13 +157,13 @@ class solver(_scip.solver):
                 expr = expression({(z,):1.0})
                 break
 
-        # Now set linear coefficients on the objective function
-        for v in self.variables:
-            try:
-                v.set_coefficient(expr[(v,)])
-            except:
-                v.set_coefficient(0.0)
+        # Now set linear coefficients on the objective function.  Variables
+        # not in the expression get zero.  Changing any coefficient frees
+        # the transformed problem.  Only the same objective keeps it, so a
+        # stopped solve can go on from where it was.
+        self.set_objective(expr.terms)
 
+    @_timed('variables')
     def variable(self, vartype=CONTINUOUS, coefficient=0, lower=0, **kwds):
         '''
         Adds a variable to the SCIP solver and returns it.  Parameters:
@@ -124,10 +174,110 @@ class solver(_scip.solver):
             - upper=+inf:         upper bound on variable
             - priority=0:         branching priority for variable
         '''
-        v = variable(self, vartype, coefficient, lower, **kwds)
-        self.variables.add(v)
+        return variable(self, vartype, coefficient, lower, **kwds)
+
+    def _variable(self, index):
+        '''Returns the variable at a solver index, wrapping it if necessary'''
+        v = self.wrapper(index)
+        if v is None:
+            v = variable(self, index=index)
         return v
 
+    @_timed('variables')
+    def variables_array(self, n, vartype=CONTINUOUS, lower=0, upper=None, obj=0):
+        '''
+        Adds n variables to the SCIP solver in one call and returns them as
+        a variable block.  Bounds and objective coefficients may be arrays
+        of length n, single numbers, or None.  Parameters:
+
+            - n:                  number of variables
+            - vartype=CONTINUOUS: type of variables
+            - lower=0:            lower bounds on variables
+            - upper=None:         upper bounds on variables (+inf)
+            - obj=0:              objective function coefficients
+        '''
+        return variable_block(
+            self, n, vartype, as_buffer(lower), as_buffer(upper), as_buffer(obj)
+        )
+
+    @_timed('variables')
+    def add_columns(self, rows, indptr, indices, data, vartype=CONTINUOUS, lower=0, upper=None, obj=0):
+        '''
+        Adds variables as columns of existing linear constraints, like the
+        columns priced out in a column generation loop, and returns them as
+        a variable block.  Coefficients go straight into the constraints,
+        so the master problem is never rebuilt::
+
+            rows = solver.add_linear_constraints(...)
+            while True:
+                solution = solver.minimize()
+                duals = solution.duals(rows)
+                ...
+                if not columns:
+                    break
+                solver.add_columns(rows, indptr, indices, data, obj=costs)
+
+        The next solve restarts once for the whole batch and is warm
+        started from the last incumbent, with new columns filled in by a
+        small sub-solve (see solver.warm_start).  Parameters:
+
+            - rows:               constraint block, or list of constraints,
+              that indices refer to.  Only linear constraints have columns.
+            - indptr:             column j has its entries in
+              indptr[j]:indptr[j+1]
+            - indices:            position in rows of each entry
+            - data:               coefficient of each entry
+            - vartype=CONTINUOUS: type of variables
+            - lower=0:            lower bounds on variables
+            - upper=None:         upper bounds on variables (+inf)
+            - obj=0:              objective function coefficients
+        '''
+        if not isinstance(rows, constraint_block):
+            rows = list(rows)
+
+        indptr = as_buffer(indptr, 'l')
+        return variable_block(
+            self, len(indptr) - 1, vartype, as_buffer(lower), as_buffer(upper), as_buffer(obj),
+            rows, indptr, as_buffer(indices, 'l'), as_buffer(data)
+        )
+
+    @_timed('bounds')
+    def set_bounds(self, variables, lower=None, upper=None, mask=None):
+        '''
+        Sets bounds on every variable in a block in one call, and returns
+        the number of variables whose bounds changed.  Bounds that are
+        already at the given values cost nothing, so it's cheap to pass in
+        full arrays when only a few entries differ.  Parameters:
+
+            - variables:  variable block from solver.variables_array
+            - lower=None: lower bounds, a single number, or None to keep
+            - upper=None: upper bounds, a single number, or None to keep
+            - mask=None:  optional array of flags; only members with a
+              nonzero flag are touched
+        '''
+        self._check_block(variables)
+        return variables.set_bounds(as_buffer(lower), as_buffer(upper), as_buffer(mask, 'b'))
+
+    @_timed('bounds')
+    def fix(self, variables, values, mask=None):
+        '''
+        Fixes every variable in a block to a value, like set_bounds with the
+        same lower and upper bounds.  Returns the number of variables whose
+        bounds changed.  Parameters:
+
+            - variables: variable block from solver.variables_array
+            - values:    values to fix to, or a single number
+            - mask=None: optional array of flags; only members with a
+              nonzero flag are touched
+        '''
+        self._check_block(variables)
+        return variables.fix(as_buffer(values), as_buffer(mask, 'b'))
+
+    def _check_block(self, variables):
+        if not isinstance(variables, variable_block) or variables.solver is not self:
+            raise SolverError('variable block not associated with solver')
+
+    @_timed('constraints')
     def constraint(self, expression):
         '''
         Adds a constraint to the solver.  Returns the constraint. The user 
@@ -148,21 +298,239 @@ class solver(_scip.solver):
 
         Parameters:
         
-            - expression: python-algebraic expression instance
+            - expression: python-algebraic expression or linear_expr
         '''
         cons = constraint(self, expression)
         self.constrain(cons)
         return cons
 
+    def linear_expr(self):
+        '''
+        Returns an empty linear_expr for this solver's variables.  Large
+        linear sums accumulate in it without creating an expression per
+        term, and go straight to constraints and objectives::
+
+            e = solver.linear_expr()
+            for c, v in zip(costs, x):
+                e.add(v, c)
+            solution = solver.minimize(objective=e)
+        '''
+        return linear_expr(self)
+
+    def quicksum(self, items):
+        '''
+        Sums items into a linear_expr in one pass, instead of building a
+        new expression at every + the way sum() does.  Items may be
+        variables, numbers, (coefficient, variable) pairs, linear_exprs
+        and linear python-algebraic expressions::
+
+            solver += solver.quicksum((w, v) for w, v in zip(weights, x)) <= 10
+        '''
+        e = linear_expr(self)
+        add = e.add
+        for item in items:
+            if isinstance(item, tuple):
+                add(item[1], item[0])
+            else:
+                e += item
+        return e
+
+    @_timed('constraints')
+    def add_linear_constraints(self, indptr, indices, data, lower=None, upper=None):
+        '''
+        Adds a block of linear constraints lower <= A*x <= upper, where A is
+        given in compressed sparse row format, and returns the constraint
+        block.  This reads NumPy arrays, array.array instances and other
+        buffers in place.  Parameters:
+
+            - indptr:     row i has its entries in indptr[i]:indptr[i+1]
+            - indices:    variable indices, in the order variables were added
+            - data:       coefficients for each entry
+            - lower=None: lower bound per row, a single number, or None
+            - upper=None: upper bound per row, a single number, or None
+        '''
+        if lower is None and upper is None:
+            raise ConstraintError('at least one bound is required')
+
+        return constraint_block(
+            self,
+            as_buffer(indptr, 'l'),
+            as_buffer(indices, 'l'),
+            as_buffer(data),
+            as_buffer(lower),
+            as_buffer(upper)
+        )
+
+    def solutions(self, k=None, out=None, objectives=None):
+        '''
+        Returns the best k solutions SCIP found during the last solve, as
+        a pair of arrays: values for every variable, one solution per row
+        in row-major order, and an objective value for each solution.  The
+        best solution comes first.  Fewer than k come back if SCIP stored
+        fewer; it keeps at most limits/maxsol of them::
+
+            values, objectives = solver.solutions(5)
+            n = solver.nvars
+            second_best = values[n:2*n]
+
+        Parameters:
+
+            - k=None:          number of solutions, or all that are stored
+            - out=None:        optional writable buffer of k*nvars doubles
+            - objectives=None: optional writable buffer of k doubles.  Rows
+              past solver.nsols are left alone in buffers passed in.
+        '''
+        k = self.nsols if k is None else min(k, self.nsols)
+        if objectives is None:
+            objectives = new_array(k)
+        if out is None:
+            out = new_array(len(objectives) * self.nvars)
+
+        self.solutions_into(out, objectives)
+        return out, objectives
+
+    def statistics(self):
+        '''
+        Returns a dict of counters and clocks from SCIP, gathered in one
+        call: times per solving phase, node and LP iteration counts, the
+        final bounds and gap (None until a solve transforms the problem),
+        and (calls, time, found) for each branching
+        rule, heuristic, presolver, propagator and separator.  Found means
+        children created, solutions found, variables fixed, domain
+        reductions and cuts, respectively::
+
+            stats = solver.statistics()
+            stats['lp_time'], stats['heuristics']['rounding']
+
+        stats['history'] lists (time, node, primal, dual) each time the
+        primal or dual bound improved during the solve, in that order.  A
+        solve that goes on from where the last one stopped adds to it.
+        stats['build'] holds seconds spent in Python building the model,
+        keyed by 'variables', 'constraints', 'bounds', 'objective' and
+        'load'.
+        '''
+        stats = super(solver, self).statistics()
+        stats['build'] = dict(self.build_times)
+        return stats
+
+    def warm_start(self, values, nodes=500):
+        '''
+        Gives the next solve a starting solution.  Values can be a dict of
+        variables to numbers, or an array with one number per variable by
+        solver index.  Variables missing from the dict, NaN entries, and
+        variables past the end of the array are unknown; SCIP fills them
+        in by solving the problem with the known values fixed, searching
+        at most nodes nodes.  A start that turns out infeasible is dropped
+        without complaint::
+
+            solver.warm_start({x: 1, y: 0})
+            solver.warm_start([1, float('nan'), 0])
+
+        By default each solve's best solution becomes the start for the
+        next one, so re-solving after small edits begins from the old
+        optimum.  Set solver.reuse_incumbent to False to keep the start
+        given here instead.  Only primal values are carried over; SCIP
+        rebuilds the LP from scratch.  Parameters:
+
+            - values: dict, array of doubles, or None to drop the start
+            - nodes=500: node limit for filling in unknown values, or 0
+              to skip partial starts
+        '''
+        if isinstance(values, dict):
+            start = array('d', [float('nan')]) * self.nvars
+            for v, x in values.items():
+                if not isinstance(v, variable) or self.wrapper(v.index) is not v:
+                    raise SolverError('variable not associated with solver')
+                start[v.index] = x
+            values = start
+
+        self.set_start(as_buffer(values), nodes)
+
+    @_timed('load')
+    def read(self, path, format=None):
+        '''
+        Loads a problem file with SCIP's own readers, and returns a variable
+        block and a constraint block for everything in it.  Neither one
+        builds a Python object per variable or row until it is indexed, so
+        big models load about as fast as SCIP can read them::
+
+            solver = scip.solver()
+            x, rows = solver.read('model.mps')
+            solution = solver.minimize()
+            values = solution.to_array(x)
+
+        The solver must be empty.  The objective comes from the file, but
+        call maximize or minimize to match its sense.  Parameters:
+
+            - path:        file to read
+            - format=None: reader extension, like 'mps', 'lp' or 'cip'.
+              Defaults to the file name's extension.
+        '''
+        nvars, nconss = super(solver, self).read(path, format)
+        return (
+            variable_block(self, nvars, start=0),
+            constraint_block(self, nconss, start=0)
+        )
+
+    def write(self, path, format=None, generic=False):
+        '''
+        Writes the problem as it was given, not as presolved.  Parameters:
+
+            - path:          file to write
+            - format=None:   writer extension, like 'mps', 'lp' or 'cip'.
+              Defaults to the file name's extension.
+            - generic=False: replace variable and constraint names with
+              generic ones
+        '''
+        super(solver, self).write(path, format, generic)
+
+    def save_snapshot(self, path):
+        '''
+        Writes the model to a compact binary snapshot: variable bounds,
+        types and objective coefficients, and the linear constraints in CSR
+        format.  load_snapshot restores it far faster than rebuilding the
+        model or reading a text file.  Snapshots use this machine's byte
+        order and only support linear constraints.
+        '''
+        super(solver, self).save_snapshot(path)
+
+    @_timed('load')
+    def load_snapshot(self, snapshot):
+        '''
+        Adds the model from a snapshot file to this solver in one pass, and
+        returns a variable block and a constraint block for it.  Files are
+        memory mapped, not read into Python.  Any buffer holding a snapshot
+        works too::
+
+            base = scip.solver()
+            x, rows = base.load_snapshot('base.snap')
+        '''
+        if isinstance(snapshot, str):
+            with open(snapshot, 'rb') as f:
+                m = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+                try:
+                    counts = super(solver, self).load_snapshot(m)
+                finally:
+                    m.close()
+        else:
+            counts = super(solver, self).load_snapshot(snapshot)
+
+        vstart, nvars, cstart, nconss = counts
+        return (
+            variable_block(self, nvars, start=vstart),
+            constraint_block(self, nconss, start=cstart)
+        )
+
     def constrain(self, constraint):
         '''
         Adds a constraint back into the solver.  Returns None.  Parameters:
 
             - constraint: constraint instance to reinstall
         '''
-        if constraint not in self.constraints:
+        if self._pending is not None:
+            self._pending[constraint] = True
+        else:
             constraint.register()
-            self.constraints.add(constraint)
 
     def unconstrain(self, constraint):
         '''
@@ -170,28 +538,277 @@ class solver(_scip.solver):
             
             - constraint: constraint instance to remove
         '''
-        if constraint in self.constraints:
-            self.constraints.remove(constraint)
+        if self._pending is not None:
+            self._pending[constraint] = False
+        else:
             super(solver, self).unconstrain(constraint)
 
+    def add_many(self, constraints):
+        '''
+        Adds constraints back into the solver all at once, resetting the
+        transformed problem at most once.  Returns the number that weren't
+        already part of the problem.
+        '''
+        return self.change_constraints(list(constraints), ())
+
+    def remove_many(self, constraints):
+        '''
+        Removes constraints from the solver all at once, resetting the
+        transformed problem at most once.  Returns the number that were
+        part of the problem.
+        '''
+        return self.change_constraints((), list(constraints))
+
+    @contextlib.contextmanager
+    def modify(self):
+        '''
+        Queues every constraint added or removed inside the block and
+        applies them together when it ends, like add_many and remove_many.
+        Only the last change to each constraint counts, so toggling a
+        scenario off and back on leaves the presolved problem in place::
+
+            with solver.modify():
+                for c in scenario:
+                    solver -= c
+                solver += x + y <= 3
+
+        If the block raises, the queued changes are dropped.  Constraints
+        created inside it exist, but aren't part of the problem.  Blocks
+        can be nested, and only the outermost one applies changes.
+        '''
+        if self._pending is not None:
+            yield self
+            return
+
+        self._pending = {}
+        try:
+            yield self
+            pending = self._pending
+        finally:
+            self._pending = None
+
+        add = [c for c, added in pending.items() if added]
+        remove = [c for c, added in pending.items() if not added]
+        self.change_constraints(add, remove)
+
+    def set_callback(self, callback, batch=1, nodes=0):
+        '''
+        Streams solver progress to callback(snapshots) while maximize and
+        minimize run.  Each snapshot has kind, objective, bound, nodes,
+        time and values fields.  SCIP only queues them as it goes.  Another
+        thread hands them over, so callbacks never hold up the search.
+        If a callback raises an exception, solving stops and the exception
+        propagates.  Portfolio copies don't report progress.  Parameters:
+
+            - callback: function taking a list of snapshots, or None to
+              stop reporting
+            - batch=1:  number of snapshots to queue before a call.  Left
+              over snapshots are delivered when solving stops.
+            - nodes=0:  also report every nth solved node, or 0 for none
+        '''
+        if callback is None:
+            return super(solver, self).set_callback(None)
+
+        def deliver(records):
+            snapshots = []
+            for kind, obj, bound, nnodes, time, values in records:
+                if values is not None:
+                    a = array('d')
+                    if sys.version_info[0] >= 3:
+                        a.frombytes(values)
+                    else:
+                        a.fromstring(values)
+                    values = a
+                snapshots.append(snapshot(kind, obj, bound, int(nnodes), time, values))
+            callback(snapshots)
+
+        super(solver, self).set_callback(deliver, batch, nodes)
+
+    def set_lazy(self, callback, fractional=False):
+        '''
+        Generates rows inside the search instead of solving over and over.
+        callback(values, integral) is called with an array of solution
+        values by solver index (see variable.index).  It returns violated
+        rows as a tuple of (indptr, indices, data, lower, upper), in the
+        format add_linear_constraints takes, or None if there are none::
+
+            def subtours(values, integral):
+                ...
+                return indptr, indices, data, None, upper
+
+            solver.set_lazy(subtours)
+
+        Rows must be valid for the whole problem.  Violated ones go into the
+        LP as cuts and into SCIP's global cut pool, and solving goes on from
+        there.  The callback runs on the solving thread while it holds the
+        GIL, and must not modify the solver.  If it raises an exception,
+        solving stops and the exception propagates.  Portfolio solving
+        can't copy problems that use it.  Parameters:
+
+            - callback:         function as above, or None to turn it off
+            - fractional=False: also call it for fractional LP solutions,
+              with integral=False.  Otherwise it only sees solutions that
+              are integral, whether from the LP or from heuristics.
+        '''
+        if callback is None:
+            return super(solver, self).set_lazy(None)
+
+        def separate(values, integral):
+            a = array('d')
+            if sys.version_info[0] >= 3:
+                a.frombytes(values)
+            else:
+                a.fromstring(values)
+
+            rows = callback(a, integral)
+            if rows is None:
+                return None
+
+            indptr, indices, data, lower, upper = rows
+            return (
+                as_buffer(indptr, 'l'),
+                as_buffer(indices, 'l'),
+                as_buffer(data),
+                as_buffer(lower),
+                as_buffer(upper)
+            )
+
+        super(solver, self).set_lazy(separate, fractional)
+
+    def set_params(self, params, reset=False):
+        '''
+        Sets SCIP parameters from a preset, or from a dict of parameter
+        names to values like {'limits/nodes': 1000}.  With reset=True all
+        parameters go back to defaults first, so the solver ends up with
+        exactly the preset's settings.
+        '''
+        super(solver, self).set_params(params, reset)
+
+    def portfolio_solve(self, profiles, threads=None, sense='max', **kwds):
+        '''
+        Races copies of the problem against each other on native threads,
+        each with its own settings, and returns a solution instance.  The
+        copies share incumbents as they go, and the first one to settle
+        the problem, or to reach one of the limits below, stops the rest,
+        so the answer comes from whichever profile suits this problem
+        best.  Copies that fail or stop on a limit from their own profile
+        drop out.  If they all do, the one with the best bounds wins.
+        solution.profile is the index of the winning profile.  Parameters:
+
+            - profiles:     list of presets, or dicts of SCIP parameter names
+              to values like {'limits/nodes': 1000}.  An empty dict means
+              defaults.  Presets are compiled already, so they are cheaper
+              to apply to each copy.
+            - threads=None: number of copies to run, which race the first
+              threads profiles.  Defaults to one per profile.  SCIP has
+              no random seed to tell copies with the same settings apart,
+              so more threads than profiles raise a SolverError.
+            - sense='max':  'max' or 'min'
+            - objective:    optional algebraic representation of objective
+              function.  Can also use variable coefficients.
+            - time=inf:     optional time limit for solving
+            - gap=0.0:      optional gap percentage to stop solving
+            - absgap=0.0:   optional primal/dual gap to stop solving
+            - nsol=-1:      number of solutions to find before stopping
+            - memory=inf:   memory limit in MB for each copy
+        '''
+        if sense not in ('max', 'min'):
+            raise SolverError("sense must be 'max' or 'min'")
+
+        if 'objective' in kwds:
+            try:
+                if isinstance(kwds['objective'], expression):
+                    kwds['offset'] = kwds['objective'].terms[()]
+                elif isinstance(kwds['objective'], linear_expr):
+                    kwds['offset'] = kwds['objective'].constant
+            except KeyError:
+                pass
+            self._update_coefficients(kwds.pop('objective'), sense)
+
+        profiles = list(profiles)
+        winner = super(solver, self).portfolio_solve(
+            profiles, threads or 0, sense == 'max', **kwds
+        )
+
+        sol = solution(self)
+        sol.profile = winner
+        return sol
+
+    def interrupt(self):
+        '''
+        Stops a running maximize, minimize or portfolio_solve as soon as
+        SCIP notices, and returns True if one was running.  It's meant to
+        be called from another thread, like a deadline timer::
+
+            timer = threading.Timer(30, solver.interrupt)
+            timer.start()
+            solution = solver.maximize()
+            timer.cancel()
+
+        The interrupted solve returns normally with the best solution so
+        far, and solution.interrupted set.  Calls made while the solver is
+        idle do nothing, so they can't stop the next solve by accident.
+        '''
+        return super(solver, self).interrupt()
+
+    def memory_usage(self):
+        '''
+        Returns the bytes of block memory SCIP is using.  Like interrupt,
+        it can be called from another thread during a solve, and then
+        reports memory as of SCIP's last LP or node.  While a problem is
+        being read, written or loaded from a snapshot, it reports memory
+        as of the start::
+
+            timer = threading.Timer(10, lambda: print(solver.memory_usage()))
+        '''
+        return super(solver, self).memory_usage()
+
+    def set_limits(self, time=None, gap=None, absgap=None, nsol=None, memory=None):
+        '''
+        Changes limits of a running maximize, minimize or portfolio_solve
+        from another thread, and returns True if one was running.  They
+        take effect after SCIP's next LP or node, and only for that solve.
+        Portfolio workers get all of the solver's limits, in place of any
+        their profiles set.  Time counts from the start of the solve, so
+        time=0 stops it at the next check.  Limits left as None stay as
+        they are::
+
+            # Accept anything within 5% from now on
+            solver.set_limits(gap=0.05)
+
+        memory is in MB, and a lower one than what is in use stops the
+        solve with solution.memlimit set.
+        '''
+        return super(solver, self).set_limits(time, gap, absgap, nsol, memory)
+
     def maximize(self, *args, **kwds):
         '''
         Maximizes the objective function and returns a solution instance.
         Parameters:
 
             - objective:   optional algebraic representation of objective
-              function.  Can also use variable coefficients.
+              function.  Can also use variable coefficients.  Changing
+              any coefficient, the constant or the sense restarts the
+              solve from scratch.  With the same objective, a solve that
+              a limit or interrupt stopped goes on from where it was, and
+              a finished one starts over.
             - solution={}: optional primal solution dictionary.  Raises a
               SolverError if the solution is infeasible.
             - time=inf:    optional time limit for solving
             - gap=0.0:     optional gap percentage to stop solving (ex: 0.05)
             - absgap=0.0:  optional primal/dual gap to stop solving
             - nsol=-1:     number of solutions to find before stopping
+            - memory=inf:  memory limit in MB.  Past the fraction of it in
+              the 'memory/savefac' parameter, SCIP switches node selection
+              to memory saving mode.  At the limit it stops, and sets
+              solution.memlimit.
         '''
         if 'objective' in kwds:
             try:
                 if isinstance(kwds['objective'], expression):
                     kwds['offset'] = kwds['objective'].terms[()]
+                elif isinstance(kwds['objective'], linear_expr):
+                    kwds['offset'] = kwds['objective'].constant
             except KeyError:
                 pass
             self._update_coefficients(kwds.pop('objective'), 'max')
@@ -204,21 +821,124 @@ class solver(_scip.solver):
         Parameters:
 
             - objective:   optional algebraic representation of objective
-              function.  Can also use variable coefficients.
+              function.  Can also use variable coefficients.  Changing
+              any coefficient, the constant or the sense restarts the
+              solve from scratch.  With the same objective, a solve that
+              a limit or interrupt stopped goes on from where it was, and
+              a finished one starts over.
             - solution={}: optional primal solution dictionary.  Raises a
               SolverError if the solution is infeasible.
             - time=inf:    optional time limit for solving
             - gap=0.0:     optional gap percentage to stop solving (ex: 0.05)
             - absgap=0.0:  optional primal/dual gap to stop solving
             - nsol=-1:     number of solutions to find before stopping
+            - memory=inf:  memory limit in MB.  Past the fraction of it in
+              the 'memory/savefac' parameter, SCIP switches node selection
+              to memory saving mode.  At the limit it stops, and sets
+              solution.memlimit.
         '''
         if 'objective' in kwds:
             try:
                 if isinstance(kwds['objective'], expression):
                     kwds['offset'] = kwds['objective'].terms[()]
+                elif isinstance(kwds['objective'], linear_expr):
+                    kwds['offset'] = kwds['objective'].constant
             except KeyError:
                 pass
             self._update_coefficients(kwds.pop('objective'), 'min')
         super(solver, self).minimize(*args, **kwds)
         return solution(self)
         
+
+class SolverPool(_scip.pool):
+    '''
+    Keeps initialized SCIP instances around for reuse.  Setting up SCIP
+    and its plugins can take longer than solving a small model, so when
+    many models are built one after another it pays to do that only once::
+
+        pool = scip.SolverPool(4)
+        for data in requests:
+            solver = pool.solver()
+            ...
+
+    A solver's SCIP instance goes back to the pool when the solver is
+    garbage collected.  Its problem is emptied and its parameters are reset
+    to defaults.  The pool's parameters are then applied again each time an
+    instance is handed out.  Parameters:
+
+        - size=0:      number of instances to set up right away
+        - params=None: preset, or dict of SCIP parameter names to values,
+          for every solver, like {'limits/nodes': 1000}.  Change with
+          pool.preset.
+
+    pool.idle is the number of instances waiting to be used.
+    '''
+    def solver(self, *args, **kwds):
+        '''Returns a solver using an instance from the pool'''
+        kwds['pool'] = self
+        return solver(*args, **kwds)
+
+class preset(_scip.preset):
+    '''
+    A named set of SCIP parameters, compiled once into a native table of
+    values.  Applying one to a solver, pool or portfolio profile doesn't
+    look anything up or convert any Python values, so the same profile can
+    be re-applied for every solve at next to no cost::
+
+        fast = scip.preset(emphasis='feasibility', heuristics='aggressive')
+        tuned = scip.preset({'limits/nodes': 1000}, file='tuned.set')
+        solver.set_params(fast)
+        pool = scip.SolverPool(params=tuned)
+
+    The file is read first, then emphasis, heuristics, presolving and
+    separating are applied in that order, and params go on top:
+
+        - params=None:     dict of SCIP parameter names to values
+        - file=None:       path of a SCIP .set file to read
+        - emphasis=None:   one of 'default', 'cpsolver', 'easycip',
+          'feasibility', 'hardlp', 'optimality' or 'counter'
+        - heuristics=None: one of 'default', 'aggressive', 'fast' or 'off'
+        - presolving=None: as for heuristics
+        - separating=None: as for heuristics
+
+    The preset keeps every parameter those leave different from SCIP's
+    defaults, plus any named in params.  preset.params returns them as a
+    dict, len(preset) counts them, and preset.write(path) saves the ones
+    that differ from defaults as a .set file.
+    '''
+    EMPHASES = {
+        'default':     _scip.EMPHASIS_DEFAULT,
+        'cpsolver':    _scip.EMPHASIS_CPSOLVER,
+        'easycip':     _scip.EMPHASIS_EASYCIP,
+        'feasibility': _scip.EMPHASIS_FEASIBILITY,
+        'hardlp':      _scip.EMPHASIS_HARDLP,
+        'optimality':  _scip.EMPHASIS_OPTIMALITY,
+        'counter':     _scip.EMPHASIS_COUNTER,
+    }
+
+    SETTINGS = {
+        'default':    _scip.SETTING_DEFAULT,
+        'aggressive': _scip.SETTING_AGGRESSIVE,
+        'fast':       _scip.SETTING_FAST,
+        'off':        _scip.SETTING_OFF,
+    }
+
+    def __init__(self, params=None, file=None, emphasis=None, heuristics=None, presolving=None, separating=None):
+        def lookup(names, name, kind):
+            if name is None:
+                return -1
+            try:
+                return names[name]
+            except KeyError:
+                raise SolverError('unknown %s: %s' % (kind, name))
+
+        super(preset, self).__init__(
+            params, file,
+            lookup(self.EMPHASES, emphasis, 'emphasis'),
+            lookup(self.SETTINGS, heuristics, 'heuristics setting'),
+            lookup(self.SETTINGS, presolving, 'presolving setting'),
+            lookup(self.SETTINGS, separating, 'separating setting')
+        )
+
+    def __repr__(self):
+        return 'preset(%r)' % self.params
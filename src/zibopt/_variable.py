@@ -1,7 +1,7 @@
 from algebraic import variable as algvar
 from zibopt import _vars
 
-__all__ = 'variable', 'VariableError'
+__all__ = 'variable', 'variable_block', 'VariableError'
 
 VariableError = _vars.error
 
@@ -11,3 +11,32 @@ class variable(_vars.variable, algvar):
         _vars.variable.__init__(self, *args, **kwds)
         algvar.__init__(self, *args, **kwds)
 
+
+class variable_block(_vars.variable_block):
+    '''
+    A block of variables created in a single call by solver.variables_array.
+    Python wrappers for members are only built when they are indexed, and
+    can then be used in expressions like any other variable.  The block
+    doesn't keep them alive, so once nothing refers to a member's wrapper
+    it's freed, and indexing the member again builds a new one::
+
+        x = solver.variables_array(1000, scip.BINARY, obj=weights)
+        solver += x[0] + x[1] <= 1
+
+    Members have consecutive solver indices starting at block.start, which
+    is what solver.add_linear_constraints expects in its indices.
+    '''
+    def __init__(self, solver, *args, **kwds):
+        super(variable_block, self).__init__(solver, *args, **kwds)
+        self.solver = solver
+
+    def __getitem__(self, i):
+        if isinstance(i, slice):
+            return [self[j] for j in range(*i.indices(len(self)))]
+        if i < 0:
+            i += len(self)
+
+        v = self.wrapper(i)
+        if v is None:
+            v = variable(self, index=i)
+        return v
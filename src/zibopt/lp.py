@@ -0,0 +1,131 @@
+'''
+zibopt.lp
+=========
+This module solves pure linear programs directly with SCIP's LP solver,
+skipping presolving, branching and everything else scip.solver does.
+Models are built and read in bulk, from anything that supports the
+buffer protocol, like NumPy arrays or array.array instances::
+
+    from zibopt import lp
+
+    # maximize x0 + x1 subject to x0 + 2*x1 <= 4, 3*x0 + x1 <= 6
+    model = lp.lp(lp.MAXIMIZE)
+    model.add_cols(2, obj=[1, 1])
+    model.add_rows([0, 2, 4], [0, 1, 0, 1], [1, 2, 3, 1], upper=[4, 6])
+
+    if model.solve_primal():
+        print(model.objective, list(model.primal()))
+
+The LP keeps its basis between solves.  After changing bounds or sides,
+solve_dual usually needs only a few pivots to get back to optimal, and
+basis()/set_basis() carry a basis over to another LP of the same shape.
+'''
+
+from zibopt import _lp
+from zibopt._array import as_buffer, new_array
+
+__all__ = 'lp', 'LPError', 'MAXIMIZE', 'MINIMIZE', 'LOWER', 'BASIC', 'UPPER', 'ZERO'
+
+LPError = _lp.error
+
+MAXIMIZE = _lp.MAXIMIZE
+MINIMIZE = _lp.MINIMIZE
+
+# Basis statuses, as basis() returns them
+LOWER = _lp.LOWER
+BASIC = _lp.BASIC
+UPPER = _lp.UPPER
+ZERO  = _lp.ZERO
+
+class lp(_lp.lp):
+    '''
+    A linear program held by SCIP's LP interface.  Columns and rows are
+    numbered in the order they are added.  Attributes:
+
+        - nrows, ncols: problem size
+        - objective:    objective value of the last solve
+        - optimal, infeasible, unbounded: status of the last solve
+        - iterations:   simplex iterations of the last solve
+
+    Columns can be added with entries in rows that already exist, or
+    empty, to be filled in by rows added after them.
+    '''
+    def add_cols(self, n, obj=None, lower=None, upper=None, indptr=None, indices=None, data=None):
+        '''
+        Adds n columns and returns the index of the first.  Parameters:
+
+            - obj=0:        objective coefficient per column, or one number
+            - lower=0:      lower bound per column, or one number
+            - upper=inf:    upper bound per column, or one number
+            - indptr=None:  column i has its entries in indptr[i]:indptr[i+1]
+            - indices=None: row index of each entry
+            - data=None:    coefficient of each entry
+        '''
+        if indptr is not None:
+            indptr, indices, data = as_buffer(indptr, 'l'), as_buffer(indices, 'l'), as_buffer(data)
+        return super(lp, self).add_cols(
+            n, as_buffer(obj), as_buffer(lower), as_buffer(upper), indptr, indices, data
+        )
+
+    def add_rows(self, indptr, indices, data, lower=None, upper=None):
+        '''
+        Adds rows lower <= A*x <= upper, with A in compressed sparse row
+        format, and returns the index of the first.  At least one of lower
+        and upper is required.  Parameters:
+
+            - indptr:     row i has its entries in indptr[i]:indptr[i+1]
+            - indices:    column index of each entry
+            - data:       coefficient of each entry
+            - lower=None: lower bound per row, a single number, or None
+            - upper=None: upper bound per row, a single number, or None
+        '''
+        return super(lp, self).add_rows(
+            as_buffer(indptr, 'l'), as_buffer(indices, 'l'), as_buffer(data),
+            as_buffer(lower), as_buffer(upper)
+        )
+
+    def set_objective(self, indices, values):
+        '''Changes objective coefficients of the columns at indices'''
+        super(lp, self).set_objective(as_buffer(indices, 'l'), as_buffer(values))
+
+    def set_bounds(self, indices, lower, upper):
+        '''Changes bounds of the columns at indices'''
+        super(lp, self).set_bounds(as_buffer(indices, 'l'), as_buffer(lower), as_buffer(upper))
+
+    def set_sides(self, indices, lower, upper):
+        '''Changes left and right hand sides of the rows at indices'''
+        super(lp, self).set_sides(as_buffer(indices, 'l'), as_buffer(lower), as_buffer(upper))
+
+    def primal(self, out=None):
+        '''Returns primal values by column as an array of doubles'''
+        out = new_array(self.ncols) if out is None else out
+        self.solution_into(primal=out)
+        return out
+
+    def duals(self, out=None):
+        '''Returns dual values by row as an array of doubles'''
+        out = new_array(self.nrows) if out is None else out
+        self.solution_into(dual=out)
+        return out
+
+    def activities(self, out=None):
+        '''Returns row activities A*x as an array of doubles'''
+        out = new_array(self.nrows) if out is None else out
+        self.solution_into(activity=out)
+        return out
+
+    def reduced_costs(self, out=None):
+        '''Returns reduced costs by column as an array of doubles'''
+        out = new_array(self.ncols) if out is None else out
+        self.solution_into(redcost=out)
+        return out
+
+    def basis(self):
+        '''Returns (column statuses, row statuses) as arrays of ints'''
+        cstat, rstat = new_array(self.ncols, 'i'), new_array(self.nrows, 'i')
+        self.basis_into(cstat, rstat)
+        return cstat, rstat
+
+    def set_basis(self, cstat, rstat):
+        '''Starts the next solve from a basis like basis() returns'''
+        super(lp, self).set_basis(as_buffer(cstat, 'i'), as_buffer(rstat, 'i'))
@@ -8,6 +8,9 @@ for use by the modeler:
     - scip.solver:    interface to SCIP
     - scip.solution:  IP solutions returned by solver.minimize/maximize
 
+Many small, independent models can be solved in parallel with
+scip.solve_batch, which returns scip.batch_solution instances.
+
 There are type constants defined for declaring variables:
 
     - BINARY:      variable can be either 0 or 1
@@ -61,7 +64,9 @@ Translated to python-zibopt this becomes::
 '''
 
 # This provide more convenient namespacing
+from ._batch import *
 from ._constraint import *
+from ._expr import *
 from ._settings import *
 from ._solution import *
 from ._solver import *